@@ -3,12 +3,16 @@
 #include <memory>
 #include <vector>
 #include <algorithm>
+#include "PathRender/accel/simd.hpp"
 #include "PathRender/core/vector.hpp"
 #include "PathRender/core/point.hpp"
 #include "PathRender/core/ray.hpp"
 #include "PathRender/core/color.hpp"
 #include "PathRender/rendering/PathTracer.hpp"
+#include "PathRender/rendering/BidirectionalPathTracer.hpp"
+#include "PathRender/rendering/PhotonMapper.hpp"
 #include "PathRender/rendering/RayCast.hpp"
+#include "PathRender/rendering/WavefrontPathTracer.hpp"
 #include "PathRender/scene/camera.hpp"
 #include "PathRender/scene/obj_parser.hpp"
 #include "PathRender/scene/scene.hpp"
@@ -20,7 +24,33 @@
 using namespace PathRender;
 using namespace Utils;
 
-std::vector<Color> render_scene(SceneConfig config, bool direct_lighting_enabled = true) {
+/**
+ * @brief Opções de amostragem lidas da linha de comando
+ */
+struct SamplingOptions {
+    int max_samples = 100;
+    int min_samples = 8;
+    float adaptive_threshold = 0.05f;
+    int pass_samples = 8;
+    int max_depth = 32;
+    std::string checkpoint_file;
+    double checkpoint_interval = 60.0;
+    bool resume = false;
+    uint32_t seed = 0;
+    SamplerType sampler = SamplerType::Sobol;
+    LightSelection light_selection = LightSelection::BVH;
+    bool wavefront = false;  // WavefrontPathTracer (amostragem uniforme, sem checkpoint)
+    bool denoise = false;    // Filtro à-trous guiado por albedo/normal/profundidade (só no PathTracer)
+    bool exr = false;        // Grava também os canais do FrameBuffer em um OpenEXR (só no PathTracer)
+    bool radiance_cache = false;  // Encerra caminhos difusos no RadianceCache (só no PathTracer)
+    int radiance_cache_depth = 0;  // 0 = preview: a indireta do primeiro hit vem do cache
+    bool photon_mapping = false;  // PhotonMapper (SPPM): --spp passes de câmera e fótons
+    int photons = 200000;         // Fótons emitidos por passe do PhotonMapper
+    bool bidirectional = false;   // BidirectionalPathTracer (amostragem uniforme, luzes pela potência)
+};
+
+std::vector<Color> render_scene(SceneConfig config, bool direct_lighting_enabled, const SamplingOptions& sampling,
+                                std::vector<int>& sample_counts, FrameBuffer& frame) {
     const Scene& scene = config.scene;
     const Camera& camera = config.camera;
     const int width = config.output_params.width;
@@ -31,9 +61,68 @@ std::vector<Color> render_scene(SceneConfig config, bool direct_lighting_enabled
     // Buffer de pixels
     std::vector<Color> pixels(width * height);
 
+    if (sampling.wavefront) {
+        WavefrontPathTracer renderer;
+        renderer.set_direct_lighting_enabled(direct_lighting_enabled);
+        renderer.set_samples_per_pixel(sampling.max_samples);
+        renderer.set_max_depth(sampling.max_depth);
+        renderer.set_seed(sampling.seed);
+        renderer.set_sampler_type(sampling.sampler);
+        renderer.set_light_selection(sampling.light_selection);
+        renderer.render(pixels, config);
+        sample_counts.assign(pixels.size(), sampling.max_samples);
+        std::cout << "Progresso: 100%" << std::endl;
+        return pixels;
+    }
+
+    if (sampling.photon_mapping) {
+        PhotonMapper renderer;
+        renderer.set_direct_lighting_enabled(direct_lighting_enabled);
+        renderer.set_passes(sampling.max_samples);
+        renderer.set_photons_per_pass(sampling.photons);
+        renderer.set_max_depth(sampling.max_depth);
+        renderer.set_seed(sampling.seed);
+        renderer.set_sampler_type(sampling.sampler);
+        renderer.set_light_selection(sampling.light_selection);
+        renderer.render(pixels, config);
+        sample_counts.assign(pixels.size(), sampling.max_samples);
+        std::cout << "Progresso: 100%" << std::endl;
+        return pixels;
+    }
+
+    if (sampling.bidirectional) {
+        BidirectionalPathTracer renderer;
+        renderer.set_samples_per_pixel(sampling.max_samples);
+        renderer.set_max_depth(sampling.max_depth);
+        renderer.set_seed(sampling.seed);
+        renderer.set_sampler_type(sampling.sampler);
+        renderer.render(pixels, config);
+        sample_counts.assign(pixels.size(), sampling.max_samples);
+        std::cout << "Progresso: 100%" << std::endl;
+        return pixels;
+    }
+
     PathTracer renderer;
     renderer.set_direct_lighting_enabled(direct_lighting_enabled);
+    renderer.set_max_samples(sampling.max_samples);
+    renderer.set_min_samples(sampling.min_samples);
+    renderer.set_adaptive_threshold(sampling.adaptive_threshold);
+    renderer.set_pass_samples(sampling.pass_samples);
+    renderer.set_max_depth(sampling.max_depth);
+    renderer.set_seed(sampling.seed);
+    renderer.set_sampler_type(sampling.sampler);
+    renderer.set_light_selection(sampling.light_selection);
+    renderer.set_checkpoint_file(sampling.checkpoint_file);
+    renderer.set_checkpoint_interval(sampling.checkpoint_interval);
+    renderer.set_resume(sampling.resume);
+    renderer.set_denoise_enabled(sampling.denoise);
+    renderer.set_radiance_cache_enabled(sampling.radiance_cache);
+    renderer.set_radiance_cache_depth(sampling.radiance_cache_depth);
     renderer.render(pixels, config); 
+    sample_counts = renderer.sample_counts();
+    if (sampling.exr) {
+        frame = renderer.frame();
+    }
     std::cout << "Progresso: 100%" << std::endl;
     return pixels;
 }
@@ -48,7 +137,12 @@ std::string get_scene_filename_from_args(int argc, char** argv) {
         }
     }
 
-    throw std::runtime_error("Usage: ./PathRender --scene nome.yml [--no-direct-lighting]");
+    throw std::runtime_error("Usage: ./PathRender --scene nome.yml [--no-direct-lighting] [--spp N] [--min-spp N] "
+                             "[--adaptive-threshold X (0 = uniforme)] [--pass-spp N] [--max-depth N] [--seed N] "
+                             "[--sampler independent|stratified|halton|sobol] [--light-selection power|bvh] "
+                             "[--checkpoint arquivo.prck [--checkpoint-interval segundos] [--resume]] "
+                             "[--denoise] [--exr] [--radiance-cache [--radiance-cache-depth N]] "
+                             "[--wavefront] [--photon-mapping [--photons N]] [--bdpt]");
 }
 
 bool get_direct_lighting_flag_from_args(int argc, char** argv) {
@@ -61,6 +155,98 @@ bool get_direct_lighting_flag_from_args(int argc, char** argv) {
     return true;  // Direct lighting enabled by default
 }
 
+// Valor numérico de "--flag valor", ou default_value se a flag não foi passada
+double get_number_from_args(int argc, char** argv, const std::string& flag, double default_value) {
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i] == flag && i + 1 < argc) {
+            return std::stod(argv[i + 1]);
+        }
+    }
+    return default_value;
+}
+
+SamplingOptions get_sampling_options_from_args(int argc, char** argv) {
+    SamplingOptions options;
+    options.max_samples = static_cast<int>(get_number_from_args(argc, argv, "--spp", options.max_samples));
+    options.min_samples = static_cast<int>(get_number_from_args(argc, argv, "--min-spp", options.min_samples));
+    options.adaptive_threshold = static_cast<float>(
+        get_number_from_args(argc, argv, "--adaptive-threshold", options.adaptive_threshold));
+    options.pass_samples = static_cast<int>(get_number_from_args(argc, argv, "--pass-spp", options.pass_samples));
+    options.max_depth = static_cast<int>(get_number_from_args(argc, argv, "--max-depth", options.max_depth));
+    options.seed = static_cast<uint32_t>(get_number_from_args(argc, argv, "--seed", options.seed));
+    options.checkpoint_interval = get_number_from_args(argc, argv, "--checkpoint-interval", options.checkpoint_interval);
+    options.radiance_cache_depth =
+        static_cast<int>(get_number_from_args(argc, argv, "--radiance-cache-depth", options.radiance_cache_depth));
+    options.photons = static_cast<int>(get_number_from_args(argc, argv, "--photons", options.photons));
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--checkpoint" && i + 1 < argc) {
+            options.checkpoint_file = argv[i + 1];
+        } else if (arg == "--resume") {
+            options.resume = true;
+        } else if (arg == "--wavefront") {
+            options.wavefront = true;
+        } else if (arg == "--denoise") {
+            options.denoise = true;
+        } else if (arg == "--exr") {
+            options.exr = true;
+        } else if (arg == "--radiance-cache") {
+            options.radiance_cache = true;
+        } else if (arg == "--photon-mapping") {
+            options.photon_mapping = true;
+        } else if (arg == "--bdpt") {
+            options.bidirectional = true;
+        } else if (arg == "--sampler" && i + 1 < argc) {
+            if (!parse_sampler_type(argv[i + 1], options.sampler)) {
+                throw std::runtime_error(std::string("Sampler desconhecido: ") + argv[i + 1] +
+                                         " (use independent, stratified, halton ou sobol)");
+            }
+        } else if (arg == "--light-selection" && i + 1 < argc) {
+            if (!parse_light_selection(argv[i + 1], options.light_selection)) {
+                throw std::runtime_error(std::string("Seleção de luz desconhecida: ") + argv[i + 1] +
+                                         " (use power ou bvh)");
+            }
+        }
+    }
+    if (options.max_samples < 1 || options.min_samples < 1 || options.pass_samples < 1 || options.max_depth < 1 ||
+        options.adaptive_threshold < 0.0f) {
+        throw std::runtime_error("--spp, --min-spp, --pass-spp e --max-depth devem ser >= 1 e --adaptive-threshold >= 0");
+    }
+    if (options.resume && options.checkpoint_file.empty()) {
+        throw std::runtime_error("--resume requer --checkpoint arquivo.prck");
+    }
+    if ((options.denoise || options.exr || options.radiance_cache) && options.wavefront) {
+        throw std::runtime_error("--denoise, --exr e --radiance-cache não são suportados com --wavefront");
+    }
+    if (options.radiance_cache_depth < 0) {
+        throw std::runtime_error("--radiance-cache-depth deve ser >= 0");
+    }
+    if (options.photon_mapping && (options.wavefront || options.denoise || options.exr || options.radiance_cache ||
+                                   !options.checkpoint_file.empty())) {
+        throw std::runtime_error("--photon-mapping não é suportado com --wavefront, --denoise, --exr, "
+                                 "--radiance-cache ou --checkpoint");
+    }
+    if (options.photons < 1) {
+        throw std::runtime_error("--photons deve ser >= 1");
+    }
+    if (options.bidirectional && (options.wavefront || options.photon_mapping || options.denoise || options.exr ||
+                                  options.radiance_cache || !options.checkpoint_file.empty())) {
+        throw std::runtime_error("--bdpt não é suportado com --wavefront, --photon-mapping, --denoise, --exr, "
+                                 "--radiance-cache ou --checkpoint");
+    }
+    return options;
+}
+
+// Mapa em tons de cinza das amostras por pixel (branco = max_samples)
+std::vector<Color> make_sample_map(const std::vector<int>& sample_counts, int max_samples) {
+    std::vector<Color> map(sample_counts.size());
+    for (size_t i = 0; i < sample_counts.size(); ++i) {
+        double level = static_cast<double>(sample_counts[i]) / max_samples;
+        map[i] = Color(level, level, level);
+    }
+    return map;
+}
+
 std::filesystem::path extract_scene_path(int argc, char** argv) {
     std::string scene_filename = get_scene_filename_from_args(argc, argv);
     
@@ -85,12 +271,27 @@ std::filesystem::path extract_scene_path(int argc, char** argv) {
 
 int main(int argc, char** argv) {
     std::cout << "=== PathRender - Ray Caster Demo ===" << std::endl;
+    std::cout << "Kernels SIMD: " << simd_level_name(simd_level()) << std::endl;
 
     try {
         auto scene_path = extract_scene_path(argc, argv);
         bool direct_lighting_enabled = get_direct_lighting_flag_from_args(argc, argv);
+        SamplingOptions sampling = get_sampling_options_from_args(argc, argv);
         
         std::cout << "Direct lighting: " << (direct_lighting_enabled ? "ENABLED" : "DISABLED") << std::endl;
+        std::cout << "Amostragem: até " << sampling.max_samples << " spp";
+        if (sampling.photon_mapping) {
+            std::cout << " (passes de photon mapping, " << sampling.photons << " fótons por passe)";
+        } else if (sampling.bidirectional) {
+            std::cout << " (path tracing bidirecional)";
+        } else if (sampling.adaptive_threshold > 0.0f) {
+            std::cout << ", adaptativa (base " << sampling.min_samples << " spp, erro <= "
+                      << sampling.adaptive_threshold << ")";
+        }
+        std::cout << ", sampler " << sampler_type_name(sampling.sampler) << ", luzes por "
+                  << light_selection_name(sampling.bidirectional ? LightSelection::Power : sampling.light_selection)
+                  << (sampling.denoise ? ", com denoiser" : "")
+                  << (sampling.radiance_cache ? ", com radiance cache" : "") << std::endl;
         
         // Solução provisória para selecionar parser de acordo com cena ser .yaml ou .obj
         std::string extension = scene_path.extension().string();
@@ -112,7 +313,9 @@ int main(int argc, char** argv) {
         }();
         
         // Renderizar cena com path tracer (com ou sem direct lighting)
-        std::vector<Color> pixels = render_scene(config, direct_lighting_enabled);
+        std::vector<int> sample_counts;
+        FrameBuffer frame;
+        std::vector<Color> pixels = render_scene(config, direct_lighting_enabled, sampling, sample_counts, frame);
         
         // Garantir que o diretório output existe e gerar nome único
         std::string output_dir = ensure_output_directory();
@@ -121,6 +324,11 @@ int main(int argc, char** argv) {
         
         // Salvar imagem
         save_ppm(filename, config.output_params.width, config.output_params.height, pixels);
+        save_ppm(output_dir + "/samples_" + timestamp + ".ppm", config.output_params.width,
+                 config.output_params.height, make_sample_map(sample_counts, sampling.max_samples));
+        if (sampling.exr) {
+            frame.save_exr(output_dir + "/render_" + timestamp + ".exr");
+        }
         
         std::cout << "=== Renderização completa! ===" << std::endl;
         
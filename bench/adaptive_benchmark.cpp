@@ -0,0 +1,101 @@
+// Benchmark: amostragem adaptativa contra amostragem uniforme com erro igual, em uma
+// cena com fundo e regiões planas (adaptive_sampling.yaml), para vários pares
+// (--min-spp, --adaptive-threshold)
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_common.hpp"
+#include "PathRender/accel/simd.hpp"
+#include "PathRender/rendering/PathTracer.hpp"
+#include "PathRender/scene/yaml_parser.hpp"
+
+using namespace PathRender;
+
+namespace {
+
+struct AdaptiveRun {
+    std::vector<Color> image;
+    double average_spp = 0.0;
+    double seconds = 0.0;
+};
+
+AdaptiveRun render_adaptive(const SceneConfig& config, int min_spp, float threshold, int max_spp) {
+    PathTracer path_tracer;
+    path_tracer.set_min_samples(min_spp);
+    path_tracer.set_adaptive_threshold(threshold);
+    path_tracer.set_max_samples(max_spp);
+
+    AdaptiveRun run;
+    run.image = Bench::render(path_tracer, config, run.seconds);
+    double samples = 0.0;
+    for (int count : path_tracer.sample_counts()) {
+        samples += count;
+    }
+    run.average_spp = samples / run.image.size();
+    return run;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Optional arguments: image side, maximum spp, reference spp, scene file
+    const int resolution = argc > 1 ? std::atoi(argv[1]) : 128;
+    const int max_spp = argc > 2 ? std::atoi(argv[2]) : 512;
+    const int reference_spp = argc > 3 ? std::atoi(argv[3]) : 2048;
+    const std::string scene_file = argc > 4 ? argv[4] : PATHRENDER_SCENES_DIR "/adaptive_sampling.yaml";
+
+    std::cout << "\n=== PathRender - Adaptive Sampling Benchmark (erro igual) ===" << std::endl;
+    std::cout << "Kernels SIMD: " << simd_level_name(simd_level()) << std::endl;
+    YAMLParser parser;
+    SceneConfig config = parser.parse(scene_file);
+    config.output_params.width = resolution;
+    config.output_params.height = resolution;
+
+    double seconds = 0.0;
+    const Bench::Reference reference(Bench::path_trace(config, reference_spp, 0x5EED, seconds),
+                                     Bench::path_trace(config, reference_spp, 0x5EED + 1, seconds));
+
+    // Uniform error curve, used to find the spp uniform sampling needs for each adaptive error
+    std::vector<int> uniform_spp;
+    std::vector<double> uniform_error;
+    std::cout << "\n" << scene_file << " (" << resolution << "x" << resolution << ", referência 2 x "
+              << reference_spp << " spp)" << std::endl;
+    std::cout << "Uniforme, RMSE relativo por spp:" << std::endl;
+    for (int spp = 4; spp <= max_spp; spp *= 2) {
+        const std::vector<Color> image = Bench::path_trace(config, spp, 0, seconds);
+        uniform_spp.push_back(spp);
+        uniform_error.push_back(std::sqrt(reference.error(image)) / reference.mean);
+        std::cout << std::setw(8) << spp << std::fixed << std::setprecision(4) << std::setw(10)
+                  << uniform_error.back() << std::setprecision(3) << std::setw(10) << seconds << " s"
+                  << std::defaultfloat << std::endl;
+    }
+
+    // Rays = camera paths (samples); the ratio is the uniform spp at the same error over
+    // the average spp the adaptive render used
+    std::cout << "\nAdaptativa (até " << max_spp << " spp):" << std::endl;
+    std::cout << std::setw(9) << "min-spp" << std::setw(11) << "limiar" << std::setw(12) << "spp médio"
+              << std::setw(12) << "RMSE rel." << std::setw(10) << "média" << std::setw(15) << "spp uniforme"
+              << std::setw(12) << "raios" << std::setw(11) << "tempo (s)" << std::endl;
+    for (int min_spp : {4, 8, 16}) {
+        for (float threshold : {0.1f, 0.05f, 0.025f, 0.0125f}) {
+            const AdaptiveRun run = render_adaptive(config, min_spp, threshold, max_spp);
+            const double error = std::sqrt(reference.error(run.image)) / reference.mean;
+            const double uniform = Bench::spp_for_error(uniform_spp, uniform_error, error);
+            std::cout << std::setw(9) << min_spp << std::setprecision(4) << std::setw(11) << threshold
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(12) << run.average_spp << std::setprecision(4) << std::setw(12) << error
+                      << std::setprecision(3) << std::setw(10) << Bench::mean_value(run.image) / reference.mean
+                      << std::setprecision(1);
+            if (uniform > 0.0) {
+                std::cout << std::setw(15) << uniform << std::setw(11) << uniform / run.average_spp << "x";
+            } else {
+                std::cout << std::setw(15) << ("> " + std::to_string(max_spp)) << std::setw(12) << "-";
+            }
+            std::cout << std::setprecision(3) << std::setw(11) << run.seconds << std::defaultfloat << std::endl;
+        }
+    }
+    return 0;
+}
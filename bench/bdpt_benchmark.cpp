@@ -0,0 +1,110 @@
+// Benchmark: BidirectionalPathTracer contra o PathTracer nas cenas de Cornell, com o
+// erro de cada um e a eficiência (1 / (erro quadrático x tempo)) relativa ao PathTracer,
+// na imagem inteira e como mediana sobre blocos de 16x16 pixels
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_common.hpp"
+#include "PathRender/accel/simd.hpp"
+#include "PathRender/rendering/BidirectionalPathTracer.hpp"
+#include "PathRender/rendering/PathTracer.hpp"
+#include "PathRender/scene/yaml_parser.hpp"
+
+using namespace PathRender;
+using namespace PathRender::Bench;
+
+namespace {
+
+constexpr int kBlockSize = 16;
+
+// Squared error of each kBlockSize x kBlockSize block, in row order
+std::vector<double> block_errors(const std::vector<Color>& image, const std::vector<Color>& reference, int width) {
+    const int height = static_cast<int>(image.size()) / width;
+    const int blocks_x = (width + kBlockSize - 1) / kBlockSize;
+    const int blocks_y = (height + kBlockSize - 1) / kBlockSize;
+    std::vector<double> errors(static_cast<size_t>(blocks_x) * blocks_y, 0.0);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const Color& a = image[static_cast<size_t>(y) * width + x];
+            const Color& b = reference[static_cast<size_t>(y) * width + x];
+            errors[static_cast<size_t>(y / kBlockSize) * blocks_x + x / kBlockSize] +=
+                (a.r - b.r) * (a.r - b.r) + (a.g - b.g) * (a.g - b.g) + (a.b - b.b) * (a.b - b.b);
+        }
+    }
+    return errors;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Optional arguments: image side, path tracing spp, bidirectional spp, reference spp
+    const int resolution = argc > 1 ? std::atoi(argv[1]) : 128;
+    const int path_spp = argc > 2 ? std::atoi(argv[2]) : 64;
+    const int bidirectional_spp = argc > 3 ? std::atoi(argv[3]) : 16;
+    const int reference_spp = argc > 4 ? std::atoi(argv[4]) : 1024;
+
+    std::cout << "\n=== PathRender - Bidirectional Path Tracing Benchmark ===" << std::endl;
+    std::cout << "Kernels SIMD: " << simd_level_name(simd_level()) << std::endl;
+    for (const char* name : {"cornell_box.yaml", "cornell_spheres.yaml"}) {
+        const std::string scene_file = std::string(PATHRENDER_SCENES_DIR "/") + name;
+        YAMLParser parser;
+        SceneConfig config = parser.parse(scene_file);
+        config.output_params.width = resolution;
+        config.output_params.height = resolution;
+
+        // Reference: two independent path-traced renders; their difference measures the noise left in it
+        double seconds = 0.0;
+        const Reference reference(path_trace(config, reference_spp, 0x5EED, seconds),
+                                  path_trace(config, reference_spp, 0x5EED + 1, seconds));
+
+        std::cout << "\n" << scene_file << " (" << resolution << "x" << resolution << ", referência path tracing 2 x "
+                  << reference_spp << " spp)" << std::endl;
+        std::cout << std::setw(26) << "" << std::setw(11) << "tempo (s)" << std::setw(12) << "RMSE rel." << std::setw(12)
+                  << "média" << std::setw(13) << "eficiência" << std::setw(16) << "mediana 16x16" << std::endl;
+
+        double path_efficiency = 0.0;
+        std::vector<double> path_block_cost;
+        for (bool bidirectional : {false, true}) {
+            std::vector<Color> image;
+            std::string label;
+            if (bidirectional) {
+                BidirectionalPathTracer bdpt;
+                bdpt.set_samples_per_pixel(bidirectional_spp);
+                image = render(bdpt, config, seconds);
+                label = "BDPT " + std::to_string(bidirectional_spp) + " spp";
+            } else {
+                image = path_trace(config, path_spp, 0, seconds);
+                label = "path tracing " + std::to_string(path_spp) + " spp";
+            }
+
+            const double mse = reference.error(image);
+            const double efficiency = 1.0 / (mse * seconds);
+            std::vector<double> block_cost = block_errors(image, reference.image, resolution);
+            for (double& cost : block_cost) {
+                cost *= seconds;
+            }
+            if (!bidirectional) {
+                path_efficiency = efficiency;
+                path_block_cost = block_cost;
+            }
+            // Blocks without error (black background) have no efficiency to compare
+            std::vector<double> block_ratios;
+            for (size_t b = 0; b < block_cost.size(); ++b) {
+                if (block_cost[b] > 0.0 && path_block_cost[b] > 0.0) {
+                    block_ratios.push_back(path_block_cost[b] / block_cost[b]);
+                }
+            }
+            std::nth_element(block_ratios.begin(), block_ratios.begin() + block_ratios.size() / 2, block_ratios.end());
+            std::cout << std::setw(26) << label << std::fixed << std::setprecision(3) << std::setw(11) << seconds
+                      << std::setprecision(4) << std::setw(12) << std::sqrt(mse) / reference.mean
+                      << std::setprecision(3) << std::setw(12) << mean_value(image) / reference.mean
+                      << std::setw(12) << efficiency / path_efficiency << "x" << std::setw(15)
+                      << block_ratios[block_ratios.size() / 2] << "x" << std::defaultfloat << std::endl;
+        }
+    }
+    return 0;
+}
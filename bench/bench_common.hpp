@@ -0,0 +1,126 @@
+// Funções compartilhadas pelos benchmarks de qualidade: render cronometrado sem o
+// relatório de progresso, referência de path tracing e métricas de erro
+#ifndef PATHRENDER_BENCH_COMMON_HPP_
+#define PATHRENDER_BENCH_COMMON_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "PathRender/rendering/IRenderAlgorithm.hpp"
+#include "PathRender/rendering/PathTracer.hpp"
+
+namespace PathRender {
+namespace Bench {
+
+/// Limita cada canal a [0, 1], como na imagem gravada: sem isso as bordas da luz visível dominam o erro
+inline void clamp_to_display(std::vector<Color>& image) {
+    for (Color& c : image) {
+        c = Color(std::min(c.r, 1.0), std::min(c.g, 1.0), std::min(c.b, 1.0));
+    }
+}
+
+/// Radiância linear a partir da saída com gamma 2, limitada como em clamp_to_display()
+inline void linearize(std::vector<Color>& image) {
+    for (Color& c : image) {
+        c = Color(c.r * c.r, c.g * c.g, c.b * c.b);
+    }
+    clamp_to_display(image);
+}
+
+/**
+ * @brief Renderiza @p config com @p renderer e devolve a radiância linear (linearize())
+ * @param seconds Tempo de render(), sem a conversão
+ */
+inline std::vector<Color> render(IRenderAlgorithm& renderer, const SceneConfig& config, double& seconds) {
+    std::vector<Color> image(static_cast<size_t>(config.output_params.width) * config.output_params.height);
+    // Keep the per-render progress report out of the table
+    std::streambuf* output = std::cout.rdbuf(nullptr);
+    const auto start = std::chrono::steady_clock::now();
+    renderer.render(image, config);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout.rdbuf(output);
+    linearize(image);
+    return image;
+}
+
+/// Path tracing com amostragem uniforme de @p spp amostras por pixel
+inline std::vector<Color> path_trace(const SceneConfig& config, int spp, uint32_t seed, double& seconds) {
+    PathTracer path_tracer;
+    path_tracer.set_seed(seed);
+    path_tracer.set_max_samples(spp);
+    path_tracer.set_pass_samples(spp);
+    path_tracer.set_adaptive_threshold(0.0f);
+    return render(path_tracer, config, seconds);
+}
+
+/// Média dos três canais sobre a imagem
+inline double mean_value(const std::vector<Color>& image) {
+    double sum = 0.0;
+    for (const Color& c : image) {
+        sum += c.r + c.g + c.b;
+    }
+    return sum / (3.0 * image.size());
+}
+
+/// Erro quadrático médio por canal entre duas imagens do mesmo tamanho
+inline double mean_squared_error(const std::vector<Color>& a, const std::vector<Color>& b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        sum += (a[i].r - b[i].r) * (a[i].r - b[i].r) + (a[i].g - b[i].g) * (a[i].g - b[i].g) +
+               (a[i].b - b[i].b) * (a[i].b - b[i].b);
+    }
+    return sum / (3.0 * a.size());
+}
+
+/**
+ * @brief spp em que a curva de erro cruza @p target, interpolado em escala log-log
+ * @param spp Contagens crescentes; @p error o erro medido em cada uma
+ * @return 0 se o erro nunca chega a @p target
+ */
+inline double spp_for_error(const std::vector<int>& spp, const std::vector<double>& error, double target) {
+    for (size_t i = 0; i < spp.size(); ++i) {
+        if (error[i] > target) {
+            continue;
+        }
+        if (i == 0) {
+            return spp[0];
+        }
+        const double t = std::log(error[i - 1] / target) / std::log(error[i - 1] / error[i]);
+        return std::exp(std::log(spp[i - 1]) + t * (std::log(spp[i]) - std::log(spp[i - 1])));
+    }
+    return 0.0;
+}
+
+/**
+ * @struct Reference
+ * @brief Média de dois renders independentes da mesma cena, usada como imagem de referência
+ *
+ * A diferença entre os dois mede o ruído que resta na referência (mse), que é
+ * descontado de cada erro medido contra ela (ruídos independentes somam em quadratura).
+ */
+struct Reference {
+    std::vector<Color> image;
+    double mse = 0.0;   ///< Erro quadrático médio estimado da própria referência
+    double mean = 0.0;  ///< mean_value(image)
+
+    Reference(const std::vector<Color>& first, const std::vector<Color>& second) : image(first.size()) {
+        for (size_t i = 0; i < image.size(); ++i) {
+            image[i] = (first[i] + second[i]) * 0.5;
+        }
+        mse = mean_squared_error(first, second) / 4.0;
+        mean = mean_value(image);
+    }
+
+    /// Erro quadrático médio de @p other, sem o ruído da referência (nunca zero)
+    double error(const std::vector<Color>& other) const {
+        return std::max(mean_squared_error(other, image) - mse, 1e-30);
+    }
+};
+
+} // namespace Bench
+} // namespace PathRender
+
+#endif // PATHRENDER_BENCH_COMMON_HPP_
@@ -0,0 +1,480 @@
+// Benchmark: raios/s em função do número de objetos, varredura linear vs. BVH
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+#include "PathRender/accel/simd.hpp"
+#include "PathRender/accel/wide_bvh.hpp"
+#include "PathRender/core/PhongBRDF.hpp"
+#include "PathRender/core/sampler.hpp"
+#include "PathRender/objects/mesh.hpp"
+#include "PathRender/objects/sphere.hpp"
+#include "PathRender/scene/scene.hpp"
+#include "PathRender/scene/yaml_parser.hpp"
+
+using namespace PathRender;
+
+// Global allocation counter, used to check that tracing paths never touches the heap
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+// Random spheres inside a [0, 100]^3 box, radius shrinking with the object count
+Scene make_sphere_scene(int count, std::mt19937& rng) {
+    std::uniform_real_distribution<float> pos(0.0f, 100.0f);
+    const float radius = 20.0f / std::cbrt(static_cast<float>(count));
+    Material material(false, std::make_shared<PhongBRDF>(Color(0.7, 0.7, 0.7)));
+
+    Scene scene;
+    for (int i = 0; i < count; ++i) {
+        scene.add_object(std::make_shared<Sphere>(Point3(pos(rng), pos(rng), pos(rng)), radius, material));
+    }
+    return scene;
+}
+
+// Latitude/longitude tessellation of a sphere (by default of radius 40 centered in the box)
+std::shared_ptr<Mesh> make_sphere_mesh(int stacks, int slices,
+                                       const Point3& center = Point3(50.0f, 50.0f, 50.0f), float radius = 40.0f) {
+    Material material(false, std::make_shared<PhongBRDF>(Color(0.7, 0.7, 0.7)));
+    auto mesh = std::make_shared<Mesh>();
+    mesh->set_material(material);
+
+    for (int i = 0; i <= stacks; ++i) {
+        for (int j = 0; j <= slices; ++j) {
+            float theta = static_cast<float>(M_PI) * i / stacks;
+            float phi = 2.0f * static_cast<float>(M_PI) * j / slices;
+            mesh->add_vertex(Point3(center.x + radius * std::sin(theta) * std::cos(phi),
+                                    center.y + radius * std::cos(theta),
+                                    center.z + radius * std::sin(theta) * std::sin(phi)));
+        }
+    }
+
+    auto vertex = [&](int i, int j) { return static_cast<uint32_t>(i * (slices + 1) + j); };
+    for (int i = 0; i < stacks; ++i) {
+        for (int j = 0; j < slices; ++j) {
+            mesh->add_triangle(vertex(i, j), vertex(i + 1, j), vertex(i + 1, j + 1));
+            mesh->add_triangle(vertex(i, j), vertex(i + 1, j + 1), vertex(i, j + 1));
+        }
+    }
+    return mesh;
+}
+
+// Rays from random points inside the box towards random points inside the box
+std::vector<Ray> make_rays(int count, std::mt19937& rng) {
+    std::uniform_real_distribution<float> pos(0.0f, 100.0f);
+    std::vector<Ray> rays;
+    rays.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        Point3 origin(pos(rng), pos(rng), pos(rng));
+        Point3 target(pos(rng), pos(rng), pos(rng));
+        rays.emplace_back(origin, (target - origin).normalized());
+    }
+    return rays;
+}
+
+double rays_per_second(const Scene& scene, const std::vector<Ray>& rays, int& hits) {
+    hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const Ray& ray : rays) {
+        HitRecord hit;
+        if (scene.intersect(ray, 0.001f, 1e10f, hit)) {
+            hits++;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return rays.size() / seconds;
+}
+
+void print_row(int count, double linear, double bvh) {
+    std::cout << std::setw(10) << count
+              << std::setw(16) << std::fixed << std::setprecision(0) << linear
+              << std::setw(16) << bvh
+              << std::setw(9) << std::setprecision(1) << bvh / linear << "x";
+}
+
+bool benchmark_objects() {
+    const int object_counts[] = {16, 64, 256, 1024, 4096, 16384};
+    std::mt19937 rng(1234);
+
+    std::cout << std::setw(10) << "objects" << std::setw(16) << "linear rays/s"
+              << std::setw(16) << "bvh rays/s" << std::setw(10) << "speedup" << std::endl;
+
+    for (int count : object_counts) {
+        Scene scene = make_sphere_scene(count, rng);
+
+        // Keep the linear scan to roughly the same amount of work per row
+        const int ray_count = std::max(2000, 20000000 / count);
+        std::vector<Ray> rays = make_rays(ray_count, rng);
+
+        int linear_hits = 0, bvh_hits = 0;
+        double linear = rays_per_second(scene, rays, linear_hits);
+        scene.finalize();
+        double bvh = rays_per_second(scene, rays, bvh_hits);
+
+        if (linear_hits != bvh_hits) {
+            std::cerr << "Mismatch: linear=" << linear_hits << " bvh=" << bvh_hits << std::endl;
+            return false;
+        }
+        print_row(count, linear, bvh);
+        std::cout << std::endl;
+    }
+    return true;
+}
+
+bool benchmark_mesh() {
+    const int stack_counts[] = {16, 64, 256, 512};
+    std::mt19937 rng(4321);
+
+    std::cout << std::setw(10) << "triangles" << std::setw(16) << "linear rays/s"
+              << std::setw(16) << "bvh rays/s" << std::setw(10) << "speedup"
+              << std::setw(16) << "bytes/triangle" << std::endl;
+
+    for (int stacks : stack_counts) {
+        auto mesh = make_sphere_mesh(stacks, 2 * stacks);
+        const int triangle_count = static_cast<int>(mesh->triangle_count());
+
+        Scene scene;
+        scene.add_object(mesh);
+
+        const int ray_count = std::max(200, 50000000 / triangle_count);
+        std::vector<Ray> rays = make_rays(ray_count, rng);
+
+        int linear_hits = 0, bvh_hits = 0;
+        double linear = rays_per_second(scene, rays, linear_hits);
+        scene.finalize();
+        double bvh = rays_per_second(scene, rays, bvh_hits);
+
+        if (linear_hits != bvh_hits) {
+            std::cerr << "Mismatch: linear=" << linear_hits << " bvh=" << bvh_hits << std::endl;
+            return false;
+        }
+        print_row(triangle_count, linear, bvh);
+        // Geometry + precomputed intersection data + BVH, after the build
+        std::cout << std::setw(16) << static_cast<double>(mesh->memory_usage()) / triangle_count << std::endl;
+    }
+    return true;
+}
+
+// Mesh BVH leaves tested by each available SIMD kernel; the BVH is rebuilt per
+// level because leaf sizes follow the kernel width
+bool benchmark_simd() {
+    const SimdLevel detected = simd_level();
+    std::mt19937 rng(99);
+    std::vector<Ray> rays = make_rays(200000, rng);
+
+    std::cout << std::setw(10) << "kernel" << std::setw(16) << "bvh rays/s" << std::setw(10) << "speedup" << std::endl;
+
+    double scalar_rate = 0.0;
+    int scalar_hits = -1;
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+        if (level > detected) {
+            break;
+        }
+        set_simd_level(level);
+
+        Scene scene;
+        scene.add_object(make_sphere_mesh(256, 512));
+        scene.finalize();
+
+        int hits = 0;
+        double rate = rays_per_second(scene, rays, hits);
+        if (scalar_hits < 0) {
+            scalar_hits = hits;
+            scalar_rate = rate;
+        } else if (hits != scalar_hits) {
+            std::cerr << "Mismatch: scalar=" << scalar_hits << " " << simd_level_name(level) << "=" << hits << std::endl;
+            return false;
+        }
+        std::cout << std::setw(10) << simd_level_name(level)
+                  << std::setw(16) << std::fixed << std::setprecision(0) << rate
+                  << std::setw(9) << std::setprecision(1) << rate / scalar_rate << "x" << std::endl;
+    }
+    set_simd_level(detected);
+    return true;
+}
+
+// 1024 tessellated spheres (1024 triangles each) on a jittered 16x4x16 grid
+Scene make_procedural_scene(std::mt19937& rng) {
+    std::uniform_real_distribution<float> jitter(-1.0f, 1.0f);
+    Scene scene;
+    for (int x = 0; x < 16; ++x) {
+        for (int y = 0; y < 4; ++y) {
+            for (int z = 0; z < 16; ++z) {
+                Point3 center(3.125f + 6.25f * x + jitter(rng), 12.5f + 25.0f * y + jitter(rng), 3.125f + 6.25f * z + jitter(rng));
+                scene.add_object(make_sphere_mesh(16, 32, center, 1.5f + jitter(rng)));
+            }
+        }
+    }
+    return scene;
+}
+
+// Camera rays plus one random bounce from each primary hit
+std::vector<Ray> make_camera_rays(const SceneConfig& config, int count, std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    std::vector<Ray> rays;
+    rays.reserve(2 * count);
+    for (int i = 0; i < count; ++i) {
+        Ray ray = config.camera.get_ray(dist(rng), dist(rng));
+        rays.push_back(ray);
+        HitRecord hit;
+        if (config.scene.intersect(ray, 0.001f, 1e10f, hit)) {
+            Vector3 direction(normal(rng), normal(rng), normal(rng));
+            if (direction.dot(hit.normal) < 0.0f) {
+                direction = direction * -1.0f;
+            }
+            rays.emplace_back(hit.point, direction.normalized());
+        }
+    }
+    return rays;
+}
+
+// All mesh triangles of a scene merged into one triangle soup, stored in the leaf
+// order of a binary SAH BVH so every width shares the same leaves
+struct TriangleSoup {
+    std::vector<Point3> corners;  // Three unshared vertices per triangle
+    TriangleSoA triangles;
+    BVH binary;
+};
+
+TriangleSoup make_triangle_soup(const Scene& scene) {
+    TriangleSoup soup;
+    std::vector<AABB> bounds;
+    for (const auto& object : scene.get_objects()) {
+        const Mesh* mesh = dynamic_cast<const Mesh*>(object.get());
+        if (!mesh) {
+            continue;
+        }
+        const auto& vertices = mesh->get_vertices();
+        const auto& indices = mesh->get_indices();
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            AABB box(vertices[indices[i]], vertices[indices[i + 1]]);
+            box.expand(vertices[indices[i + 2]]);
+            bounds.push_back(box);
+            soup.corners.insert(soup.corners.end(),
+                                {vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]]});
+        }
+    }
+
+    soup.binary.build(bounds, simd_width());
+    soup.triangles.reserve(bounds.size() + kMaxSimdWidth - 1);
+    for (uint32_t tri : soup.binary.primitive_indices()) {
+        soup.triangles.push_back(soup.corners.data(), 3 * tri, 3 * tri + 1, 3 * tri + 2);
+    }
+    soup.triangles.pad(kMaxSimdWidth);
+    return soup;
+}
+
+template <typename Hierarchy>
+double soup_rays_per_second(const Hierarchy& bvh, const TriangleSoup& soup, const std::vector<Ray>& rays, int& hits) {
+    hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const Ray& ray : rays) {
+        float t_max = 1e10f, u, v;
+        uint32_t primitive;
+        bool hit = bvh.traverse(ray, 0.001f, t_max, [&](uint32_t first, uint32_t count, float& t_closest) {
+            return Simd::intersect_triangles(soup.triangles, soup.corners.data(), first, count, ray, 0.001f, t_closest,
+                                             primitive, u, v);
+        });
+        hits += hit ? 1 : 0;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return rays.size() / seconds;
+}
+
+// BVH2, BVH4 and BVH8 collapsed from the same binary tree over the scene's triangles,
+// followed by Scene::intersect with the width the library was built with
+bool benchmark_widths(const char* name, const Scene& scene, const std::vector<Ray>& rays) {
+    TriangleSoup soup = make_triangle_soup(scene);
+    WideBVH<4> bvh4;
+    WideBVH<8> bvh8;
+    bvh4.build(soup.binary);
+    bvh8.build(soup.binary);
+
+    std::cout << name << ": " << soup.triangles.size() << " triangles, " << rays.size() << " rays" << std::endl;
+    std::cout << std::setw(10) << "width" << std::setw(10) << "nodes" << std::setw(14) << "node bytes"
+              << std::setw(16) << "rays/s" << std::setw(10) << "speedup" << std::endl;
+
+    int hits2 = 0, hits4 = 0, hits8 = 0;
+    double rate2 = soup_rays_per_second(soup.binary, soup, rays, hits2);
+    double rate4 = soup_rays_per_second(bvh4, soup, rays, hits4);
+    double rate8 = soup_rays_per_second(bvh8, soup, rays, hits8);
+    if (hits2 != hits4 || hits2 != hits8) {
+        std::cerr << "Mismatch: bvh2=" << hits2 << " bvh4=" << hits4 << " bvh8=" << hits8 << std::endl;
+        return false;
+    }
+
+    auto row = [&](const char* width, size_t nodes, size_t bytes, double rate) {
+        std::cout << std::setw(10) << width << std::setw(10) << nodes << std::setw(14) << bytes
+                  << std::setw(16) << std::fixed << std::setprecision(0) << rate
+                  << std::setw(9) << std::setprecision(2) << rate / rate2 << "x" << std::endl;
+    };
+    row("BVH2", soup.binary.node_count(), soup.binary.node_count() * sizeof(BVHNode), rate2);
+    row("BVH4", bvh4.node_count(), bvh4.node_count() * sizeof(WideBVHNode<4>), rate4);
+    row("BVH8", bvh8.node_count(), bvh8.node_count() * sizeof(WideBVHNode<8>), rate8);
+
+    int scene_hits = 0;
+    double scene_rate = rays_per_second(scene, rays, scene_hits);
+    std::cout << "Scene::intersect (PATHRENDER_BVH_WIDTH=" << PATHRENDER_BVH_WIDTH << "): "
+              << std::setprecision(0) << scene_rate << " rays/s" << std::endl;
+    return true;
+}
+
+// Shadow rays between random point pairs: closest hit + material lookup vs. Scene::occluded
+bool benchmark_shadow_rays(const Scene& scene, std::mt19937& rng) {
+    std::uniform_real_distribution<float> pos(0.0f, 100.0f);
+    std::vector<Ray> rays;
+    std::vector<float> distances;
+    for (int i = 0; i < 500000; ++i) {
+        Point3 origin(pos(rng), pos(rng), pos(rng));
+        Point3 target(pos(rng), pos(rng), pos(rng));
+        rays.emplace_back(origin, (target - origin).normalized());
+        distances.push_back((target - origin).length());
+    }
+
+    auto measure = [&](auto&& blocked, int& count) {
+        count = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < rays.size(); ++i) {
+            count += blocked(rays[i], distances[i]) ? 1 : 0;
+        }
+        return rays.size() / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    int closest_count = 0, occluded_count = 0;
+    double closest = measure([&](const Ray& ray, float distance) {
+        HitRecord hit;
+        return scene.intersect(ray, 0.001f, distance, hit) &&
+               !hit.object->get_primitive_material(hit.primitive_index).is_light;
+    }, closest_count);
+    double occluded = measure([&](const Ray& ray, float distance) {
+        return scene.occluded(ray, 0.001f, distance);
+    }, occluded_count);
+
+    if (closest_count != occluded_count) {
+        std::cerr << "Mismatch: intersect=" << closest_count << " occluded=" << occluded_count << std::endl;
+        return false;
+    }
+    std::cout << "blocked: " << occluded_count << "/" << rays.size()
+              << ", intersect rays/s: " << std::fixed << std::setprecision(0) << closest
+              << ", occluded rays/s: " << occluded
+              << " (" << std::setprecision(2) << occluded / closest << "x)" << std::endl;
+    return true;
+}
+
+// Traces camera paths through the Cornell box (closest hit + BRDF scatter per bounce)
+// and counts heap allocations made while doing so
+void benchmark_path_allocations() {
+    YAMLParser parser;
+    SceneConfig config = parser.parse(PATHRENDER_SCENES_DIR "/cornell_box.yaml");
+    const Scene& scene = config.scene;
+
+    const int path_count = 200000;
+    const int max_depth = 5;
+    IndependentSampler sampler(7);
+
+    size_t bounces = 0;
+    size_t allocations_before = g_allocations.load();
+    auto start = std::chrono::steady_clock::now();
+
+    for (int p = 0; p < path_count; ++p) {
+        sampler.start_pixel_sample(static_cast<uint32_t>(p), 0);
+        const float u = sampler.get_1d();
+        Ray ray = config.camera.get_ray(u, sampler.get_1d());
+        for (int depth = 0; depth < max_depth; ++depth) {
+            sampler.start_bounce(depth);
+            HitRecord hit;
+            if (!scene.intersect(ray, 0.001f, 1e10f, hit)) {
+                break;
+            }
+            bounces++;
+            const Material& material = hit.object->get_primitive_material(hit.primitive_index);
+            ScatterRecord srec;
+            if (material.is_light || !material.brdf->scatter(ray, hit, srec, sampler)) {
+                break;
+            }
+            ray = srec.out_ray;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t allocations = g_allocations.load() - allocations_before;
+
+    std::cout << "paths: " << path_count << ", bounces: " << bounces
+              << ", paths/s: " << std::fixed << std::setprecision(0) << path_count / seconds
+              << ", heap allocations/path: " << std::setprecision(3)
+              << static_cast<double>(allocations) / path_count << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== PathRender - BVH Benchmark ===" << std::endl;
+    std::cout << "Kernels SIMD: " << simd_level_name(simd_level()) << std::endl;
+
+    std::cout << "\n--- Scene BVH (random spheres) ---" << std::endl;
+    if (!benchmark_objects()) {
+        return 1;
+    }
+
+    std::cout << "\n--- Mesh BVH (tessellated sphere) ---" << std::endl;
+    if (!benchmark_mesh()) {
+        return 1;
+    }
+
+    std::cout << "\n--- SIMD triangle kernels (262144 triangles) ---" << std::endl;
+    if (!benchmark_simd()) {
+        return 1;
+    }
+
+    std::cout << "\n--- BVH width (cornell_box.yaml) ---" << std::endl;
+    {
+        YAMLParser parser;
+        SceneConfig config = parser.parse(PATHRENDER_SCENES_DIR "/cornell_box.yaml");
+        std::mt19937 rng(11);
+        if (!benchmark_widths("cornell_box.yaml", config.scene, make_camera_rays(config, 500000, rng))) {
+            return 1;
+        }
+    }
+
+    std::cout << "\n--- BVH width (procedural scene) ---" << std::endl;
+    {
+        std::mt19937 rng(12);
+        Scene scene = make_procedural_scene(rng);
+        scene.finalize();
+        if (!benchmark_widths("1024 tessellated spheres", scene, make_rays(500000, rng))) {
+            return 1;
+        }
+
+        std::cout << "\n--- Shadow rays (procedural scene) ---" << std::endl;
+        if (!benchmark_shadow_rays(scene, rng)) {
+            return 1;
+        }
+    }
+
+    std::cout << "\n--- Heap allocations per traced path (cornell_box.yaml) ---" << std::endl;
+    benchmark_path_allocations();
+
+    return 0;
+}
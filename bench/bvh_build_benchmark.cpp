@@ -0,0 +1,108 @@
+// Benchmark: tempo de construção da BVH (binned SAH) de 10k a 10M triângulos,
+// com uma thread de trabalho e com todas as threads do pool
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include "PathRender/accel/bvh.hpp"
+#include "PathRender/accel/simd.hpp"
+#include "PathRender/utils/thread_pool.hpp"
+
+using namespace PathRender;
+
+namespace {
+
+// Bounds of small random triangles clustered on the surfaces of 64 spheres,
+// closer to scanned/modelled geometry than a uniform cloud
+std::vector<AABB> make_triangle_bounds(size_t count, std::mt19937& rng) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+
+    std::vector<Point3> centers;
+    std::vector<float> radii;
+    for (int i = 0; i < 64; ++i) {
+        centers.emplace_back(100.0f * unit(rng), 100.0f * unit(rng), 100.0f * unit(rng));
+        radii.push_back(2.0f + 10.0f * unit(rng));
+    }
+
+    const float edge = 40.0f / std::sqrt(static_cast<float>(count));
+    std::vector<AABB> bounds;
+    bounds.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const int sphere = static_cast<int>(unit(rng) * 63.999f);
+        Vector3 direction(normal(rng), normal(rng), normal(rng));
+        Point3 a = centers[sphere] + direction.normalized() * radii[sphere];
+        AABB box(a, a + Vector3(edge * unit(rng), edge * unit(rng), edge * unit(rng)));
+        box.expand(a + Vector3(edge * unit(rng), -edge * unit(rng), edge * unit(rng)));
+        bounds.push_back(box);
+    }
+    return bounds;
+}
+
+double build_ms(BVH& bvh, const std::vector<AABB>& bounds, uint32_t leaf_batch) {
+    auto start = std::chrono::steady_clock::now();
+    bvh.build(bounds, leaf_batch);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool same_tree(const BVH& a, const BVH& b) {
+    if (a.node_count() != b.node_count() || a.primitive_indices() != b.primitive_indices()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.node_count(); ++i) {
+        const BVHNode& x = a.nodes()[i];
+        const BVHNode& y = b.nodes()[i];
+        if (x.offset != y.offset || x.count != y.count ||
+            x.bounds.min.x != y.bounds.min.x || x.bounds.max.x != y.bounds.max.x ||
+            x.bounds.min.y != y.bounds.min.y || x.bounds.max.y != y.bounds.max.y ||
+            x.bounds.min.z != y.bounds.min.z || x.bounds.max.z != y.bounds.max.z) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Optional arguments: largest triangle count (default 10M) and pool size (default: all cores)
+    const size_t max_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const size_t threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+
+    const uint32_t leaf_batch = simd_width();
+    std::cout << "=== PathRender - BVH Build Benchmark ===" << std::endl;
+    std::cout << "Kernels SIMD: " << simd_level_name(simd_level()) << std::endl;
+    std::cout << "threads: " << threads << ", leaf batch: " << leaf_batch << std::endl;
+    std::cout << std::setw(10) << "triangles" << std::setw(14) << "1 worker ms" << std::setw(14) << "pool ms"
+              << std::setw(10) << "speedup" << std::setw(12) << "Mtri/s" << std::setw(12) << "nodes"
+              << std::setw(10) << "SAH" << std::endl;
+
+    std::mt19937 rng(2024);
+    for (size_t count = 10000; count <= max_count; count *= 10) {
+        std::vector<AABB> bounds = make_triangle_bounds(count, rng);
+
+        BVH sequential, parallel;
+        Utils::ThreadPool::global().set_thread_count(1);
+        double sequential_ms = build_ms(sequential, bounds, leaf_batch);
+        Utils::ThreadPool::global().set_thread_count(threads);
+        double parallel_ms = build_ms(parallel, bounds, leaf_batch);
+
+        if (!same_tree(sequential, parallel)) {
+            std::cerr << "Mismatch: parallel build differs from the single-threaded one" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::setw(10) << count
+                  << std::setw(14) << std::fixed << std::setprecision(1) << sequential_ms
+                  << std::setw(14) << parallel_ms
+                  << std::setw(9) << std::setprecision(2) << sequential_ms / parallel_ms << "x"
+                  << std::setw(12) << count / parallel_ms / 1000.0
+                  << std::setw(12) << parallel.node_count()
+                  << std::setw(10) << std::setprecision(2) << parallel.sah_cost() << std::endl;
+    }
+    return 0;
+}
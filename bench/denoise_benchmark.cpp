@@ -0,0 +1,109 @@
+// Benchmark: poucas amostras + denoiser à-trous contra as 100 spp usadas nos frames
+// finais, nas cenas Cornell; tempos do path tracing e do denoiser medidos em separado
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_common.hpp"
+#include "PathRender/accel/simd.hpp"
+#include "PathRender/rendering/PathTracer.hpp"
+#include "PathRender/scene/yaml_parser.hpp"
+
+using namespace PathRender;
+
+namespace {
+
+struct Result {
+    std::vector<Color> image;  // Linear radiance
+    double trace_seconds = 0.0;
+    double denoise_seconds = 0.0;
+};
+
+Result render(const SceneConfig& config, int spp, uint32_t seed, bool denoise) {
+    PathTracer path_tracer;
+    path_tracer.set_seed(seed);
+    path_tracer.set_max_samples(spp);
+    path_tracer.set_pass_samples(spp);
+    path_tracer.set_adaptive_threshold(0.0f);
+
+    Result result;
+    std::vector<Color> image(static_cast<size_t>(config.output_params.width) * config.output_params.height);
+    // Keep the per-render progress report out of the table
+    std::streambuf* output = std::cout.rdbuf(nullptr);
+    const auto start = std::chrono::steady_clock::now();
+    path_tracer.render(image, config);
+    result.trace_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout.rdbuf(output);
+
+    // The denoiser runs on a copy of the same channels render() resolves, timed on its own
+    FrameBuffer frame = path_tracer.frame();
+    if (denoise) {
+        const auto denoise_start = std::chrono::steady_clock::now();
+        path_tracer.denoiser().denoise(frame);
+        result.denoise_seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - denoise_start).count();
+    }
+    const float* red = frame.channel(Channels::kRed);
+    const float* green = frame.channel(Channels::kGreen);
+    const float* blue = frame.channel(Channels::kBlue);
+    result.image.resize(frame.pixel_count());
+    for (size_t p = 0; p < result.image.size(); ++p) {
+        result.image[p] = Color(red[p], green[p], blue[p]);
+    }
+
+    Bench::clamp_to_display(result.image);
+    return result;
+}
+
+void benchmark_scene(const std::string& scene_file, int resolution, int low_spp, int final_spp, int reference_spp) {
+    YAMLParser parser;
+    SceneConfig config = parser.parse(scene_file);
+    config.output_params.width = resolution;
+    config.output_params.height = resolution;
+
+    // Reference: two independent renders; their difference measures the noise left in it
+    const Bench::Reference reference(render(config, reference_spp, 0x5EED, false).image,
+                                     render(config, reference_spp, 0x5EED + 1, false).image);
+
+    std::cout << "\n" << scene_file << " (" << resolution << "x" << resolution << ", referência 2 x "
+              << reference_spp << " spp)" << std::endl;
+    std::cout << std::setw(22) << "" << std::setw(14) << "path tracing" << std::setw(12) << "denoiser"
+              << std::setw(12) << "total" << std::setw(12) << "RMSE rel." << std::endl;
+
+    struct Row {
+        std::string label;
+        int spp;
+        bool denoise;
+    };
+    const Row rows[] = {{std::to_string(low_spp) + " spp", low_spp, false},
+                        {std::to_string(low_spp) + " spp + denoiser", low_spp, true},
+                        {std::to_string(final_spp) + " spp", final_spp, false}};
+    for (const Row& row : rows) {
+        const Result result = render(config, row.spp, 0, row.denoise);
+        const double mse = reference.error(result.image);
+        std::cout << std::setw(22) << row.label << std::fixed << std::setprecision(3) << std::setw(12)
+                  << result.trace_seconds << " s" << std::setw(10) << result.denoise_seconds << " s"
+                  << std::setw(10) << result.trace_seconds + result.denoise_seconds << " s" << std::setprecision(4)
+                  << std::setw(12) << std::sqrt(mse) / reference.mean << std::defaultfloat << std::endl;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Optional arguments: image side, low spp (denoised), final spp, reference spp
+    const int resolution = argc > 1 ? std::atoi(argv[1]) : 256;
+    const int low_spp = argc > 2 ? std::atoi(argv[2]) : 16;
+    const int final_spp = argc > 3 ? std::atoi(argv[3]) : 100;
+    const int reference_spp = argc > 4 ? std::atoi(argv[4]) : 1024;
+
+    std::cout << "\n=== PathRender - Denoiser Benchmark ===" << std::endl;
+    std::cout << "Kernels SIMD: " << simd_level_name(simd_level()) << std::endl;
+    for (const char* scene : {PATHRENDER_SCENES_DIR "/cornell_box.yaml", PATHRENDER_SCENES_DIR "/cornell_spheres.yaml"}) {
+        benchmark_scene(scene, resolution, low_spp, final_spp, reference_spp);
+    }
+    return 0;
+}
@@ -0,0 +1,176 @@
+// Benchmark: escolha da luz (tabela de alias pela potência vs. BVH de luzes) em um
+// salão iluminado por centenas de painéis de LED, gerado proceduralmente
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "bench_common.hpp"
+#include "PathRender/accel/simd.hpp"
+#include "PathRender/core/PhongBRDF.hpp"
+#include "PathRender/objects/mesh.hpp"
+#include "PathRender/rendering/PathTracer.hpp"
+#include "PathRender/scene/scene_config.hpp"
+
+using namespace PathRender;
+
+namespace {
+
+void add_quad(Mesh& mesh, const Point3& a, const Point3& b, const Point3& c, const Point3& d,
+              uint16_t material_index = 0) {
+    const uint32_t first = mesh.add_vertex(a);
+    mesh.add_vertex(b);
+    mesh.add_vertex(c);
+    mesh.add_vertex(d);
+    mesh.add_triangle(first, first + 1, first + 2, material_index);
+    mesh.add_triangle(first, first + 2, first + 3, material_index);
+}
+
+// Axis-aligned box from its lowest to its highest corner (five faces, no bottom)
+void add_box(Mesh& mesh, const Point3& lo, const Point3& hi, uint16_t material_index) {
+    add_quad(mesh, Point3(lo.x, hi.y, lo.z), Point3(hi.x, hi.y, lo.z), Point3(hi.x, hi.y, hi.z),
+             Point3(lo.x, hi.y, hi.z), material_index);
+    add_quad(mesh, Point3(lo.x, lo.y, lo.z), Point3(hi.x, lo.y, lo.z), Point3(hi.x, hi.y, lo.z),
+             Point3(lo.x, hi.y, lo.z), material_index);
+    add_quad(mesh, Point3(hi.x, lo.y, lo.z), Point3(hi.x, lo.y, hi.z), Point3(hi.x, hi.y, hi.z),
+             Point3(hi.x, hi.y, lo.z), material_index);
+    add_quad(mesh, Point3(hi.x, lo.y, hi.z), Point3(lo.x, lo.y, hi.z), Point3(lo.x, hi.y, hi.z),
+             Point3(hi.x, hi.y, hi.z), material_index);
+    add_quad(mesh, Point3(lo.x, lo.y, hi.z), Point3(lo.x, lo.y, lo.z), Point3(lo.x, hi.y, lo.z),
+             Point3(lo.x, hi.y, hi.z), material_index);
+}
+
+// Wide, low open-plan hall with rows of desks, lit only by panel_count small emissive
+// quads: 3/4 on a ceiling grid, the rest as an LED strip around the walls. The total
+// emitted power does not depend on panel_count
+SceneConfig make_led_hall(int panel_count, int resolution) {
+    const float s = 2000.0f;  // Side of the floor
+    const float h = 300.0f;   // Ceiling height
+
+    auto room = std::make_shared<Mesh>();
+    room->set_material(Material(false, std::make_shared<PhongBRDF>(Color(0.7, 0.7, 0.7))));
+    const uint16_t wood = room->add_material(Material(false, std::make_shared<PhongBRDF>(Color(0.55, 0.35, 0.2))));
+    add_quad(*room, Point3(s, 0, 0), Point3(0, 0, 0), Point3(0, 0, s), Point3(s, 0, s));  // Floor
+    add_quad(*room, Point3(s, h, 0), Point3(s, h, s), Point3(0, h, s), Point3(0, h, 0));  // Ceiling
+    add_quad(*room, Point3(s, 0, s), Point3(0, 0, s), Point3(0, h, s), Point3(s, h, s));
+    add_quad(*room, Point3(0, 0, 0), Point3(s, 0, 0), Point3(s, h, 0), Point3(0, h, 0));
+    add_quad(*room, Point3(0, 0, s), Point3(0, 0, 0), Point3(0, h, 0), Point3(0, h, s));
+    add_quad(*room, Point3(s, 0, 0), Point3(s, 0, s), Point3(s, h, s), Point3(s, h, 0));
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 5; ++j) {
+            const float x = 250.0f + 350.0f * i;
+            const float z = 250.0f + 350.0f * j;
+            add_box(*room, Point3(x, 0, z), Point3(x + 160.0f, 75.0f, z + 80.0f), wood);
+        }
+    }
+
+    // Panels of 8 colors; each one gets the same share of the power
+    auto leds = std::make_shared<Mesh>();
+    const float panel = 30.0f;
+    const double radiance = 4.0e6 / (panel_count * panel * panel);
+    const Color palette[] = {Color(1.0, 1.0, 1.0), Color(1.0, 0.6, 0.3), Color(0.4, 0.6, 1.0), Color(1.0, 0.3, 0.3),
+                             Color(0.3, 1.0, 0.4), Color(1.0, 0.9, 0.4), Color(0.8, 0.4, 1.0), Color(0.4, 1.0, 1.0)};
+    leds->set_material(Material(true, std::make_shared<PhongBRDF>(palette[0] * radiance)));
+    uint16_t colors[8] = {0};
+    for (int c = 1; c < 8; ++c) {
+        colors[c] = leds->add_material(Material(true, std::make_shared<PhongBRDF>(palette[c] * radiance)));
+    }
+
+    const int ceiling = std::max(1, panel_count * 3 / 4);
+    const int grid = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(ceiling))));
+    for (int i = 0; i < ceiling; ++i) {
+        const float x = (i % grid + 0.5f) / grid * s - 0.5f * panel;
+        const float z = (i / grid + 0.5f) / grid * s - 0.5f * panel;
+        const float y = h - 0.5f;
+        add_quad(*leds, Point3(x, y, z), Point3(x + panel, y, z), Point3(x + panel, y, z + panel),
+                 Point3(x, y, z + panel), colors[i % 8]);
+    }
+
+    // Strip at mid height around the four walls
+    const int strip = panel_count - ceiling;
+    const float y = 0.5f * h;
+    const float d = 0.5f;  // Gap to the wall
+    const Vector3 up(0, 0.25f * panel, 0);
+    for (int i = 0; i < strip; ++i) {
+        const float t = (i + 0.5f) / strip * 4.0f;  // Wall index + position along it
+        const float along = (t - std::floor(t)) * (s - panel);
+        Point3 a, b;
+        if (t < 1.0f) {
+            a = Point3(along, y, d), b = Point3(along + panel, y, d);
+        } else if (t < 2.0f) {
+            a = Point3(s - d, y, along), b = Point3(s - d, y, along + panel);
+        } else if (t < 3.0f) {
+            a = Point3(along, y, s - d), b = Point3(along + panel, y, s - d);
+        } else {
+            a = Point3(d, y, along), b = Point3(d, y, along + panel);
+        }
+        add_quad(*leds, a, b, b + up, a + up, colors[i % 8]);
+    }
+
+    Scene scene;
+    scene.add_object(room);
+    scene.add_object(leds);
+    scene.finalize();
+
+    OutputParameters output;
+    output.width = resolution;
+    output.height = resolution;
+    output.output_filename = "led_hall.ppm";
+    Camera camera(Point3(60, 220, 60), Point3(1000, 40, 1000), Vector3(0, 1, 0), 70.0f, 1.0f);
+    return SceneConfig(scene, camera, output, Color(0, 0, 0));
+}
+
+std::vector<Color> render(const SceneConfig& config, LightSelection selection, int spp, uint32_t seed,
+                          double& seconds) {
+    PathTracer path_tracer;
+    path_tracer.set_light_selection(selection);
+    path_tracer.set_seed(seed);
+    path_tracer.set_max_samples(spp);
+    path_tracer.set_pass_samples(spp);
+    path_tracer.set_adaptive_threshold(0.0f);
+    return Bench::render(path_tracer, config, seconds);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Optional arguments: samples per pixel, image side, reference spp
+    const int spp = argc > 1 ? std::atoi(argv[1]) : 16;
+    const int resolution = argc > 2 ? std::atoi(argv[2]) : 64;
+    const int reference_spp = argc > 3 ? std::atoi(argv[3]) : 1024;
+
+    std::cout << "\n=== PathRender - Light Selection Benchmark ===" << std::endl;
+    std::cout << "Kernels SIMD: " << simd_level_name(simd_level()) << std::endl;
+    std::cout << "Salão com painéis de LED, " << resolution << "x" << resolution << ", " << spp
+              << " spp; referência BVH 2 x " << reference_spp << " spp (ruído descontado)" << std::endl;
+    std::cout << std::setw(8) << "painéis" << std::setw(10) << "seleção" << std::setw(11) << "tempo (s)"
+              << std::setw(10) << "média" << std::setw(12) << "RMSE rel." << std::setw(16) << "eficiência" << std::endl;
+
+    for (int panels : {4, 64, 256, 1024}) {
+        const SceneConfig config = make_led_hall(panels, resolution);
+
+        // Reference: two independent renders; their difference measures the noise left in it
+        double seconds = 0.0;
+        const Bench::Reference reference(render(config, LightSelection::BVH, reference_spp, 0x5EED, seconds),
+                                         render(config, LightSelection::BVH, reference_spp, 0x5EED + 1, seconds));
+        const double mean = reference.mean;
+
+        // Efficiency = 1 / (MSE x time), relative to the alias table
+        double power_efficiency = 0.0;
+        for (LightSelection selection : {LightSelection::Power, LightSelection::BVH}) {
+            const std::vector<Color> image = render(config, selection, spp, 0, seconds);
+            const double mse = reference.error(image);
+            const double efficiency = 1.0 / (mse * seconds);
+            if (selection == LightSelection::Power) {
+                power_efficiency = efficiency;
+            }
+            std::cout << std::setw(8) << panels << std::setw(10) << light_selection_name(selection) << std::fixed
+                      << std::setprecision(3) << std::setw(11) << seconds << std::setw(10) << Bench::mean_value(image) / mean
+                      << std::setw(12) << std::sqrt(mse) / mean << std::setprecision(2) << std::setw(15)
+                      << efficiency / power_efficiency << "x" << std::defaultfloat << std::endl;
+        }
+    }
+    return 0;
+}
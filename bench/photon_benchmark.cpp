@@ -0,0 +1,114 @@
+// Benchmark: PhotonMapper (SPPM) contra o PathTracer em cornell_spheres, com o erro
+// medido na imagem toda e na cáustica da esfera de vidro
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_common.hpp"
+#include "PathRender/accel/simd.hpp"
+#include "PathRender/rendering/PhotonMapper.hpp"
+#include "PathRender/scene/yaml_parser.hpp"
+
+using namespace PathRender;
+
+namespace {
+
+// Pixels inside [x0, x1) x [y0, y1), given as fractions of the image (y from the top)
+struct Region {
+    float x0, y0, x1, y1;
+};
+
+// Floor under the glass sphere, where its caustic lands
+constexpr Region kCausticRegion{0.40f, 0.78f, 0.60f, 0.92f};
+constexpr Region kWholeImage{0.0f, 0.0f, 1.0f, 1.0f};
+
+template <typename PixelError>
+double region_mean(const Region& region, int width, int height, PixelError&& error) {
+    const int x0 = static_cast<int>(region.x0 * width), x1 = static_cast<int>(region.x1 * width);
+    const int y0 = static_cast<int>(region.y0 * height), y1 = static_cast<int>(region.y1 * height);
+    double sum = 0.0;
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            sum += error(static_cast<size_t>(y) * width + x);
+        }
+    }
+    return sum / (static_cast<double>(x1 - x0) * (y1 - y0));
+}
+
+double mean_value(const std::vector<Color>& image, const Region& region, int width, int height) {
+    return region_mean(region, width, height, [&](size_t p) { return (image[p].r + image[p].g + image[p].b) / 3.0; });
+}
+
+double mean_squared_error(const std::vector<Color>& a, const std::vector<Color>& b, const Region& region, int width,
+                          int height) {
+    return region_mean(region, width, height, [&](size_t p) {
+        return ((a[p].r - b[p].r) * (a[p].r - b[p].r) + (a[p].g - b[p].g) * (a[p].g - b[p].g) +
+                (a[p].b - b[p].b) * (a[p].b - b[p].b)) / 3.0;
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Optional arguments: image side, photons per pass, reference spp
+    const int resolution = argc > 1 ? std::atoi(argv[1]) : 128;
+    const int photons = argc > 2 ? std::atoi(argv[2]) : 100000;
+    const int reference_spp = argc > 3 ? std::atoi(argv[3]) : 1024;
+
+    std::cout << "\n=== PathRender - Photon Mapping Benchmark ===" << std::endl;
+    std::cout << "Kernels SIMD: " << simd_level_name(simd_level()) << std::endl;
+    const std::string scene_file = PATHRENDER_SCENES_DIR "/cornell_spheres.yaml";
+    YAMLParser parser;
+    SceneConfig config = parser.parse(scene_file);
+    config.output_params.width = resolution;
+    config.output_params.height = resolution;
+
+    // Reference: two independent path-traced renders; their difference measures the noise left in it
+    double seconds = 0.0;
+    const std::vector<Color> first = Bench::path_trace(config, reference_spp, 0x5EED, seconds);
+    const std::vector<Color> second = Bench::path_trace(config, reference_spp, 0x5EED + 1, seconds);
+    std::vector<Color> reference(first.size());
+    for (size_t i = 0; i < reference.size(); ++i) {
+        reference[i] = (first[i] + second[i]) * 0.5;
+    }
+
+    std::cout << "\n" << scene_file << " (" << resolution << "x" << resolution << ", referência path tracing 2 x "
+              << reference_spp << " spp)" << std::endl;
+    std::cout << std::setw(26) << "" << std::setw(11) << "tempo (s)" << std::setw(12) << "RMSE rel." << std::setw(17)
+              << "RMSE cáustica" << std::setw(18) << "média cáustica" << std::endl;
+
+    for (int spp : {16, 64}) {
+        for (bool photon_mapping : {false, true}) {
+            std::vector<Color> image;
+            std::string label;
+            if (photon_mapping) {
+                PhotonMapper photon_mapper;
+                photon_mapper.set_passes(spp);
+                photon_mapper.set_photons_per_pass(photons);
+                image = Bench::render(photon_mapper, config, seconds);
+                label = "SPPM " + std::to_string(spp) + " passes";
+            } else {
+                image = Bench::path_trace(config, spp, 0, seconds);
+                label = "path tracing " + std::to_string(spp) + " spp";
+            }
+
+            std::cout << std::setw(26) << label << std::fixed << std::setprecision(3) << std::setw(11) << seconds;
+            for (const Region& region : {kWholeImage, kCausticRegion}) {
+                const double reference_mse =
+                    mean_squared_error(first, second, region, resolution, resolution) / 4.0;
+                const double mse = std::max(
+                    mean_squared_error(image, reference, region, resolution, resolution) - reference_mse, 1e-30);
+                std::cout << std::setprecision(4) << std::setw(region.x0 == 0.0f ? 12 : 16)
+                          << std::sqrt(mse) / mean_value(reference, region, resolution, resolution);
+            }
+            std::cout << std::setprecision(3) << std::setw(17)
+                      << mean_value(image, kCausticRegion, resolution, resolution) /
+                             mean_value(reference, kCausticRegion, resolution, resolution)
+                      << std::defaultfloat << std::endl;
+        }
+    }
+    return 0;
+}
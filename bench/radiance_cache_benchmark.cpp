@@ -0,0 +1,117 @@
+// Benchmark: tempo e erro do path tracing com o radiance cache consultado a partir de
+// diferentes rebotes e, no modo de preview (rebote 0), com células de vários tamanhos,
+// contra o path tracing completo, nas cenas Cornell
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_common.hpp"
+#include "PathRender/accel/simd.hpp"
+#include "PathRender/rendering/PathTracer.hpp"
+#include "PathRender/rendering/RadianceCache.hpp"
+#include "PathRender/scene/yaml_parser.hpp"
+
+using namespace PathRender;
+
+namespace {
+
+/// Renders por configuração; vale o menor tempo
+constexpr int kTimingRuns = 3;
+
+struct CacheSetup {
+    std::string label;
+    int depth = -1;           ///< -1 = cache desligado
+    float cell_scale = 1.0f;  ///< Lado das células / RadianceCache::default_cell_size()
+    bool reused = false;      ///< Mede um segundo render sobre o cache do primeiro
+};
+
+std::vector<Color> render(const SceneConfig& config, int spp, uint32_t seed, const CacheSetup& setup,
+                          double& seconds) {
+    PathTracer path_tracer;
+    path_tracer.set_seed(seed);
+    path_tracer.set_max_samples(spp);
+    path_tracer.set_adaptive_threshold(0.0f);
+    path_tracer.set_radiance_cache_enabled(setup.depth >= 0);
+    path_tracer.set_radiance_cache_depth(setup.depth);
+    path_tracer.set_radiance_cache_cell_size(setup.cell_scale * RadianceCache::default_cell_size(config.scene));
+    if (setup.reused) {
+        // The first render only fills the cache; a new seed stands in for the next frame
+        path_tracer.set_radiance_cache_persistent(true);
+        Bench::render(path_tracer, config, seconds);
+        path_tracer.set_seed(seed + 1);
+    }
+    return Bench::render(path_tracer, config, seconds);
+}
+
+void benchmark_scene(const std::string& scene_file, int resolution, int spp, int reference_spp) {
+    YAMLParser parser;
+    SceneConfig config = parser.parse(scene_file);
+    config.output_params.width = resolution;
+    config.output_params.height = resolution;
+
+    // Reference: two independent renders without the cache; their difference
+    // measures the noise left in it
+    double seconds = 0.0;
+    const Bench::Reference reference(render(config, reference_spp, 0x5EED, CacheSetup{}, seconds),
+                                     render(config, reference_spp, 0x5EED + 1, CacheSetup{}, seconds));
+    const double mean = reference.mean;
+
+    std::cout << "\n" << scene_file << " (" << resolution << "x" << resolution << ", " << spp
+              << " spp, referência sem cache 2 x " << reference_spp << " spp, melhor tempo de " << kTimingRuns << ")"
+              << std::endl;
+    std::cout << std::setw(26) << "cache" << std::setw(11) << "tempo (s)" << std::setw(10) << "speedup"
+              << std::setw(10) << "média" << std::setw(12) << "RMSE rel." << std::setw(14)
+              << ("RMSE " + std::to_string(reference_spp) + " spp") << std::endl;
+
+    // Lookups from deeper bounces, then the preview mode (first hit) with finer and
+    // coarser cells: larger cells answer more lookups, with more bias
+    const std::vector<CacheSetup> setups = {
+        {"desligado", -1, 1.0f, false},
+        {"rebote 3", 3, 1.0f, false},
+        {"rebote 2", 2, 1.0f, false},
+        {"rebote 1", 1, 1.0f, false},
+        {"rebote 0, células x0.25", 0, 0.25f, false},
+        {"rebote 0, células x0.5", 0, 0.5f, false},
+        {"rebote 0 (padrão)", 0, 1.0f, false},
+        {"rebote 0, células x2", 0, 2.0f, false},
+        {"rebote 0, reaproveitado", 0, 1.0f, true},
+    };
+    // Runs are interleaved across the setups, so a slow spell of the machine does not
+    // land on a single row; each row keeps its best time (the image is always the same).
+    // A last render at the reference spp leaves mostly the bias of the cache in the error
+    std::vector<std::vector<Color>> images(setups.size());
+    std::vector<double> best_seconds(setups.size(), 1e30);
+    for (int run = 0; run < kTimingRuns; ++run) {
+        for (size_t s = 0; s < setups.size(); ++s) {
+            images[s] = render(config, spp, 0, setups[s], seconds);
+            best_seconds[s] = std::min(best_seconds[s], seconds);
+        }
+    }
+    for (size_t s = 0; s < setups.size(); ++s) {
+        const std::vector<Color> converged = render(config, reference_spp, 0, setups[s], seconds);
+        std::cout << std::setw(26) << setups[s].label << std::fixed << std::setprecision(3) << std::setw(11)
+                  << best_seconds[s] << std::setprecision(2) << std::setw(9) << best_seconds[0] / best_seconds[s] << "x"
+                  << std::setprecision(3) << std::setw(10) << Bench::mean_value(images[s]) / mean
+                  << std::setprecision(4) << std::setw(12) << std::sqrt(reference.error(images[s])) / mean
+                  << std::setw(14) << std::sqrt(reference.error(converged)) / mean << std::defaultfloat << std::endl;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Optional arguments: image side, samples per pixel, reference spp
+    const int resolution = argc > 1 ? std::atoi(argv[1]) : 128;
+    const int spp = argc > 2 ? std::atoi(argv[2]) : 64;
+    const int reference_spp = argc > 3 ? std::atoi(argv[3]) : 1024;
+
+    std::cout << "\n=== PathRender - Radiance Cache Benchmark ===" << std::endl;
+    std::cout << "Kernels SIMD: " << simd_level_name(simd_level()) << std::endl;
+    for (const char* scene : {PATHRENDER_SCENES_DIR "/cornell_box.yaml", PATHRENDER_SCENES_DIR "/cornell_spheres.yaml"}) {
+        benchmark_scene(scene, resolution, spp, reference_spp);
+    }
+    return 0;
+}
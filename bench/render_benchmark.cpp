@@ -0,0 +1,91 @@
+// Benchmark: PathTracer (um caminho por vez) vs. WavefrontPathTracer com o mesmo spp
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "PathRender/accel/simd.hpp"
+#include "PathRender/rendering/PathTracer.hpp"
+#include "PathRender/rendering/WavefrontPathTracer.hpp"
+#include "PathRender/scene/yaml_parser.hpp"
+#include "PathRender/utils/thread_pool.hpp"
+
+using namespace PathRender;
+
+namespace {
+
+// Best of a few runs, in seconds
+template <typename Render>
+double best_seconds(int runs, Render&& render) {
+    double best = 1e30;
+    for (int run = 0; run < runs; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        render();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+double mean_value(const std::vector<Color>& image) {
+    double sum = 0.0;
+    for (const Color& c : image) {
+        sum += c.r + c.g + c.b;
+    }
+    return sum / (3.0 * image.size());
+}
+
+double rmse(const std::vector<Color>& a, const std::vector<Color>& b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        sum += (a[i].r - b[i].r) * (a[i].r - b[i].r) + (a[i].g - b[i].g) * (a[i].g - b[i].g) +
+               (a[i].b - b[i].b) * (a[i].b - b[i].b);
+    }
+    return std::sqrt(sum / (3.0 * a.size()));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Optional arguments: scene file and samples per pixel
+    const std::string scene_file = argc > 1 ? argv[1] : PATHRENDER_SCENES_DIR "/cornell_spheres.yaml";
+    const int spp = argc > 2 ? std::atoi(argv[2]) : 16;
+    const int runs = 2;
+
+    YAMLParser parser;
+    SceneConfig config = parser.parse(scene_file);
+    const int width = config.output_params.width;
+    const int height = config.output_params.height;
+
+    std::vector<Color> path_image(static_cast<size_t>(width) * height);
+    std::vector<Color> wavefront_image(path_image.size());
+
+    PathTracer path_tracer;
+    path_tracer.set_max_samples(spp);
+    path_tracer.set_pass_samples(spp);
+    path_tracer.set_adaptive_threshold(0.0f);
+    const double path_seconds = best_seconds(runs, [&] { path_tracer.render(path_image, config); });
+
+    WavefrontPathTracer wavefront;
+    wavefront.set_samples_per_pixel(spp);
+    const double wavefront_seconds = best_seconds(runs, [&] { wavefront.render(wavefront_image, config); });
+
+    const double samples = static_cast<double>(width) * height * spp;
+    std::cout << "\n=== PathRender - Render Benchmark ===" << std::endl;
+    std::cout << "Kernels SIMD: " << simd_level_name(simd_level()) << std::endl;
+    std::cout << scene_file << " (" << width << "x" << height << ", " << spp << " spp, "
+              << Utils::ThreadPool::global().size() << " threads, best of " << runs << ")" << std::endl;
+    std::cout << std::setw(12) << "" << std::setw(10) << "s" << std::setw(14) << "Msamples/s" << std::setw(10) << "mean"
+              << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::setw(12) << "PathTracer" << std::setw(10) << path_seconds << std::setw(14)
+              << samples / path_seconds / 1e6 << std::setw(10) << mean_value(path_image) << std::endl;
+    std::cout << std::setw(12) << "Wavefront" << std::setw(10) << wavefront_seconds << std::setw(14)
+              << samples / wavefront_seconds / 1e6 << std::setw(10) << mean_value(wavefront_image) << std::endl;
+    std::cout << "speedup: " << std::setprecision(2) << path_seconds / wavefront_seconds
+              << "x, RMSE between images (noise): " << std::setprecision(4) << rmse(path_image, wavefront_image)
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,104 @@
+// Benchmark: amostras por pixel que cada sampler precisa para atingir um RMSE alvo
+// (erro igual) nas cenas Cornell, medido contra uma referência de muitas amostras
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_common.hpp"
+#include "PathRender/accel/simd.hpp"
+#include "PathRender/core/sampler.hpp"
+#include "PathRender/rendering/PathTracer.hpp"
+#include "PathRender/scene/yaml_parser.hpp"
+
+using namespace PathRender;
+
+namespace {
+
+constexpr SamplerType kSamplers[] = {SamplerType::Independent, SamplerType::Stratified, SamplerType::Halton,
+                                     SamplerType::Sobol};
+
+// Linear radiance (Bench::render): the gamma 2 of the output turns the error of dark
+// pixels into ~N^-1/4 and hides the sampler
+std::vector<Color> render(const SceneConfig& config, SamplerType sampler, int spp, uint32_t seed) {
+    PathTracer path_tracer;
+    path_tracer.set_sampler_type(sampler);
+    path_tracer.set_seed(seed);
+    path_tracer.set_max_samples(spp);
+    path_tracer.set_pass_samples(spp);
+    path_tracer.set_adaptive_threshold(0.0f);
+    double seconds = 0.0;
+    return Bench::render(path_tracer, config, seconds);
+}
+
+void benchmark_scene(const std::string& scene_file, int resolution, int max_spp, int reference_spp, double target) {
+    YAMLParser parser;
+    SceneConfig config = parser.parse(scene_file);
+    config.output_params.width = resolution;
+    config.output_params.height = resolution;
+
+    // Reference: average of two renders with seeds other than the measured ones
+    const Bench::Reference reference(render(config, SamplerType::Sobol, reference_spp, 0x5EED),
+                                     render(config, SamplerType::Sobol, reference_spp, 0x5EED + 1));
+
+    std::vector<int> spp_steps;
+    for (int spp = 1; spp <= max_spp; spp *= 2) {
+        spp_steps.push_back(spp);
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n" << scene_file << " (" << resolution << "x" << resolution << ", referência Sobol 2 x "
+              << reference_spp << " spp, RMSE relativo alvo " << target << ")" << std::endl;
+    std::cout << "RMSE relativo (RMSE / radiância média) por spp; ruído da referência "
+              << std::sqrt(reference.mse) / reference.mean << " (descontado)" << std::endl;
+    std::cout << std::setw(12) << "spp";
+    for (int spp : spp_steps) {
+        std::cout << std::setw(9) << spp;
+    }
+    std::cout << std::setw(14) << "spp p/ alvo" << std::setw(10) << "vs indep" << std::endl;
+
+    double independent_spp = 0.0;
+    for (SamplerType sampler : kSamplers) {
+        std::vector<double> errors;
+        for (int spp : spp_steps) {
+            errors.push_back(std::sqrt(reference.error(render(config, sampler, spp, 0))) / reference.mean);
+        }
+        const double needed = Bench::spp_for_error(spp_steps, errors, target);
+        if (sampler == SamplerType::Independent) {
+            independent_spp = needed;
+        }
+
+        std::cout << std::setw(12) << sampler_type_name(sampler) << std::fixed << std::setprecision(4);
+        for (double error : errors) {
+            std::cout << std::setw(9) << error;
+        }
+        std::cout << std::setprecision(1);
+        if (needed > 0.0) {
+            std::cout << std::setw(14) << needed;
+            if (independent_spp > 0.0) {
+                std::cout << std::setw(9) << independent_spp / needed << "x";
+            }
+        } else {
+            std::cout << std::setw(14) << ("> " + std::to_string(max_spp));
+        }
+        std::cout << std::defaultfloat << std::endl;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Optional arguments: target relative RMSE, image side, largest spp measured, reference spp
+    const double target = argc > 1 ? std::atof(argv[1]) : 0.2;
+    const int resolution = argc > 2 ? std::atoi(argv[2]) : 48;
+    const int max_spp = argc > 3 ? std::atoi(argv[3]) : 128;
+    const int reference_spp = argc > 4 ? std::atoi(argv[4]) : 1024;
+
+    std::cout << "\n=== PathRender - Sampler Benchmark (erro igual) ===" << std::endl;
+    std::cout << "Kernels SIMD: " << simd_level_name(simd_level()) << std::endl;
+    for (const char* scene : {PATHRENDER_SCENES_DIR "/cornell_box.yaml", PATHRENDER_SCENES_DIR "/cornell_spheres.yaml"}) {
+        benchmark_scene(scene, resolution, max_spp, reference_spp, target);
+    }
+    return 0;
+}
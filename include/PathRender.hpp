@@ -8,12 +8,20 @@
 #include "PathRender/core/light.hpp"
 #include "PathRender/core/HitRecord.hpp"
 #include "PathRender/core/ScatterRecord.hpp"
+#include "PathRender/core/sampler.hpp"
 #include "PathRender/core/BRDF.hpp"
 #include "PathRender/core/PhongBRDF.hpp"
 #include "PathRender/core/DieletricBRDF.hpp"
 #include "PathRender/core/AnisotropicMatteBRDF.hpp"
+#include "PathRender/core/aabb.hpp"
 #endif // PRISM_CORE
 
+#ifdef PATHRENDER_BUILD_ACCEL
+#include "PathRender/accel/bvh.hpp"
+#include "PathRender/accel/simd.hpp"
+#include "PathRender/accel/wide_bvh.hpp"
+#endif // PATHRENDER_BUILD_ACCEL
+
 #ifdef PATHRENDER_BUILD_OBJECTS
 #include "PathRender/objects/objects.hpp"
 #include "PathRender/objects/plane.hpp"
@@ -31,4 +39,5 @@
 #ifdef PATHRENDER_BUILD_UTILS
 #include "PathRender/utils/filesystem_utils.hpp"
 #include "PathRender/utils/math_utils.hpp"
+#include "PathRender/utils/thread_pool.hpp"
 #endif // PATHRENDER_BUILD_UTILS
\ No newline at end of file
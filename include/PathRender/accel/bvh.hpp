@@ -0,0 +1,275 @@
+#ifndef PATHRENDER_BVH_HPP_
+#define PATHRENDER_BVH_HPP_
+
+#include "PathRender/core/aabb.hpp"
+#include "PathRender/core/ray.hpp"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace PathRender {
+
+/**
+ * @struct BVHNode
+ * @brief Nó de uma BVH binária
+ *
+ * Nós internos guardam em @c offset o índice do filho esquerdo (o direito é
+ * @c offset + 1) e têm @c count == 0. Folhas guardam em @c offset o primeiro
+ * primitivo de um intervalo contíguo de @c count primitivos.
+ */
+struct BVHNode {
+    AABB bounds;
+    uint32_t offset = 0;
+    uint32_t count = 0;
+
+    bool is_leaf() const { return count > 0; }
+};
+
+/**
+ * @class BVH
+ * @brief Bounding volume hierarchy construída com a heurística de área de superfície (SAH)
+ *
+ * A BVH não conhece os primitivos: é construída a partir das caixas de cada um e
+ * devolve, nas folhas, intervalos de posições em primitive_indices(). Isso permite
+ * usar a mesma estrutura para objetos da cena e para triângulos de uma malha.
+ *
+ * A construção usa as threads de Utils::ThreadPool::global(): nos níveis de cima
+ * o binning dos centroides é dividido entre as threads e, abaixo disso, cada
+ * subárvore vira uma tarefa independente. O resultado é idêntico ao de uma
+ * construção sequencial.
+ */
+class BVH {
+public:
+    /// Capacidade das pilhas de travessia; build() mantém as folhas a no máximo
+    /// kStackSize - 1 níveis da raiz
+    static constexpr int kStackSize = 64;
+
+    BVH() = default;
+
+    /**
+     * @brief Constrói a hierarquia (binned SAH)
+     *
+     * Perto do limite de profundidade a divisão SAH dá lugar à mediana, que
+     * chega às folhas antes do limite.
+     * @param primitive_bounds Caixa delimitadora de cada primitivo
+     * @param leaf_batch Primitivos testados juntos por um kernel SIMD; o custo de
+     *        uma folha com n primitivos passa a ser ceil(n / leaf_batch)
+     */
+    void build(const std::vector<AABB>& primitive_bounds, uint32_t leaf_batch = 1);
+
+    void clear();
+
+    bool empty() const { return m_nodes.empty(); }
+
+    const AABB& bounds() const;
+
+    /**
+     * @brief Índices originais dos primitivos na ordem das folhas
+     */
+    const std::vector<uint32_t>& primitive_indices() const { return m_primitive_indices; }
+
+    const std::vector<BVHNode>& nodes() const { return m_nodes; }
+
+    /**
+     * @brief Custo SAH da árvore (travessia = 1, interseção = 1 por lote de primitivos),
+     *        relativo à área da raiz; menor é melhor
+     */
+    float sah_cost() const { return m_sah_cost; }
+
+    size_t node_count() const { return m_nodes.size(); }
+
+    /**
+     * @brief Bytes ocupados pelos nós e índices de primitivos
+     */
+    size_t memory_usage() const {
+        return m_nodes.capacity() * sizeof(BVHNode) + m_primitive_indices.capacity() * sizeof(uint32_t);
+    }
+
+    /**
+     * @brief Percorre a hierarquia da frente para trás
+     *
+     * @p leaf é chamado como leaf(first, count, t_max) para cada folha atingida,
+     * onde [first, first + count) indexa primitive_indices(). Deve retornar true e
+     * reduzir t_max quando encontrar uma interseção mais próxima.
+     *
+     * @return true se alguma folha reportou interseção
+     */
+    template <typename LeafFn>
+    bool traverse(const Ray& ray, float t_min, float& t_max, LeafFn&& leaf) const;
+
+    /**
+     * @brief Percorre a hierarquia até a primeira folha que reporte interseção (any-hit)
+     *
+     * @p leaf é chamado como leaf(first, count) e retorna true para encerrar a busca.
+     * Os filhos não são ordenados por distância.
+     */
+    template <typename LeafFn>
+    bool traverse_any(const Ray& ray, float t_min, float t_max, LeafFn&& leaf) const;
+
+private:
+    struct BuildPrimitive {
+        AABB bounds;
+        Point3 centroid;
+        uint32_t index;
+    };
+
+    /// Nó em construção: o filho esquerdo segue o nó na mesma arena, a menos que
+    /// left_arena aponte a raiz de outra arena (subárvore construída em outra tarefa)
+    struct BuildNode {
+        BVHNode node;
+        uint32_t left_arena;
+    };
+
+    struct BuildContext;
+
+    uint32_t build_recursive(BuildContext& context, std::vector<BuildNode>& arena, uint32_t begin, uint32_t end,
+                             int depth);
+
+    void compact(const BuildContext& context, uint32_t arena, uint32_t source_index, uint32_t node_index);
+
+    static constexpr int kBinCount = 16;
+    static constexpr uint32_t kMaxLeafSize = 4;
+    static constexpr int kMaxDepth = kStackSize - 1;
+
+    float intersection_cost(uint32_t count) const {
+        return static_cast<float>((count + m_leaf_batch - 1) / m_leaf_batch);
+    }
+
+    uint32_t m_leaf_batch = 1;
+    uint32_t m_max_leaf_size = kMaxLeafSize;
+
+    std::vector<BVHNode> m_nodes;
+    std::vector<uint32_t> m_primitive_indices;
+    float m_sah_cost = 0.0f;
+};
+
+template <typename LeafFn>
+bool BVH::traverse(const Ray& ray, float t_min, float& t_max, LeafFn&& leaf) const {
+    if (m_nodes.empty()) {
+        return false;
+    }
+
+    const Vector3 inv_dir(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+
+    float t_entry;
+    if (!m_nodes[0].bounds.intersect(ray, inv_dir, t_min, t_max, t_entry)) {
+        return false;
+    }
+
+    struct StackEntry {
+        uint32_t node;
+        float t_entry;
+    };
+
+    bool hit_anything = false;
+    StackEntry stack[kStackSize];
+    int stack_size = 0;
+    uint32_t node_index = 0;
+
+    while (true) {
+        const BVHNode& node = m_nodes[node_index];
+
+        if (node.is_leaf()) {
+            if (leaf(node.offset, node.count, t_max)) {
+                hit_anything = true;
+            }
+        } else {
+            const uint32_t left = node.offset;
+            const uint32_t right = node.offset + 1;
+            float t_left, t_right;
+            bool hit_left = m_nodes[left].bounds.intersect(ray, inv_dir, t_min, t_max, t_left);
+            bool hit_right = m_nodes[right].bounds.intersect(ray, inv_dir, t_min, t_max, t_right);
+
+            if (hit_left && hit_right) {
+                // Visit the nearer child first, keep the other for later
+                assert(stack_size < kStackSize);
+                if (t_left <= t_right) {
+                    stack[stack_size++] = {right, t_right};
+                    node_index = left;
+                } else {
+                    stack[stack_size++] = {left, t_left};
+                    node_index = right;
+                }
+                continue;
+            }
+            if (hit_left) {
+                node_index = left;
+                continue;
+            }
+            if (hit_right) {
+                node_index = right;
+                continue;
+            }
+        }
+
+        // Pop the next node, skipping those that start beyond the closest hit
+        bool found = false;
+        while (stack_size > 0) {
+            const StackEntry& entry = stack[--stack_size];
+            if (entry.t_entry <= t_max) {
+                node_index = entry.node;
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            break;
+        }
+    }
+
+    return hit_anything;
+}
+
+template <typename LeafFn>
+bool BVH::traverse_any(const Ray& ray, float t_min, float t_max, LeafFn&& leaf) const {
+    if (m_nodes.empty()) {
+        return false;
+    }
+
+    const Vector3 inv_dir(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+
+    float t_entry;
+    if (!m_nodes[0].bounds.intersect(ray, inv_dir, t_min, t_max, t_entry)) {
+        return false;
+    }
+
+    uint32_t stack[kStackSize];
+    int stack_size = 0;
+    stack[stack_size++] = 0;
+
+    while (stack_size > 0) {
+        const BVHNode& node = m_nodes[stack[--stack_size]];
+        if (node.is_leaf()) {
+            if (leaf(node.offset, node.count)) {
+                return true;
+            }
+            continue;
+        }
+
+        // Nearer child on top of the stack: it is the likelier blocker
+        const uint32_t left = node.offset;
+        const uint32_t right = node.offset + 1;
+        float t_left, t_right;
+        bool hit_left = m_nodes[left].bounds.intersect(ray, inv_dir, t_min, t_max, t_left);
+        bool hit_right = m_nodes[right].bounds.intersect(ray, inv_dir, t_min, t_max, t_right);
+        assert(stack_size + 2 <= kStackSize);
+        if (hit_left && hit_right && t_left <= t_right) {
+            stack[stack_size++] = right;
+            stack[stack_size++] = left;
+        } else if (hit_left && hit_right) {
+            stack[stack_size++] = left;
+            stack[stack_size++] = right;
+        } else if (hit_left) {
+            stack[stack_size++] = left;
+        } else if (hit_right) {
+            stack[stack_size++] = right;
+        }
+    }
+
+    return false;
+}
+
+} // namespace PathRender
+
+#endif // PATHRENDER_BVH_HPP_
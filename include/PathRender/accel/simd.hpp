@@ -0,0 +1,139 @@
+#ifndef PATHRENDER_SIMD_HPP_
+#define PATHRENDER_SIMD_HPP_
+
+#include "PathRender/core/ray.hpp"
+#include "PathRender/objects/triangle.hpp"
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PATHRENDER_INLINE_SSE 1
+#endif
+
+namespace PathRender {
+
+/// Maior largura de kernel suportada; TriangleSoA::pad() usa este valor
+constexpr uint32_t kMaxSimdWidth = 8;
+
+/**
+ * @enum SimdLevel
+ * @brief Conjunto de instruções usado pelos kernels de interseção
+ */
+enum class SimdLevel {
+    Scalar = 0,  ///< Um primitivo por vez (qualquer CPU)
+    SSE = 1,     ///< 4 primitivos por vez (SSE2, presente em todo x86-64)
+    AVX2 = 2     ///< 8 primitivos por vez
+};
+
+/**
+ * @brief Nível SIMD em uso
+ *
+ * Detectado na primeira chamada a partir da CPU em execução, de modo que o
+ * mesmo binário roda em qualquer máquina. A variável de ambiente
+ * PATHRENDER_SIMD (scalar, sse ou avx2) pode reduzir o nível escolhido. A
+ * biblioteca não registra a escolha; a aplicação e os benchmarks a imprimem
+ * com simd_level_name(simd_level()).
+ */
+SimdLevel simd_level();
+
+/**
+ * @brief Força um nível SIMD (limitado ao que a CPU suporta); usado por benchmarks
+ *
+ * Estruturas já construídas (ex.: BVH de malhas) não são refeitas.
+ */
+void set_simd_level(SimdLevel level);
+
+/**
+ * @brief Número de primitivos testados por chamada de kernel no nível atual (1, 4 ou 8)
+ */
+uint32_t simd_width();
+
+const char* simd_level_name(SimdLevel level);
+
+/**
+ * @struct SimdRay
+ * @brief Dados do raio pré-calculados para os kernels de caixas
+ */
+struct SimdRay {
+    float origin[3];
+    float inv_dir[3];
+
+    explicit SimdRay(const Ray& ray)
+        : origin{ray.origin.x, ray.origin.y, ray.origin.z},
+          inv_dir{1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z} {}
+};
+
+namespace Simd {
+
+/**
+ * @brief Índice do bit menos significativo ligado (@p mask != 0)
+ */
+inline int lowest_bit(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int index = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+/**
+ * @brief Interseção mais próxima entre um raio e os triângulos [first, first + count)
+ *
+ * Usa o kernel do nível SIMD atual; v0 é lido de @p vertices, o vetor de
+ * vértices em que TriangleSoA::v0_index indexa. Os vetores de @p triangles devem ter sido
+ * preenchidos com TriangleSoA::pad(kMaxSimdWidth) para que leituras vetoriais
+ * após o último triângulo sejam válidas; as pistas excedentes são mascaradas.
+ *
+ * @param t_max Reduzido para a distância do hit encontrado
+ * @param primitive, u, v Triângulo e coordenadas baricêntricas (só alterados se houver hit)
+ */
+bool intersect_triangles(const TriangleSoA& triangles, const Point3* vertices,
+                         uint32_t first, uint32_t count, const Ray& ray, float t_min, float& t_max,
+                         uint32_t& primitive, float& u, float& v);
+
+uint32_t intersect_boxes4_scalar(const float* boxes, const SimdRay& ray, float t_min, float t_max, float* t_entry);
+
+/**
+ * @brief Testa um raio contra 4 caixas em layout SoA
+ *
+ * @p boxes contém 6 grupos de 4 floats: min_x, min_y, min_z, max_x, max_y, max_z.
+ * Em x86-64 o SSE2 faz parte da arquitetura, então o kernel é expandido inline
+ * (é chamado uma vez por nó visitado); nas demais usa o kernel escalar.
+ *
+ * @return Máscara de bits das caixas atingidas; @p t_entry recebe as distâncias de entrada
+ */
+inline uint32_t intersect_boxes4(const float* boxes, const SimdRay& ray, float t_min, float t_max, float* t_entry) {
+#ifdef PATHRENDER_INLINE_SSE
+    __m128 t0 = _mm_set1_ps(t_min);
+    __m128 t1 = _mm_set1_ps(t_max);
+    for (int axis = 0; axis < 3; ++axis) {
+        const __m128 origin = _mm_set1_ps(ray.origin[axis]);
+        const __m128 inv_dir = _mm_set1_ps(ray.inv_dir[axis]);
+        const __m128 a = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes + axis * 4), origin), inv_dir);
+        const __m128 b = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes + (axis + 3) * 4), origin), inv_dir);
+        // max/min return the second operand on NaN, keeping the running interval
+        t0 = _mm_max_ps(_mm_min_ps(a, b), t0);
+        t1 = _mm_min_ps(_mm_max_ps(a, b), t1);
+    }
+    _mm_storeu_ps(t_entry, t0);
+    return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(t0, t1)));
+#else
+    return intersect_boxes4_scalar(boxes, ray, t_min, t_max, t_entry);
+#endif
+}
+
+/**
+ * @brief Como intersect_boxes4, para 8 caixas (6 grupos de 8 floats)
+ */
+uint32_t intersect_boxes8(const float* boxes, const SimdRay& ray, float t_min, float t_max, float* t_entry);
+
+} // namespace Simd
+
+} // namespace PathRender
+
+#endif // PATHRENDER_SIMD_HPP_
@@ -0,0 +1,350 @@
+#ifndef PATHRENDER_WIDE_BVH_HPP_
+#define PATHRENDER_WIDE_BVH_HPP_
+
+#include "PathRender/accel/bvh.hpp"
+#include "PathRender/accel/simd.hpp"
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+/// Largura dos nós da BVH usada por Scene e Mesh (2, 4 ou 8), definida pelo CMake
+#ifndef PATHRENDER_BVH_WIDTH
+#define PATHRENDER_BVH_WIDTH 4
+#endif
+
+namespace PathRender {
+
+/**
+ * @struct WideBVHNode
+ * @brief Nó de uma BVH com até @p Width filhos
+ *
+ * As caixas dos filhos ficam em layout SoA (6 grupos de @p Width floats:
+ * min_x, min_y, min_z, max_x, max_y, max_z), prontas para Simd::intersect_boxes4/8.
+ * Para cada filho, @c count == 0 indica um nó interno de índice @c child; caso
+ * contrário é uma folha com @c count primitivos a partir de @c child.
+ */
+template <int Width>
+struct WideBVHNode {
+    alignas(4 * Width) float bounds[6 * Width];
+    uint32_t child[Width];
+    uint32_t count[Width];
+    uint32_t child_count = 0;
+};
+
+/**
+ * @class WideBVH
+ * @brief BVH de 4 ou 8 filhos por nó, obtida colapsando uma BVH binária
+ *
+ * Todas as caixas filhas de um nó são testadas contra o raio em um único
+ * passo SIMD e os filhos atingidos são visitados em ordem de distância.
+ * Mantém a interface da BVH binária (build, primitive_indices, traverse),
+ * de modo que as duas são intercambiáveis; veja AccelBVH.
+ */
+template <int Width>
+class WideBVH {
+    static_assert(Width == 4 || Width == 8, "WideBVH suporta nós de 4 ou 8 filhos");
+
+public:
+    using Node = WideBVHNode<Width>;
+
+    WideBVH() = default;
+
+    /**
+     * @brief Constrói a BVH binária (binned SAH) e a colapsa
+     */
+    void build(const std::vector<AABB>& primitive_bounds, uint32_t leaf_batch = 1) {
+        BVH binary;
+        binary.build(primitive_bounds, leaf_batch);
+        build(binary);
+    }
+
+    /**
+     * @brief Colapsa uma BVH binária já construída
+     *
+     * As folhas e a ordem dos primitivos são as mesmas da BVH binária.
+     */
+    void build(const BVH& binary);
+
+    void clear() {
+        m_nodes.clear();
+        m_primitive_indices.clear();
+        m_bounds = AABB();
+        m_sah_cost = 0.0f;
+    }
+
+    bool empty() const { return m_nodes.empty(); }
+
+    const AABB& bounds() const { return m_bounds; }
+
+    const std::vector<uint32_t>& primitive_indices() const { return m_primitive_indices; }
+
+    const std::vector<Node>& nodes() const { return m_nodes; }
+
+    size_t node_count() const { return m_nodes.size(); }
+
+    /**
+     * @brief Custo SAH da BVH binária que originou esta árvore
+     */
+    float sah_cost() const { return m_sah_cost; }
+
+    size_t memory_usage() const {
+        return m_nodes.capacity() * sizeof(Node) + m_primitive_indices.capacity() * sizeof(uint32_t);
+    }
+
+    /**
+     * @brief Percorre a hierarquia da frente para trás (mesmo contrato de BVH::traverse)
+     */
+    template <typename LeafFn>
+    bool traverse(const Ray& ray, float t_min, float& t_max, LeafFn&& leaf) const;
+
+    /**
+     * @brief Busca any-hit (mesmo contrato de BVH::traverse_any)
+     */
+    template <typename LeafFn>
+    bool traverse_any(const Ray& ray, float t_min, float t_max, LeafFn&& leaf) const;
+
+private:
+    void collapse(const std::vector<BVHNode>& binary_nodes, uint32_t binary_index, uint32_t wide_index);
+
+    static uint32_t intersect_children(const Node& node, const SimdRay& ray, float t_min, float t_max, float* t_entry) {
+        uint32_t mask;
+        if constexpr (Width == 4) {
+            mask = Simd::intersect_boxes4(node.bounds, ray, t_min, t_max, t_entry);
+        } else {
+            mask = Simd::intersect_boxes8(node.bounds, ray, t_min, t_max, t_entry);
+        }
+        return mask & ((1u << node.child_count) - 1u);
+    }
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_primitive_indices;
+    AABB m_bounds;
+    float m_sah_cost = 0.0f;
+};
+
+template <int Width>
+void WideBVH<Width>::build(const BVH& binary) {
+    clear();
+    if (binary.empty()) {
+        return;
+    }
+
+    m_bounds = binary.bounds();
+    m_sah_cost = binary.sah_cost();
+    m_primitive_indices = binary.primitive_indices();
+
+    // Every wide node comes from a distinct binary node, so this never reallocates
+    m_nodes.reserve(binary.node_count());
+    m_nodes.emplace_back();
+    collapse(binary.nodes(), 0, 0);
+    m_nodes.shrink_to_fit();
+}
+
+template <int Width>
+void WideBVH<Width>::collapse(const std::vector<BVHNode>& binary_nodes, uint32_t binary_index, uint32_t wide_index) {
+    // Gather up to Width descendants, always opening the internal child with the
+    // largest surface area (the one most likely to be visited)
+    uint32_t children[Width];
+    uint32_t child_count = 0;
+    const BVHNode& root = binary_nodes[binary_index];
+    if (root.is_leaf()) {
+        children[child_count++] = binary_index;
+    } else {
+        children[child_count++] = root.offset;
+        children[child_count++] = root.offset + 1;
+    }
+
+    while (child_count < Width) {
+        int best = -1;
+        float best_area = -1.0f;
+        for (uint32_t i = 0; i < child_count; ++i) {
+            const BVHNode& child = binary_nodes[children[i]];
+            if (!child.is_leaf() && child.bounds.surface_area() > best_area) {
+                best = static_cast<int>(i);
+                best_area = child.bounds.surface_area();
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+        const uint32_t opened = children[best];
+        children[best] = binary_nodes[opened].offset;
+        children[child_count++] = binary_nodes[opened].offset + 1;
+    }
+
+    Node node;
+    node.child_count = child_count;
+    uint32_t internal[Width];
+    uint32_t internal_count = 0;
+    for (uint32_t i = 0; i < Width; ++i) {
+        // Unused lanes get an empty box and are masked off during traversal
+        const AABB box = i < child_count ? binary_nodes[children[i]].bounds : AABB();
+        node.bounds[0 * Width + i] = box.min.x;
+        node.bounds[1 * Width + i] = box.min.y;
+        node.bounds[2 * Width + i] = box.min.z;
+        node.bounds[3 * Width + i] = box.max.x;
+        node.bounds[4 * Width + i] = box.max.y;
+        node.bounds[5 * Width + i] = box.max.z;
+        node.child[i] = 0;
+        node.count[i] = 0;
+        if (i >= child_count) {
+            continue;
+        }
+
+        const BVHNode& child = binary_nodes[children[i]];
+        if (child.is_leaf()) {
+            node.child[i] = child.offset;
+            node.count[i] = child.count;
+        } else {
+            node.child[i] = static_cast<uint32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+            internal[internal_count++] = i;
+        }
+    }
+    m_nodes[wide_index] = node;
+
+    for (uint32_t k = 0; k < internal_count; ++k) {
+        const uint32_t i = internal[k];
+        collapse(binary_nodes, children[i], node.child[i]);
+    }
+}
+
+template <int Width>
+template <typename LeafFn>
+bool WideBVH<Width>::traverse(const Ray& ray, float t_min, float& t_max, LeafFn&& leaf) const {
+    if (m_nodes.empty()) {
+        return false;
+    }
+
+    const SimdRay simd_ray(ray);
+
+    struct StackEntry {
+        uint32_t index;
+        uint32_t count;  // 0 for an internal node, otherwise a leaf
+        float t_entry;
+    };
+
+    // Each visited node pops one entry and pushes at most Width, and the collapsed
+    // tree is no deeper than the binary one
+    constexpr int kStackCapacity = BVH::kStackSize * (Width - 1) + 1;
+    StackEntry stack[kStackCapacity];
+    int stack_size = 0;
+    bool hit_anything = false;
+    uint32_t node_index = 0;
+
+    while (true) {
+        const Node& node = m_nodes[node_index];
+        alignas(4 * Width) float t_entry[Width];
+        uint32_t mask = intersect_children(node, simd_ray, t_min, t_max, t_entry);
+
+        // Sort the hit children by entry distance (insertion sort, at most Width items)
+        StackEntry hits[Width];
+        int hit_count = 0;
+        while (mask) {
+            const int lane = Simd::lowest_bit(mask);
+            mask &= mask - 1;
+            StackEntry entry{node.child[lane], node.count[lane], t_entry[lane]};
+            int j = hit_count++;
+            while (j > 0 && hits[j - 1].t_entry > entry.t_entry) {
+                hits[j] = hits[j - 1];
+                j--;
+            }
+            hits[j] = entry;
+        }
+
+        // Push far to near so the nearest child is popped first
+        assert(stack_size + hit_count <= kStackCapacity);
+        for (int i = hit_count - 1; i >= 0; --i) {
+            stack[stack_size++] = hits[i];
+        }
+
+        // Pop the next internal node, testing leaves on the way and skipping
+        // entries that start beyond the closest hit
+        bool found = false;
+        while (stack_size > 0) {
+            const StackEntry entry = stack[--stack_size];
+            if (entry.t_entry > t_max) {
+                continue;
+            }
+            if (entry.count > 0) {
+                if (leaf(entry.index, entry.count, t_max)) {
+                    hit_anything = true;
+                }
+                continue;
+            }
+            node_index = entry.index;
+            found = true;
+            break;
+        }
+        if (!found) {
+            break;
+        }
+    }
+
+    return hit_anything;
+}
+
+template <int Width>
+template <typename LeafFn>
+bool WideBVH<Width>::traverse_any(const Ray& ray, float t_min, float t_max, LeafFn&& leaf) const {
+    if (m_nodes.empty()) {
+        return false;
+    }
+
+    const SimdRay simd_ray(ray);
+    constexpr int kStackCapacity = BVH::kStackSize * (Width - 1) + 1;
+    uint32_t stack[kStackCapacity];
+    int stack_size = 0;
+    stack[stack_size++] = 0;
+
+    while (stack_size > 0) {
+        const Node& node = m_nodes[stack[--stack_size]];
+        alignas(4 * Width) float t_entry[Width];
+        uint32_t mask = intersect_children(node, simd_ray, t_min, t_max, t_entry);
+
+        // Any blocking hit ends the search, so leaves are tested as soon as they are
+        // reached; internal children are pushed far to near so near ones go first
+        uint32_t internal[Width];
+        float internal_t[Width];
+        int internal_count = 0;
+        while (mask) {
+            const int lane = Simd::lowest_bit(mask);
+            mask &= mask - 1;
+            if (node.count[lane] > 0) {
+                if (leaf(node.child[lane], node.count[lane])) {
+                    return true;
+                }
+                continue;
+            }
+            int j = internal_count++;
+            while (j > 0 && internal_t[j - 1] < t_entry[lane]) {
+                internal[j] = internal[j - 1];
+                internal_t[j] = internal_t[j - 1];
+                j--;
+            }
+            internal[j] = node.child[lane];
+            internal_t[j] = t_entry[lane];
+        }
+        assert(stack_size + internal_count <= kStackCapacity);
+        for (int i = 0; i < internal_count; ++i) {
+            stack[stack_size++] = internal[i];
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief BVH usada por Scene e Mesh, conforme PATHRENDER_BVH_WIDTH
+ */
+#if PATHRENDER_BVH_WIDTH == 2
+using AccelBVH = BVH;
+#elif PATHRENDER_BVH_WIDTH == 4 || PATHRENDER_BVH_WIDTH == 8
+using AccelBVH = WideBVH<PATHRENDER_BVH_WIDTH>;
+#else
+#error "PATHRENDER_BVH_WIDTH deve ser 2, 4 ou 8"
+#endif
+
+} // namespace PathRender
+
+#endif // PATHRENDER_WIDE_BVH_HPP_
@@ -11,12 +11,25 @@ public:
     // nu: roughness in Tangent direction (0 = sharp, 1 = rough)
     // nv: roughness in Bitangent direction
     AnisotropicMatteBRDF(const Color& col, float nu_val, float nv_val)
-        : BRDF(col, 0.0f, 1.0f, 0.0f, 0.0f), nu(nu_val), nv(nv_val) {}
+        : BRDF(col, 0.0f, 1.0f, 0.0f, 0.0f, BRDFType::AnisotropicMatte), nu(nu_val), nv(nv_val) {}
 
-    bool scatter(const Ray& r_in, const HitRecord& hit, ScatterRecord& srec, std::mt19937& rng) const override;
+    /**
+     * O lobo é montado em torno de reflect(-wo), numa base tirada dele: não é recíproco.
+     * Em TransportMode::Importance parte das amostras usa densidade cosseno, que cobre
+     * as direções com f > 0 que o lobo em torno de reflect(-wi) não alcança.
+     */
+    bool sample(const HitRecord& hit, const Vector3& wo, Sampler& sampler, ScatterRecord& srec,
+                TransportMode mode = TransportMode::Radiance) const override;
+    /// Parte contínua do lobo (as amostras que cairiam abaixo da superfície viram a reflexão perfeita, delta)
+    Color eval(const HitRecord& hit, const Vector3& wo, const Vector3& wi) const override;
+    float pdf(const HitRecord& hit, const Vector3& wo, const Vector3& wi,
+              TransportMode mode = TransportMode::Radiance) const override;
     static Vector3 reflect(const Vector3& v, const Vector3& n);
 
 private:
+    /// Densidade do lobo em torno de reflect(-wo)
+    float lobe_pdf(const HitRecord& hit, const Vector3& wo, const Vector3& wi) const;
+
     float nu, nv; // The two roughness values
 };
  
@@ -5,20 +5,84 @@
 #include "PathRender/core/ScatterRecord.hpp"
 #include "PathRender/core/color.hpp"
 #include "PathRender/core/ray.hpp"
-#include <random>
+#include "PathRender/core/sampler.hpp"
 
 namespace PathRender {
 
+/**
+ * @brief Tipo concreto de um BRDF, para agrupar amostras por material sem despacho virtual
+ */
+enum class BRDFType {
+    Phong,
+    Dielectric,
+    AnisotropicMatte,
+    Other  ///< Implementações externas: apenas via sample() virtual
+};
+
+/**
+ * @brief Lado de onde um caminho é construído
+ */
+enum class TransportMode {
+    Radiance,   ///< Da câmera: @p wo aponta para o observador
+    Importance  ///< Da luz (subcaminhos de luz do BDPT): @p wo aponta para a luz
+};
+
 class BRDF {    
 public:
-    BRDF(const Color& col, float diffuse, float specular, float transmissive, float shininess)
-        : color(col), kd(diffuse), ks(specular), kt(transmissive), n(shininess) {}
+    BRDF(const Color& col, float diffuse, float specular, float transmissive, float shininess,
+         BRDFType brdf_type = BRDFType::Other)
+        : color(col), kd(diffuse), ks(specular), kt(transmissive), n(shininess), type(brdf_type) {}
     virtual ~BRDF() = default;
 
     Color color;
     float kd, ks, kt, n;
+    BRDFType type;
+
+    /**
+     * @brief Amostra a direção de saída do caminho a partir de @p wo (normalizada, do ponto para o observador)
+     *
+     * Preenche out_ray, attenuation com o peso da amostra (f_r cos / pdf) e pdf com a
+     * densidade da direção escolhida (0 para lobos delta, como reflexão e refração
+     * especulares). Usa até Sampler::kBRDFDimension + 4 dimensões: a escolha do lobo
+     * e um par 2D para a direção.
+     *
+     * Com TransportMode::Importance o caminho leva fluxo: a amostragem cobre todas as
+     * direções em que f_r(wi, wo) > 0, mesmo em BRDFs não recíprocos, pdf é a de
+     * pdf() no mesmo modo e attenuation passa a ser f_r(wi, wo) |cos wi| / pdf.
+     * @return false se o caminho é absorvido
+     */
+    virtual bool sample(const HitRecord& rec, const Vector3& wo, Sampler& sampler, ScatterRecord& srec,
+                        TransportMode mode = TransportMode::Radiance) const = 0;
+
+    /**
+     * @brief sample() para o raio @p r_in que atingiu a superfície
+     */
+    bool scatter(const Ray& r_in, const HitRecord& rec, ScatterRecord& srec, Sampler& sampler) const {
+        return sample(rec, -r_in.direction.normalized(), sampler, srec);
+    }
+
+    /**
+     * @brief Valor do BRDF (f_r) para luz chegando por @p wi e saindo por @p wo (ambos partindo do ponto)
+     *
+     * Inclui apenas os lobos com densidade conhecida (os que preenchem ScatterRecord::pdf),
+     * que a amostragem de luz cobre; lobos delta retornam preto e só são alcançados
+     * pelo sample().
+     */
+    virtual Color eval(const HitRecord& /*rec*/, const Vector3& /*wo*/, const Vector3& /*wi*/) const {
+        return Color(0.0, 0.0, 0.0);
+    }
 
-    virtual bool scatter(const Ray& r_in, const HitRecord& rec, ScatterRecord& srec, std::mt19937& rng) const = 0;
+    /**
+     * @brief Densidade (ângulo sólido) com que sample() escolheria @p wi, sobre os mesmos
+     *        lobos de eval() e incluindo a probabilidade de escolher o lobo
+     *
+     * É o valor que sample() grava em ScatterRecord::pdf no mesmo @p mode; usado nos
+     * pesos de MIS.
+     */
+    virtual float pdf(const HitRecord& /*rec*/, const Vector3& /*wo*/, const Vector3& /*wi*/,
+                      TransportMode /*mode*/ = TransportMode::Radiance) const {
+        return 0.0f;
+    }
 };
  
 } // namespace PathRender
@@ -9,9 +9,31 @@ class DielectricBRDF : public BRDF {
 public:
     // ref_idx is the Index of Refraction (1.5 for glass, 2.4 for diamond)
     DielectricBRDF(const Color& col, float ref_idx) 
-        : BRDF(col, 0.3f, 0.0f, 0.7f, 0.0f), ir(ref_idx) {}
+        : BRDF(col, 0.3f, 0.0f, 0.7f, 0.0f, BRDFType::Dielectric), ir(ref_idx) {}
 
-    bool scatter(const Ray& r_in, const HitRecord& hit, ScatterRecord& srec, std::mt19937& rng) const override;
+    /// Em TransportMode::Importance as refrações já levam o fator de flux_scale()
+    bool sample(const HitRecord& hit, const Vector3& wo, Sampler& sampler, ScatterRecord& srec,
+                TransportMode mode = TransportMode::Radiance) const override;
+    /// Lobo difuso (escolhido com probabilidade kd / total no sample)
+    Color eval(const HitRecord& hit, const Vector3& wo, const Vector3& wi) const override;
+    float pdf(const HitRecord& hit, const Vector3& wo, const Vector3& wi,
+              TransportMode mode = TransportMode::Radiance) const override;
+
+    /// Razão dos índices de refração (lado de @p hit / lado oposto) em uma refração
+    float refraction_ratio(const HitRecord& hit) const { return hit.front_face ? (1.0f / ir) : ir; }
+
+    /**
+     * @brief Fator de fluxo de uma amostra de sample(): (eta_i / eta_t)^2 se @p srec refratou, senão 1
+     *
+     * Os caminhos de câmera levam a radiância pelas refrações sem escala; em fluxo isso
+     * é um fator (eta_i / eta_t)^2 por travessia, que fótons e subcaminhos de luz
+     * aplicam para se encontrar com eles dentro do vidro.
+     */
+    float flux_scale(const HitRecord& hit, const ScatterRecord& srec) const {
+        const bool refracted = srec.pdf == 0.0f && srec.out_ray.direction.dot(hit.normal) < 0.0f;
+        const float eta = refraction_ratio(hit);
+        return refracted ? eta * eta : 1.0f;
+    }
 
 private:
     float ir; // Index of Refraction
@@ -20,7 +42,6 @@ private:
     static float reflectance(float cosine, float ref_idx);
     static Vector3 refract(const Vector3& uv, const Vector3& n, float etai_over_etat);
     static Vector3 reflect(const Vector3& v, const Vector3& n);
-    Vector3 random_unit_vector(std::mt19937& rng) const;
 };
  
 } // namespace PathRender
@@ -3,7 +3,8 @@
 
 #include "PathRender/core/point.hpp"
 #include "PathRender/core/ray.hpp"
-#include <memory>
+#include <cstdint>
+
 namespace PathRender {
 
 class Object;
@@ -11,12 +12,20 @@ class Object;
 /**
  * @struct HitRecord
  * @brief Armazena informações sobre uma interseção entre um raio e um objeto
+ *
+ * Durante a busca pela interseção mais próxima só t, primitive_index e as
+ * coordenadas baricêntricas (u, v) são preenchidos. O ponto, a normal e o
+ * objeto são resolvidos uma única vez por Scene::intersect para o hit final.
+ * O objeto é referenciado sem posse (nenhuma alocação ou refcount por hit).
  */
 struct HitRecord {
     float t;              // Parâmetro t do raio onde ocorreu a interseção
     Point3 point;         // Ponto de interseção no espaço 3D
     Vector3 normal;       // Normal da superfície no ponto de interseção
-    std::shared_ptr<Object> object; // Ponteiro para o objeto atingido
+    const Object* object = nullptr;  // Objeto atingido (não possui o objeto)
+    uint32_t object_index = 0;       // Índice do objeto na cena
+    uint32_t primitive_index = 0;    // Primitivo dentro do objeto (ex.: triângulo da malha)
+    float u = 0.0f, v = 0.0f;        // Coordenadas baricêntricas no primitivo
     bool front_face;      // True se o raio atingiu a face frontal
     
     /**
@@ -7,12 +7,23 @@ namespace PathRender {
 
 class PhongBRDF : public BRDF {    
 public:
-    PhongBRDF(const Color& col) : BRDF(col, 0.7f, 0.0f, 0.0f, 5.0f) {}
+    PhongBRDF(const Color& col) : BRDF(col, 0.7f, 0.0f, 0.0f, 5.0f, BRDFType::Phong) {}
 
-    bool scatter(const Ray& r_in, const HitRecord& hit, ScatterRecord& srec, std::mt19937& rng) const override;
+    /// Lobo difuso (kd) com amostragem por cosseno ou reflexão borrada (ks), com peso sempre igual à cor
+    bool sample(const HitRecord& hit, const Vector3& wo, Sampler& sampler, ScatterRecord& srec,
+                TransportMode mode = TransportMode::Radiance) const override;
+    /// Os dois lobos: f_r = cor x pdf / cos, pois o peso de cada amostra é a cor
+    Color eval(const HitRecord& hit, const Vector3& wo, const Vector3& wi) const override;
+    /// Os dois lobos têm suporte simétrico em wo e wi: a mesma densidade nos dois modos
+    float pdf(const HitRecord& hit, const Vector3& wo, const Vector3& wi,
+              TransportMode mode = TransportMode::Radiance) const override;
     Vector3 reflect(const Vector3& v, const Vector3& n) const;
-    double random(std::mt19937& rng) const;
-    Vector3 random_unit_vector(std::mt19937& rng) const;
+    double random(Sampler& sampler) const;
+    Vector3 random_unit_vector(Sampler& sampler) const;
+
+private:
+    /// Raio da esfera somada à reflexão perfeita, a partir do expoente n
+    float fuzz() const;
 };
  
 } // namespace PathRender
@@ -4,13 +4,13 @@
 #include "PathRender/core/HitRecord.hpp"
 #include "PathRender/core/color.hpp"
 #include "PathRender/core/ray.hpp"
-#include <random>
 
 namespace PathRender {
 
 struct ScatterRecord {
     Ray out_ray;        // Raio espalhado
-    Color attenuation;   // Atenuação da cor
+    Color attenuation;   // Peso da amostra: f_r cos / pdf
+    float pdf = 0.0f;    // Densidade (ângulo sólido) da direção amostrada; 0 para lobos delta ou densidade desconhecida
 };
  
 } // namespace PathRender
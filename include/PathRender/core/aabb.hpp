@@ -0,0 +1,123 @@
+#ifndef PATHRENDER_AABB_HPP_
+#define PATHRENDER_AABB_HPP_
+
+#include "PathRender/core/point.hpp"
+#include "PathRender/core/ray.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace PathRender {
+
+/**
+ * @class AABB
+ * @brief Caixa delimitadora alinhada aos eixos (axis-aligned bounding box)
+ *
+ * Uma caixa vazia tem min = +inf e max = -inf, de modo que expandir
+ * com qualquer ponto produz uma caixa válida.
+ */
+class AABB {
+public:
+    Point3 min;
+    Point3 max;
+
+    AABB()
+        : min(std::numeric_limits<float>::infinity(),
+              std::numeric_limits<float>::infinity(),
+              std::numeric_limits<float>::infinity()),
+          max(-std::numeric_limits<float>::infinity(),
+              -std::numeric_limits<float>::infinity(),
+              -std::numeric_limits<float>::infinity()) {}
+
+    AABB(const Point3& a, const Point3& b)
+        : min(std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)),
+          max(std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)) {}
+
+    /**
+     * @brief Caixa que cobre todo o espaço (usada por objetos ilimitados, como planos)
+     */
+    static AABB infinite() {
+        const float inf = std::numeric_limits<float>::infinity();
+        return AABB(Point3(-inf, -inf, -inf), Point3(inf, inf, inf));
+    }
+
+    void expand(const Point3& p) {
+        min = Point3(std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z));
+        max = Point3(std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z));
+    }
+
+    void expand(const AABB& box) {
+        min = Point3(std::min(min.x, box.min.x), std::min(min.y, box.min.y), std::min(min.z, box.min.z));
+        max = Point3(std::max(max.x, box.max.x), std::max(max.y, box.max.y), std::max(max.z, box.max.z));
+    }
+
+    bool is_empty() const {
+        return min.x > max.x || min.y > max.y || min.z > max.z;
+    }
+
+    bool is_finite() const {
+        return std::isfinite(min.x) && std::isfinite(min.y) && std::isfinite(min.z) &&
+               std::isfinite(max.x) && std::isfinite(max.y) && std::isfinite(max.z);
+    }
+
+    Point3 centroid() const {
+        return Point3((min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f);
+    }
+
+    Vector3 extent() const {
+        return max - min;
+    }
+
+    float surface_area() const {
+        if (is_empty()) {
+            return 0.0f;
+        }
+        Vector3 d = extent();
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    /**
+     * @brief Índice do maior eixo (0 = x, 1 = y, 2 = z)
+     */
+    int longest_axis() const {
+        Vector3 d = extent();
+        if (d.x > d.y && d.x > d.z) return 0;
+        return d.y > d.z ? 1 : 2;
+    }
+
+    /**
+     * @brief Teste de slabs entre raio e caixa
+     * @param ray O raio a testar
+     * @param inv_dir Inverso componente a componente da direção do raio
+     * @param t_min Distância mínima válida
+     * @param t_max Distância máxima válida
+     * @param t_entry Distância de entrada na caixa (se houver interseção)
+     */
+    bool intersect(const Ray& ray, const Vector3& inv_dir, float t_min, float t_max, float& t_entry) const {
+        float tx1 = (min.x - ray.origin.x) * inv_dir.x;
+        float tx2 = (max.x - ray.origin.x) * inv_dir.x;
+        t_min = std::max(t_min, std::min(tx1, tx2));
+        t_max = std::min(t_max, std::max(tx1, tx2));
+
+        float ty1 = (min.y - ray.origin.y) * inv_dir.y;
+        float ty2 = (max.y - ray.origin.y) * inv_dir.y;
+        t_min = std::max(t_min, std::min(ty1, ty2));
+        t_max = std::min(t_max, std::max(ty1, ty2));
+
+        float tz1 = (min.z - ray.origin.z) * inv_dir.z;
+        float tz2 = (max.z - ray.origin.z) * inv_dir.z;
+        t_min = std::max(t_min, std::min(tz1, tz2));
+        t_max = std::min(t_max, std::max(tz1, tz2));
+
+        t_entry = t_min;
+        return t_min <= t_max;
+    }
+
+    static float axis(const Point3& p, int a) {
+        return a == 0 ? p.x : (a == 1 ? p.y : p.z);
+    }
+};
+
+} // namespace PathRender
+
+#endif // PATHRENDER_AABB_HPP_
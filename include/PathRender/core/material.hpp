@@ -12,7 +12,7 @@ public:
     Material() = default;
     Material(bool light, std::shared_ptr<BRDF> brdf_ptr) : is_light(light), brdf(std::move(brdf_ptr)) {}
 
-    bool is_light;
+    bool is_light = false;
     std::shared_ptr<BRDF> brdf;   
 };
  
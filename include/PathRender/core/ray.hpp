@@ -20,14 +20,14 @@ public:
     
     // Construtores
     Ray() = default;
-    Ray(const Point3& origin, const Vector3& direction);
+    Ray(const Point3& origin, const Vector3& direction) : origin(origin), direction(direction) {}
     
     /**
      * @brief Retorna um ponto ao longo do raio
      * @param t Parâmetro do raio (distância)
      * @return Ponto P(t) = origem + t * direção
      */
-    Point3 at(float t) const;
+    Point3 at(float t) const { return origin + direction * t; }
 
     std::string to_string() const;
 };
@@ -0,0 +1,188 @@
+#ifndef PATHRENDER_SAMPLER_HPP_
+#define PATHRENDER_SAMPLER_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace PathRender {
+
+/**
+ * @class Sampler
+ * @brief Fonte dos números aleatórios de um caminho, endereçados por (pixel, amostra, dimensão)
+ *
+ * Cada valor depende apenas da semente do render, do pixel, do índice da amostra
+ * no pixel e da dimensão: a imagem é idêntica bit a bit independentemente de
+ * quantas threads (ou máquinas) dividem o trabalho e da ordem dos tiles.
+ *
+ * Layout das dimensões: 0 e 1 são o jitter do pixel na câmera; o rebote b usa
+ * kBounceDimensions dimensões a partir de bounce_dimension(b): a roleta russa
+ * (kRouletteDimension), o BRDF (kBRDFDimension, até 4 dimensões) e a amostragem
+ * de luz (kLightDimension: escolha da luz e ponto na luz). Os samplers
+ * estratificados tratam as dimensões (2k, 2k + 1) como um par 2D: o jitter da
+ * câmera, as duas dimensões de direção de cada BRDF e o ponto na luz caem
+ * sempre no mesmo par.
+ */
+class Sampler {
+public:
+    /// Dimensões da câmera (jitter do pixel)
+    static constexpr uint32_t kCameraDimensions = 2;
+    /// Dimensões reservadas por rebote (roleta russa, BRDF e luz)
+    static constexpr uint32_t kBounceDimensions = 8;
+    /// Posição das dimensões de cada etapa dentro de um rebote
+    static constexpr uint32_t kRouletteDimension = 0;
+    static constexpr uint32_t kBRDFDimension = 1;
+    static constexpr uint32_t kLightDimension = 5;
+
+    explicit Sampler(uint32_t seed = 0) : m_seed(seed) {}
+    virtual ~Sampler() = default;
+
+    /**
+     * @brief Começa a amostra @p sample_index do pixel @p pixel_index, na dimensão 0
+     */
+    void start_pixel_sample(uint32_t pixel_index, uint32_t sample_index) {
+        m_pixel = pixel_index;
+        m_sample = sample_index;
+        m_dimension = 0;
+    }
+
+    /**
+     * @brief Posiciona o sampler na dimensão @p offset do rebote @p bounce
+     */
+    void start_bounce(int bounce, uint32_t offset = kRouletteDimension) {
+        m_dimension = bounce_dimension(bounce) + offset;
+    }
+
+    static uint32_t bounce_dimension(int bounce) {
+        return kCameraDimensions + static_cast<uint32_t>(bounce) * kBounceDimensions;
+    }
+
+    uint32_t seed() const { return m_seed; }
+    uint32_t dimension() const { return m_dimension; }
+
+    /// Pula @p count dimensões sem gerar valores (ex.: a escolha de lobo de um BRDF de lobo único)
+    void skip(uint32_t count) { m_dimension += count; }
+
+    /// Próximo valor em [0, 1), avançando uma dimensão
+    virtual float get_1d() = 0;
+
+    /// Finalizador do SplitMix64: bijetivo, com bom efeito avalanche
+    static uint64_t mix64(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+protected:
+    /// Hash de 64 bits de (semente, pixel, amostra, @p dimension)
+    uint64_t hash(uint32_t dimension) const {
+        const uint64_t key = (static_cast<uint64_t>(m_pixel) << 32) | m_sample;
+        const uint64_t stream = (static_cast<uint64_t>(m_seed) << 32) | dimension;
+        return mix64(key ^ mix64(stream));
+    }
+
+    /// Valor independente em [0, 1) para @p dimension da amostra atual
+    float uniform(uint32_t dimension) const {
+        // Top 24 bits -> float in [0, 1) without rounding up to 1
+        return static_cast<float>(hash(dimension) >> 40) * (1.0f / 16777216.0f);
+    }
+
+    uint32_t m_seed;
+    uint32_t m_pixel = 0;
+    uint32_t m_sample = 0;
+    uint32_t m_dimension = 0;
+};
+
+/**
+ * @class IndependentSampler
+ * @brief Números independentes de um gerador baseado em contador (hash de 64 bits)
+ *
+ * Não há estado de gerador: cada valor é o hash de (semente, pixel, amostra,
+ * dimensão), então o sampler ocupa poucos bytes e pode ser recriado em qualquer
+ * ponto do caminho (ex.: a cada estágio do WavefrontPathTracer).
+ */
+class IndependentSampler final : public Sampler {
+public:
+    explicit IndependentSampler(uint32_t seed = 0) : Sampler(seed) {}
+
+    float get_1d() override { return uniform(m_dimension++); }
+};
+
+/**
+ * @class StratifiedSampler
+ * @brief Jitter estratificado em 2D: cada par de dimensões divide [0,1)² em uma grade m x m
+ *
+ * m = floor(sqrt(spp)); as amostras de um pixel percorrem as células em uma
+ * permutação própria de (pixel, par), com jitter independente dentro de cada
+ * célula. Amostras além de m² começam uma nova rodada da grade.
+ */
+class StratifiedSampler final : public Sampler {
+public:
+    StratifiedSampler(uint32_t seed, int samples_per_pixel);
+
+    float get_1d() override;
+
+private:
+    uint32_t m_grid;  ///< Células por eixo da grade (m)
+};
+
+/**
+ * @class HaltonSampler
+ * @brief Sequência de Halton por pixel, com embaralhamento de Owen dos dígitos
+ *
+ * A dimensão d usa o d-ésimo primo como base; a permutação dos dígitos depende
+ * de (semente, pixel, dimensão), o que descorrelaciona pixels vizinhos. Acima de
+ * kMaxDimensions (rebotes profundos) os valores passam a ser independentes.
+ */
+class HaltonSampler final : public Sampler {
+public:
+    static constexpr uint32_t kMaxDimensions = 64;
+
+    explicit HaltonSampler(uint32_t seed = 0) : Sampler(seed) {}
+
+    float get_1d() override;
+};
+
+/**
+ * @class SobolSampler
+ * @brief Sobol 2D com embaralhamento de Owen, "acolchoado" por pares de dimensões
+ *
+ * Cada par (2k, 2k + 1) usa as duas primeiras dimensões de Sobol, que formam uma
+ * (0, 2)-sequência. O índice da amostra é embaralhado por par (Burley 2020,
+ * "Practical Hash-based Owen Scrambling") para descorrelacionar os pares entre si.
+ */
+class SobolSampler final : public Sampler {
+public:
+    explicit SobolSampler(uint32_t seed = 0) : Sampler(seed) {}
+
+    float get_1d() override;
+};
+
+/**
+ * @brief Família de samplers selecionável por render
+ */
+enum class SamplerType {
+    Independent,
+    Stratified,
+    Halton,
+    Sobol
+};
+
+/**
+ * @brief Cria um sampler do tipo pedido
+ * @param samples_per_pixel Amostras máximas por pixel (usado pelo StratifiedSampler)
+ */
+std::unique_ptr<Sampler> make_sampler(SamplerType type, uint32_t seed, int samples_per_pixel);
+
+const char* sampler_type_name(SamplerType type);
+
+/**
+ * @brief Converte "independent", "stratified", "halton" ou "sobol" em SamplerType
+ * @return false se o nome não é reconhecido
+ */
+bool parse_sampler_type(const std::string& name, SamplerType& type);
+
+} // namespace PathRender
+
+#endif // PATHRENDER_SAMPLER_HPP_
@@ -15,42 +15,74 @@ public:
     float x, y, z;
     
     // Construtores
-    Vector3();
-    Vector3(float x, float y, float z);
+    Vector3() : x(0), y(0), z(0) {}
+    Vector3(float x, float y, float z) : x(x), y(y), z(z) {}
     
-    // Operadores aritméticos
-    Vector3 operator+(const Vector3& v) const;
+    // Operadores aritméticos (inline: usados em todos os laços de interseção)
+    Vector3 operator+(const Vector3& v) const { return Vector3(x + v.x, y + v.y, z + v.z); }
     
-    Vector3 operator-(const Vector3& v) const;
+    Vector3 operator-(const Vector3& v) const { return Vector3(x - v.x, y - v.y, z - v.z); }
     
-    Vector3 operator*(float scalar) const;
+    Vector3 operator*(float scalar) const { return Vector3(x * scalar, y * scalar, z * scalar); }
     
-    Vector3 operator/(float scalar) const;
+    Vector3 operator/(float scalar) const { return Vector3(x / scalar, y / scalar, z / scalar); }
     
-    Vector3 operator-() const;
+    Vector3 operator-() const { return Vector3(-x, -y, -z); }
     
     // Operadores de atribuição
-    Vector3& operator+=(const Vector3& v);
+    Vector3& operator+=(const Vector3& v) {
+        x += v.x;
+        y += v.y;
+        z += v.z;
+        return *this;
+    }
     
-    Vector3& operator*=(float scalar);
+    Vector3& operator*=(float scalar) {
+        x *= scalar;
+        y *= scalar;
+        z *= scalar;
+        return *this;
+    }
     
-    Vector3& operator/=(float scalar);
+    Vector3& operator/=(float scalar) {
+        x /= scalar;
+        y /= scalar;
+        z /= scalar;
+        return *this;
+    }
     
     // Produto escalar (dot product)
-    float dot(const Vector3& v) const;
+    float dot(const Vector3& v) const { return x * v.x + y * v.y + z * v.z; }
     
     // Produto vetorial (cross product)
-    Vector3 cross(const Vector3& v) const;
+    Vector3 cross(const Vector3& v) const {
+        return Vector3(
+            y * v.z - z * v.y,
+            z * v.x - x * v.z,
+            x * v.y - y * v.x
+        );
+    }
     
     // Comprimento
-    float length() const;
+    float length() const { return std::sqrt(length_squared()); }
     
-    float length_squared() const;
+    float length_squared() const { return x * x + y * y + z * z; }
     
     // Normalização
-    Vector3 normalized() const;
+    Vector3 normalized() const {
+        float len = length();
+        if (len > 0) {
+            return *this / len;
+        }
+        return *this;
+    }
     
-    void normalize();
+    void normalize() {
+        float len = length();
+        if (len > 0) {
+            *this /= len;
+        }
+    }
 
     std::string to_string() const;
 };
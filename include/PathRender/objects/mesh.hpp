@@ -1,30 +1,72 @@
 #ifndef PATHRENDER_MESH_HPP_
 #define PATHRENDER_MESH_HPP_
 
+#include "PathRender/accel/wide_bvh.hpp"
 #include "PathRender/objects/objects.hpp"
 #include "PathRender/core/point.hpp"
 #include "PathRender/core/color.hpp"
 #include "PathRender/objects/triangle.hpp"
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <iostream>
 
 namespace PathRender {
 
+/**
+ * @class Mesh
+ * @brief Malha de triângulos indexada
+ *
+ * A geometria é guardada como um vetor de vértices compartilhado, um index
+ * buffer de 32 bits (3 índices por triângulo) e um índice de material por
+ * triângulo. As arestas de cada triângulo são pré-calculadas em TriangleSoA,
+ * que lê v0 do vetor de vértices da malha. O material 0 é o material da própria malha (set_material);
+ * materiais adicionais são registrados com add_material().
+ */
 class Mesh : public Object {
 public:
     Mesh() = default;
 
     bool intersect(const Ray& ray, float t_min, float t_max, HitRecord& hit) const override;
-    void add_triangle(const Triangle& triangle);
-    void add_vertex(const Point3& vertex);
-    
-    const std::vector<Triangle>& get_triangles() const;
+
+    void compute_surface(const Ray& ray, HitRecord& hit) const override;
+
+    bool occluded(const Ray& ray, float t_min, float t_max) const override;
+
+    bool is_emissive() const override;
+
+    /**
+     * @brief Adiciona um vértice e retorna seu índice
+     */
+    uint32_t add_vertex(const Point3& vertex);
+
+    /**
+     * @brief Adiciona um triângulo a partir de índices de vértices já adicionados
+     * @param material_index Material do triângulo (0 = material da malha)
+     * @throws std::out_of_range Se algum índice não é de um vértice; a malha fica inalterada
+     */
+    void add_triangle(uint32_t a, uint32_t b, uint32_t c, uint16_t material_index = 0);
+
+    /**
+     * @brief Registra um material adicional e retorna seu índice (>= 1)
+     */
+    uint16_t add_material(const Material& material);
+
+    const Material& get_primitive_material(uint32_t primitive_index) const override;
+
+    size_t triangle_count() const;
+    const std::vector<uint32_t>& get_indices() const;
     const std::vector<Point3>& get_vertices() const;
-    
+    const TriangleSoA& get_triangles() const;
+
+    /**
+     * @brief Bytes ocupados pela geometria, dados de interseção e BVH da malha
+     */
+    size_t memory_usage() const;
+
     void set_color(const Color& color);
     const Color& get_color() const override;
-    
+
     void set_name(std::string name);
     const std::string& get_name() const;
 
@@ -35,13 +77,32 @@ public:
     std::string to_string() const override;
 
     Point3 get_position() const override;
-    
+
+    AABB get_bounds() const override;
+
+    /**
+     * @brief Constrói a BVH de triângulos da malha (estrutura de baixo nível)
+     *
+     * Reordena os triângulos na ordem das folhas, com folhas dimensionadas para
+     * a largura SIMD atual (simd_width()). Malhas grandes registram no log o
+     * tempo de construção e o custo SAH. Pode ser chamada de novo
+     * depois de alterar a geometria sem afetar o resto da cena.
+     */
+    void build_acceleration() override;
+
 private:
+    static constexpr size_t kLoggedBuildSize = 100000;  // Meshes from this size on log their BVH build
+
     std::string m_name;
-    std::vector<Triangle> m_triangles;
     std::vector<Point3> m_vertices;
+    std::vector<uint32_t> m_indices;
+    std::vector<uint16_t> m_material_indices;
+    std::vector<Material> m_materials;  // Extra materials, index i is stored as i + 1
+    TriangleSoA m_triangles;
+    AccelBVH m_bvh;
+    std::vector<uint8_t> m_emissive_materials;  // is_light per material index, cached by build_acceleration()
 };
 
 } // namespace PathRender
 
-#endif // PATHRENDER_MESH_HPP_
\ No newline at end of file
+#endif // PATHRENDER_MESH_HPP_
@@ -2,6 +2,7 @@
 #define PATHRENDER_OBJECTS_HPP_
 
 #include "PathRender/core/HitRecord.hpp"
+#include "PathRender/core/aabb.hpp"
 #include "PathRender/core/ray.hpp"
 #include "PathRender/core/point.hpp"
 #include "PathRender/core/material.hpp"
@@ -21,6 +22,11 @@ public:
     
     /**
      * @brief Testa interseção entre um raio e o objeto
+     *
+     * Preenche apenas hit.t, hit.primitive_index e hit.u/hit.v, e só altera
+     * @p hit quando retorna true; o ponto e a normal são calculados depois por
+     * compute_surface() para o hit final.
+     *
      * @param ray O raio a testar
      * @param t_min Distância mínima válida ao longo do raio
      * @param t_max Distância máxima válida ao longo do raio
@@ -28,6 +34,31 @@ public:
      * @return true se houver interseção, false caso contrário
      */
     virtual bool intersect(const Ray& ray, float t_min, float t_max, HitRecord& hit) const = 0;
+
+    /**
+     * @brief Calcula ponto, normal e face de um hit retornado por intersect()
+     * @param ray O raio que gerou o hit
+     * @param hit Hit com t, primitive_index e u/v já preenchidos
+     */
+    virtual void compute_surface(const Ray& ray, HitRecord& hit) const = 0;
+
+    /**
+     * @brief Testa se algum primitivo não emissivo bloqueia o raio em (t_min, t_max)
+     *
+     * Consulta any-hit para raios de sombra: pode parar no primeiro bloqueio
+     * encontrado e não calcula ponto nem normal. Primitivos emissivos são ignorados.
+     */
+    virtual bool occluded(const Ray& ray, float t_min, float t_max) const {
+        HitRecord hit;
+        return !m_material.is_light && intersect(ray, t_min, t_max, hit);
+    }
+
+    /**
+     * @brief true se todos os primitivos do objeto são emissivos (nunca bloqueiam sombras)
+     */
+    virtual bool is_emissive() const {
+        return m_material.is_light;
+    }
     
     /**
      * @brief Retorna a cor do objeto
@@ -44,8 +75,30 @@ public:
         return m_material; 
     }
 
+    /**
+     * @brief Retorna o material de um primitivo (ex.: triângulo de uma malha)
+     */
+    virtual const Material& get_primitive_material(uint32_t /*primitive_index*/) const {
+        return m_material;
+    }
+
     virtual Point3 get_position() const = 0;
 
+    /**
+     * @brief Retorna a caixa delimitadora do objeto
+     *
+     * Objetos ilimitados (ex.: planos) retornam AABB::infinite() e são
+     * tratados fora da BVH da cena.
+     */
+    virtual AABB get_bounds() const = 0;
+
+    /**
+     * @brief Constrói estruturas de aceleração internas do objeto (ex.: BVH de uma malha)
+     *
+     * Chamado por Scene::finalize() antes da construção da BVH da cena.
+     */
+    virtual void build_acceleration() {}
+
 protected:
     Material m_material;
 };
@@ -29,6 +29,8 @@ public:
      * onde P = origem + t * direção
      */
     bool intersect(const Ray& ray, float t_min, float t_max, HitRecord& hit) const override;
+
+    void compute_surface(const Ray& ray, HitRecord& hit) const override;
     
     const Color& get_color() const override;
     
@@ -38,6 +40,8 @@ public:
     std::string to_string() const override;
 
     Point3 get_position() const override;
+
+    AABB get_bounds() const override;
     
 private:
     Point3 m_center;
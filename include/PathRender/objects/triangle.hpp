@@ -1,35 +1,124 @@
 #ifndef PATHRENDER_TRIANGLE_HPP_
 #define PATHRENDER_TRIANGLE_HPP_
 
-#include "PathRender/objects/objects.hpp"
+#include "PathRender/core/aabb.hpp"
 #include "PathRender/core/point.hpp"
+#include "PathRender/core/ray.hpp"
 #include "PathRender/core/vector.hpp"
-#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace PathRender {
 
-class Triangle : public Object {
+/**
+ * @class TriangleSoA
+ * @brief Dados pré-calculados de interseção dos triângulos de uma malha
+ *
+ * Cada componente fica em um vetor próprio (structure of arrays): as arestas
+ * e1 = v1 - v0 e e2 = v2 - v0, o índice de v0 no vetor de vértices da malha e
+ * a normal unitária, já normalizada para que cada interseção só a leia.
+ * Triângulos consecutivos ficam contíguos em memória, de modo que os laços
+ * sobre uma folha da BVH leem dados sequenciais e podem ser vetorizados. v0
+ * não é copiado (é lido do vetor de vértices compartilhado, passado a
+ * intersect()): 40 bytes por triângulo, contra 52 com v0 em floats.
+ *
+ * pad() acrescenta triângulos nulos (que nunca são atingidos) ao final dos
+ * vetores para que kernels SIMD possam ler blocos completos; size() não os conta.
+ */
+class TriangleSoA {
 public:
-    Triangle(const Point3& A, const Point3& B, const Point3& C, const Material& material);
+    std::vector<uint32_t> v0_index;
+    std::vector<float> e1_x, e1_y, e1_z;
+    std::vector<float> e2_x, e2_y, e2_z;
+    std::vector<float> n_x, n_y, n_z;  ///< Normal unitária (e1 x e2 normalizado)
 
-    bool intersect(const Ray& ray, float t_min, float t_max, HitRecord& hit) const override;
-    
-    const Color& get_color() const override { return m_material.brdf->color; }
+    size_t size() const { return m_size; }
 
-    std::string to_string() const override {
-        return "Triangle(A=" + std::to_string(m_vertices[0].x) + "," + std::to_string(m_vertices[0].y) + "," + std::to_string(m_vertices[0].z) +
-               ", B=" + std::to_string(m_vertices[1].x) + "," + std::to_string(m_vertices[1].y) + "," + std::to_string(m_vertices[1].z) +
-               ", C=" + std::to_string(m_vertices[2].x) + "," + std::to_string(m_vertices[2].y) + "," + std::to_string(m_vertices[2].z) + ")";
-    }
+    void clear();
+
+    /**
+     * @brief Acrescenta @p width - 1 triângulos nulos ao final dos vetores
+     *
+     * Depois disso, ler @p width triângulos a partir de qualquer índice válido
+     * não ultrapassa o fim dos vetores.
+     */
+    void pad(size_t width);
+
+    void reserve(size_t count);
+
+    /**
+     * @brief Acrescenta o triângulo (@p a, @p b, @p c) de @p vertices, pré-calculando as arestas
+     */
+    void push_back(const Point3* vertices, uint32_t a, uint32_t b, uint32_t c);
+
+    Point3 get_v0(const Point3* vertices, size_t i) const { return vertices[v0_index[i]]; }
+
+    /// Normal unitária (e1 x e2 normalizado), calculada em push_back()
+    Vector3 get_normal(size_t i) const { return Vector3(n_x[i], n_y[i], n_z[i]); }
+
+    /**
+     * @brief Bytes ocupados pelos vetores (capacidade reservada incluída)
+     */
+    size_t memory_usage() const;
+
+    /**
+     * @brief Interseção raio-triângulo (Möller–Trumbore) sobre os dados pré-calculados
+     * https://en.wikipedia.org/wiki/M%C3%B6ller%E2%80%93Trumbore_intersection_algorithm
+     *
+     * @param vertices Vetor de vértices em que v0_index indexa
+     * @param t, u, v Distância e coordenadas baricêntricas (só alterados se houver interseção)
+     */
+    bool intersect(size_t i, const Point3* vertices, const Ray& ray, float t_min, float t_max,
+                   float& t, float& u, float& v) const {
+        const float epsilon = t_min;
 
-    Vector3 get_normal() const;
+        // ray_cross_e2 = direction x e2
+        const float px = ray.direction.y * e2_z[i] - ray.direction.z * e2_y[i];
+        const float py = ray.direction.z * e2_x[i] - ray.direction.x * e2_z[i];
+        const float pz = ray.direction.x * e2_y[i] - ray.direction.y * e2_x[i];
+        const float det = e1_x[i] * px + e1_y[i] * py + e1_z[i] * pz;
+
+        if (det > -epsilon && det < epsilon) {
+            return false;    // This ray is parallel to this triangle.
+        }
+
+        const float inv_det = 1.0f / det;
+        const Point3& v0 = vertices[v0_index[i]];
+        const float sx = ray.origin.x - v0.x;
+        const float sy = ray.origin.y - v0.y;
+        const float sz = ray.origin.z - v0.z;
+        const float hit_u = inv_det * (sx * px + sy * py + sz * pz);
+
+        if ((hit_u < 0 && -hit_u > epsilon) || (hit_u > 1 && hit_u - 1 > epsilon)) {
+            return false;
+        }
+
+        // s_cross_e1 = s x e1
+        const float qx = sy * e1_z[i] - sz * e1_y[i];
+        const float qy = sz * e1_x[i] - sx * e1_z[i];
+        const float qz = sx * e1_y[i] - sy * e1_x[i];
+        const float hit_v = inv_det * (ray.direction.x * qx + ray.direction.y * qy + ray.direction.z * qz);
+
+        if ((hit_v < 0 && -hit_v > epsilon) || (hit_u + hit_v > 1 && hit_u + hit_v - 1 > epsilon)) {
+            return false;
+        }
+
+        // At this stage we can compute t to find out where the intersection point is on the line.
+        const float hit_t = inv_det * (e2_x[i] * qx + e2_y[i] * qy + e2_z[i] * qz);
+        if (hit_t > epsilon && hit_t < t_max) {
+            t = hit_t;
+            u = hit_u;
+            v = hit_v;
+            return true;
+        }
+        return false;
+    }
 
-    Point3 get_position() const override;
-    
 private:
-    std::array<Point3, 3> m_vertices;
+    size_t m_size = 0;
 };
 
 } // namespace PathRender
 
-#endif // PATHRENDER_TRIANGLE_HPP_
\ No newline at end of file
+#endif // PATHRENDER_TRIANGLE_HPP_
@@ -0,0 +1,89 @@
+#ifndef PATHRENDER_ACCUMULATION_BUFFER_HPP_
+#define PATHRENDER_ACCUMULATION_BUFFER_HPP_
+
+#include "PathRender/core/color.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace PathRender {
+
+/**
+ * @struct PixelAccumulator
+ * @brief Amostras de um pixel: soma da cor, média e variância da luminância e contagem
+ *
+ * A luminância é acumulada pelo algoritmo de Welford (média corrente e soma dos
+ * quadrados dos desvios, M2): com somas de float, sum(x^2) - média * sum(x) cancela
+ * catastroficamente quando a variância é pequena diante da média, e a variância
+ * de pixels com milhares de amostras chegava a zero ou ficava negativa.
+ */
+struct PixelAccumulator {
+    float sum[3] = {0.0f, 0.0f, 0.0f};
+    float luminance_mean = 0.0f;
+    float luminance_m2 = 0.0f;  ///< Soma de (x - média)^2 sobre as amostras
+    uint32_t samples = 0;
+
+    void add(const Color& sample);
+
+    /// Média das amostras (preto se o pixel ainda não tem amostras)
+    Color mean() const;
+
+    /// Variância amostral da luminância (0 com menos de 2 amostras)
+    float luminance_variance() const { return samples < 2 ? 0.0f : luminance_m2 / (samples - 1); }
+};
+
+/**
+ * @class AccumulationBuffer
+ * @brief Acumulação progressiva de amostras por pixel, salva e retomada de checkpoints
+ *
+ * Formato binário do checkpoint (little-endian em qualquer host, sem compressão):
+ *   "PRCK", uint32 versão, uint32 largura, uint32 altura, uint32 passes,
+ *   seguidos de largura * altura registros de 24 bytes: float sum[3],
+ *   float luminance_mean, float luminance_m2, uint32 samples (floats IEEE 754).
+ */
+class AccumulationBuffer {
+public:
+    AccumulationBuffer() = default;
+    AccumulationBuffer(int width, int height) { reset(width, height); }
+
+    /// Descarta as amostras e redimensiona
+    void reset(int width, int height);
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    size_t size() const { return m_pixels.size(); }
+    bool empty() const { return m_pixels.empty(); }
+
+    PixelAccumulator& operator[](size_t index) { return m_pixels[index]; }
+    const PixelAccumulator& operator[](size_t index) const { return m_pixels[index]; }
+
+    /// Passes de renderização já acumulados (usado para não repetir sementes ao retomar)
+    uint32_t passes() const { return m_passes; }
+    void set_passes(uint32_t passes) { m_passes = passes; }
+
+    uint64_t total_samples() const;
+
+    /**
+     * @brief Grava o checkpoint (em um arquivo temporário renomeado no fim, para
+     *        que uma interrupção durante a escrita não corrompa o checkpoint anterior)
+     * @return false se o arquivo não pôde ser escrito
+     */
+    bool save(const std::string& filename) const;
+
+    /**
+     * @brief Lê um checkpoint gravado por save()
+     * @throws std::runtime_error se o arquivo não existe ou não é um checkpoint válido
+     */
+    static AccumulationBuffer load(const std::string& filename);
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    uint32_t m_passes = 0;
+    std::vector<PixelAccumulator> m_pixels;
+};
+
+} // namespace PathRender
+
+#endif // PATHRENDER_ACCUMULATION_BUFFER_HPP_
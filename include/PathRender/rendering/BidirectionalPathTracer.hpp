@@ -0,0 +1,139 @@
+#ifndef PATHRENDER_BIDIRECTIONAL_PATHTRACER_HPP_
+#define PATHRENDER_BIDIRECTIONAL_PATHTRACER_HPP_
+
+#include "PathRender/core/HitRecord.hpp"
+#include "PathRender/core/sampler.hpp"
+#include "PathRender/rendering/IRenderAlgorithm.hpp"
+#include "PathRender/rendering/LightSampler.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace PathRender {
+
+/**
+ * @class BidirectionalPathTracer
+ * @brief Path tracing bidirecional (Veach 1997, cap. 10; Lafortune e Willems 1993)
+ *
+ * Cada amostra traça um subcaminho de câmera e um subcaminho de luz (emitido por
+ * LightSampler::sample_emission()) e conecta cada vértice de um a cada vértice do
+ * outro por um raio de sombra. Cada estratégia (s vértices de luz, t de câmera)
+ * estima os mesmos caminhos com densidades diferentes; os pesos de MIS
+ * (heurística da potência) vêm das densidades de área de cada vértice nos dois
+ * sentidos, guardadas durante os passeios aleatórios. s = 0 é o caminho de câmera
+ * atingindo uma luz e s = 1 a amostragem de luz do PathTracer; estratégias com
+ * s >= 2 encontram a luz que só chega por superfícies difusas indiretas (teto
+ * iluminado, cantos) com poucos rebotes do lado da câmera.
+ *
+ * Na estratégia t = 1 cada vértice do subcaminho de luz é conectado à câmera de
+ * furo (Camera::importance() e Camera::pdf()) e somado ao pixel em que se projeta,
+ * que em geral é de outro tile: cada thread acumula essas contribuições em sua
+ * própria imagem de luz, somadas às dos caminhos de câmera depois de todos os
+ * tiles. É a estratégia que encontra as cáusticas vistas diretamente (luz -> vidro
+ * -> difuso -> câmera), que do lado da câmera só s = 0 alcança. t = 1 com s = 1 (um
+ * ponto de luz visto pela câmera) não é usada: s = 0 já cobre a luz visível.
+ *
+ * Os subcaminhos de luz amostram os BRDFs com TransportMode::Importance, que cobre
+ * f > 0 também nos BRDFs não recíprocos, e os pesos de MIS usam a densidade desse
+ * modo sempre que avaliam um passo dado a partir da luz.
+ *
+ * Os vértices ficam em arrays pré-alocados por thread do pool, reaproveitados por
+ * todas as amostras: nenhuma alocação por amostra. A luz é sempre escolhida pela
+ * potência, nas conexões e na emissão, para que a densidade do vértice de luz seja
+ * a mesma nas estratégias s = 0, 1 e >= 2.
+ */
+class BidirectionalPathTracer : public IRenderAlgorithm {
+public:
+    BidirectionalPathTracer() = default;
+    void render(std::vector<Color>& buffer, const SceneConfig& config) override;
+
+    void set_samples_per_pixel(int samples) { m_samples_per_pixel = samples; }
+    int get_samples_per_pixel() const { return m_samples_per_pixel; }
+
+    /// Rebotes máximos de um caminho completo (câmera a luz)
+    void set_max_depth(int depth) { m_max_depth = depth; }
+    int get_max_depth() const { return m_max_depth; }
+
+    void set_seed(uint32_t seed) { m_seed = seed; }
+    uint32_t get_seed() const { return m_seed; }
+
+    void set_sampler_type(SamplerType type) { m_sampler_type = type; }
+    SamplerType get_sampler_type() const { return m_sampler_type; }
+
+private:
+    /// Vértice de um subcaminho
+    struct PathVertex {
+        HitRecord hit;                ///< Ponto e normal (do lado de onde o caminho chegou)
+        const BRDF* brdf = nullptr;   ///< nullptr: lente, ponto de luz ou superfície emissiva
+        Color beta;                   ///< Throughput do subcaminho até o vértice, sem o BRDF dele
+        Color emission;               ///< Radiância emitida (pontos de luz e superfícies emissivas)
+        Vector3 to_previous;          ///< Direção normalizada para o vértice anterior
+        float pdf_forward = 0.0f;     ///< Densidade de área com que o próprio subcaminho gerou o vértice
+        float pdf_reverse = 0.0f;     ///< Densidade de área com que o outro subcaminho o geraria
+        float pdf_emission = 0.0f;    ///< Luz de s = 1 ou lente de t = 1: densidade (ângulo sólido) da conexão
+        bool delta = false;           ///< O caminho saiu do vértice por um lobo delta
+        bool is_light = false;
+    };
+
+    /// Memória de trabalho de uma thread, alocada uma vez por render
+    struct Workspace {
+        std::vector<PathVertex> camera;
+        std::vector<PathVertex> light;
+        std::unique_ptr<Sampler> camera_sampler;
+        std::unique_ptr<Sampler> light_sampler;
+        std::vector<Color> light_image;  ///< Soma das contribuições de t = 1, na ordem da imagem
+    };
+
+    /// Soma das estratégias com t >= 2 para a amostra @p sample do pixel (@p i, @p j); t = 1 vai para light_image
+    Color trace_sample(const SceneConfig& config, int i, int j, uint32_t sample, Workspace& workspace) const;
+
+    /**
+     * @brief Estende @p path a partir do vértice @p count - 1 pelo raio @p ray, amostrado
+     *        com densidade @p pdf (ângulo sólido, 0 = delta)
+     * @param bounce_offset Rebote do Sampler usado pelo primeiro vértice novo
+     * @param light_path Subcaminho de luz: transporta potência (BRDF com wo e wi trocados)
+     * @return Número de vértices do subcaminho
+     */
+    int random_walk(const Scene& scene, Ray ray, Color beta, float pdf, Sampler& sampler, int bounce_offset,
+                    bool light_path, PathVertex* path, int count, int max_count) const;
+
+    /// Contribuição da estratégia (s, t), sem o peso de MIS; @p sampled é o ponto de luz quando s = 1
+    Color connect(const Scene& scene, const PathVertex* light, int s, const PathVertex* camera, int t,
+                  PathVertex& sampled, Sampler& sampler) const;
+
+    /**
+     * @brief Contribuição da estratégia (s, t = 1), sem o peso de MIS: o vértice s - 1 da luz
+     *        visto pela lente
+     * @param sampled Recebe a lente, com a densidade da câmera na direção do vértice
+     * @param pixel Recebe o índice do pixel atingido, na ordem da imagem
+     */
+    Color connect_camera(const SceneConfig& config, const PathVertex* light, int s, const PathVertex& lens,
+                         PathVertex& sampled, size_t& pixel) const;
+
+    /// Peso de MIS da estratégia (s, t); quando t = 1, @p sampled é a lente
+    float mis_weight(const PathVertex* light, int s, const PathVertex* camera, int t,
+                     const PathVertex& sampled) const;
+
+    /// Densidade de área em @p to de uma direção amostrada em @p from com densidade @p pdf
+    static float area_density(float pdf, const PathVertex& from, const PathVertex& to);
+
+    /**
+     * @brief Área do filme em unidades de (u, v) de Camera::get_ray(): o pixel i cobre
+     *        u em [i, i + 1) / (largura - 1), então a imagem vai um pixel além de [0, 1]^2
+     */
+    static float film_area(int width, int height);
+
+    static constexpr int kTileSize = 16;
+    static constexpr int kRouletteMinDepth = 3;
+
+    int m_samples_per_pixel = 64;
+    int m_max_depth = 32;
+    uint32_t m_seed = 0;
+    SamplerType m_sampler_type = SamplerType::Sobol;
+
+    LightSampler m_lights{LightSelection::Power};
+};
+
+} // namespace PathRender
+
+#endif // PATHRENDER_BIDIRECTIONAL_PATHTRACER_HPP_
@@ -0,0 +1,67 @@
+#ifndef PATHRENDER_DENOISER_HPP_
+#define PATHRENDER_DENOISER_HPP_
+
+#include "PathRender/rendering/FrameBuffer.hpp"
+
+namespace PathRender {
+
+/**
+ * @class Denoiser
+ * @brief Filtro à-trous com bordas preservadas (Dammertz et al. 2010, "Edge-Avoiding
+ *        À-Trous Wavelet Transform for fast Global Illumination Filtering")
+ *
+ * Cada iteração aplica o núcleo 5x5 do B3-spline com passo 2^i, então 5
+ * iterações cobrem uma janela de 125 pixels com 25 leituras por pixel. O peso de
+ * cada vizinho é reduzido pelas diferenças de normal, profundidade e albedo do
+ * primeiro hit e de luminância; esta última é escalada pelo desvio padrão
+ * estimado do pixel, propagado entre as iterações como no SVGF (Schied et al.
+ * 2017), então regiões já convergidas quase não são filtradas. A iluminação é
+ * filtrada dividida pelo albedo e multiplicada de volta no fim, para que texturas
+ * e bordas entre materiais não sejam borradas. Cada iteração é dividida em tiles
+ * executados no ThreadPool global.
+ */
+class Denoiser {
+public:
+    /// Iterações do filtro (passos 1, 2, 4, ...)
+    void set_iterations(int iterations) { m_iterations = iterations; }
+    int get_iterations() const { return m_iterations; }
+
+    /// Diferença de luminância tolerada, em desvios padrão do pixel
+    void set_sigma_luminance(float sigma) { m_sigma_luminance = sigma; }
+    float get_sigma_luminance() const { return m_sigma_luminance; }
+
+    /// Expoente do cosseno entre normais (maior = mais rígido nas quinas)
+    void set_sigma_normal(float sigma) { m_sigma_normal = sigma; }
+    float get_sigma_normal() const { return m_sigma_normal; }
+
+    /// Diferença de profundidade tolerada, relativa à prevista pelo gradiente local
+    void set_sigma_depth(float sigma) { m_sigma_depth = sigma; }
+    float get_sigma_depth() const { return m_sigma_depth; }
+
+    /// Diferença de albedo tolerada
+    void set_sigma_albedo(float sigma) { m_sigma_albedo = sigma; }
+    float get_sigma_albedo() const { return m_sigma_albedo; }
+
+    /**
+     * @brief Filtra os canais de cor ("R", "G", "B") de @p frame no lugar
+     *
+     * Usa os canais de cobertura, albedo, normal, profundidade e variância
+     * (Channels); pixels com cobertura abaixo de 1/2 (fundo, luzes) não mudam.
+     * @throws std::out_of_range se algum desses canais não existe
+     */
+    void denoise(FrameBuffer& frame) const;
+
+private:
+    /// Lado (em pixels) dos tiles distribuídos entre as threads
+    static constexpr int kTileSize = 32;
+
+    int m_iterations = 5;
+    float m_sigma_luminance = 4.0f;
+    float m_sigma_normal = 128.0f;
+    float m_sigma_depth = 1.0f;
+    float m_sigma_albedo = 0.1f;
+};
+
+} // namespace PathRender
+
+#endif // PATHRENDER_DENOISER_HPP_
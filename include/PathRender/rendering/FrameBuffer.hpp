@@ -0,0 +1,109 @@
+#ifndef PATHRENDER_FRAME_BUFFER_HPP_
+#define PATHRENDER_FRAME_BUFFER_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace PathRender {
+
+/**
+ * @brief Nomes dos canais que o PathTracer preenche e o Denoiser lê
+ */
+namespace Channels {
+constexpr const char* kRed = "R";            ///< Radiância linear média
+constexpr const char* kGreen = "G";
+constexpr const char* kBlue = "B";
+constexpr const char* kCoverage = "A";       ///< Fração das amostras do render que atingiram uma superfície não emissiva
+constexpr const char* kAlbedo[3] = {"albedo.R", "albedo.G", "albedo.B"};  ///< Cor do material no primeiro hit
+constexpr const char* kNormal[3] = {"N.X", "N.Y", "N.Z"};  ///< Normal média no primeiro hit (não normalizada)
+constexpr const char* kDepth = "Z";          ///< Distância média da câmera ao primeiro hit
+constexpr const char* kSamples = "samples";  ///< Amostras acumuladas pelo pixel
+constexpr const char* kVariance = "variance";  ///< Variância da média da luminância
+} // namespace Channels
+
+/**
+ * @class FrameBuffer
+ * @brief Canais float nomeados de uma imagem (cor e AOVs), em layout planar
+ *
+ * Cada canal é um plano contíguo de largura * altura floats, na ordem da imagem
+ * (linha 0 no topo), alocado alinhado à linha de cache: um pós-processamento lê
+ * só os planos de que precisa, em acesso sequencial, e threads que escrevem
+ * pixels de tiles diferentes não disputam linhas de cache de outros canais.
+ * Ponteiros para um canal continuam válidos quando outros canais são adicionados.
+ *
+ * Os nomes seguem a convenção do OpenEXR ("R", "albedo.R", "N.X", "Z"...), então
+ * save_exr() grava todos os canais como camadas de um único arquivo.
+ */
+class FrameBuffer {
+public:
+    /// Alinhamento (em bytes) do início de cada plano
+    static constexpr size_t kAlignment = 64;
+
+    FrameBuffer() = default;
+    FrameBuffer(int width, int height) { reset(width, height); }
+
+    FrameBuffer(const FrameBuffer& other);
+    FrameBuffer& operator=(const FrameBuffer& other);
+    FrameBuffer(FrameBuffer&&) = default;
+    FrameBuffer& operator=(FrameBuffer&&) = default;
+
+    /// Redimensiona e descarta todos os canais
+    void reset(int width, int height);
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    size_t pixel_count() const { return static_cast<size_t>(m_width) * m_height; }
+
+    /**
+     * @brief Adiciona um canal zerado (ou retorna o existente com o mesmo nome)
+     * @return Índice do canal
+     */
+    size_t add_channel(const std::string& name);
+
+    size_t channel_count() const { return m_channels.size(); }
+    const std::string& channel_name(size_t index) const { return m_channels[index].name; }
+
+    /// Índice do canal @p name, ou -1 se não existe
+    int find_channel(const std::string& name) const;
+    bool has_channel(const std::string& name) const { return find_channel(name) >= 0; }
+
+    float* channel(size_t index) { return m_channels[index].data.get(); }
+    const float* channel(size_t index) const { return m_channels[index].data.get(); }
+
+    /**
+     * @brief Plano do canal @p name
+     * @throws std::out_of_range se o canal não existe
+     */
+    float* channel(const std::string& name);
+    const float* channel(const std::string& name) const;
+
+    /**
+     * @brief Grava todos os canais em um OpenEXR multicamada (float 32 bits, sem compressão)
+     * @return false se o arquivo não pôde ser escrito
+     */
+    bool save_exr(const std::string& filename) const;
+
+private:
+    struct AlignedDelete {
+        void operator()(float* data) const { ::operator delete[](data, std::align_val_t(kAlignment)); }
+    };
+
+    struct Channel {
+        std::string name;
+        std::unique_ptr<float[], AlignedDelete> data;
+    };
+
+    /// Plano zerado de pixel_count() floats, alinhado a kAlignment
+    std::unique_ptr<float[], AlignedDelete> allocate_plane() const;
+
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<Channel> m_channels;
+};
+
+} // namespace PathRender
+
+#endif // PATHRENDER_FRAME_BUFFER_HPP_
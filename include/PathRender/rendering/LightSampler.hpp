@@ -0,0 +1,227 @@
+#ifndef PATHRENDER_LIGHT_SAMPLER_HPP_
+#define PATHRENDER_LIGHT_SAMPLER_HPP_
+
+#include "PathRender/core/HitRecord.hpp"
+#include "PathRender/core/aabb.hpp"
+#include "PathRender/core/color.hpp"
+#include "PathRender/core/point.hpp"
+#include "PathRender/core/ray.hpp"
+#include "PathRender/core/sampler.hpp"
+#include "PathRender/core/vector.hpp"
+#include "PathRender/scene/scene.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace PathRender {
+
+/**
+ * @struct AreaLight
+ * @brief Primitivo emissivo (triângulo de uma malha ou esfera) usado na amostragem de luz
+ */
+struct AreaLight {
+    enum class Shape : uint8_t { Triangle, Sphere };
+
+    Shape shape;
+    Point3 origin;       ///< Triângulo: vértice 0; esfera: centro
+    Vector3 edge1;       ///< Triângulo: v1 - v0
+    Vector3 edge2;       ///< Triângulo: v2 - v0
+    float radius = 0.0f; ///< Esfera: raio
+    Color radiance;      ///< Radiância emitida (cor do material emissivo)
+    float area = 0.0f;
+    float power = 0.0f;  ///< Potência emitida / pi, em luminância (peso na escolha da luz)
+    const Object* object = nullptr;
+    uint32_t object_index = 0;    ///< Índice do objeto na cena (HitRecord::object_index)
+    uint32_t primitive_index = 0;
+};
+
+/**
+ * @struct LightSample
+ * @brief Ponto amostrado em uma luz, visto de um ponto da cena
+ */
+struct LightSample {
+    Vector3 direction; ///< Direção normalizada do ponto sombreado até a luz
+    float distance;    ///< Distância até o ponto na luz (limite do raio de sombra)
+    Color radiance;    ///< Radiância emitida em direção ao ponto sombreado
+    float pdf;         ///< Densidade em ângulo sólido, incluindo a escolha da luz
+    Vector3 normal;       ///< Normal da luz no ponto amostrado, do lado voltado para o ponto sombreado
+    float pdf_position;   ///< Densidade de área do ponto amostrado, incluindo a escolha da luz
+    float pdf_emission;   ///< Densidade (ângulo sólido) com que sample_emission() emitiria em -direction
+};
+
+/**
+ * @struct EmissionSample
+ * @brief Raio saindo de uma luz, com a potência que ele carrega (emissão de fótons)
+ */
+struct EmissionSample {
+    Ray ray;     ///< Origem no ponto da luz (afastada da superfície), direção normalizada
+    Color flux;  ///< L_e cos / (pdf do ponto x pdf da direção): potência antes de dividir pelo número de raios
+    Point3 point;         ///< Ponto da luz, sobre a superfície
+    Vector3 normal;       ///< Normal da face que emite
+    Color radiance;       ///< Radiância emitida (L_e)
+    float pdf_position;   ///< Densidade de área do ponto, incluindo a escolha da luz pela potência
+    float pdf_direction;  ///< Densidade em ângulo sólido da direção, incluindo a escolha da face
+};
+
+/**
+ * @brief Estratégia de escolha da luz amostrada em cada ponto sombreado
+ */
+enum class LightSelection {
+    Power,  ///< Tabela de alias pela potência emitida: O(1), igual para todos os pontos
+    BVH     ///< BVH de luzes: importância pela distância e orientação vistas do ponto, O(log n)
+};
+
+const char* light_selection_name(LightSelection selection);
+
+/**
+ * @brief Converte "power" ou "bvh" em LightSelection
+ * @return false se o nome não é reconhecido
+ */
+bool parse_light_selection(const std::string& name, LightSelection& selection);
+
+/**
+ * @class LightSampler
+ * @brief Amostragem por área das superfícies emissivas da cena (next-event estimation)
+ *
+ * Cada triângulo emissivo de uma malha e cada esfera emissiva vira uma AreaLight.
+ * Cada chamada de sample() escolhe uma única luz, então o custo por ponto
+ * sombreado (um raio de sombra) não cresce com o número de luzes. A escolha é
+ * pela potência (tabela de alias) ou pela BVH de luzes, que favorece as luzes
+ * próximas e voltadas para o ponto (Conty Estevez e Kulla 2018, "Importance
+ * Sampling of Many Lights with Adaptive Tree Splitting"). O ponto é uniforme na
+ * área da luz. Triângulos emitem dos dois lados, como quando são atingidos por um
+ * caminho; esferas só pela metade visível do ponto sombreado. Planos emissivos
+ * (ilimitados) não podem ser amostrados e são ignorados.
+ */
+class LightSampler {
+public:
+    /// Dimensões do Sampler consumidas por sample(): escolha da luz e ponto (par 2D)
+    static constexpr uint32_t kDimensions = 3;
+    /// Dimensões consumidas por sample_emission(): luz, face, ponto e direção (pares 2D)
+    static constexpr uint32_t kEmissionDimensions = 6;
+
+    explicit LightSampler(LightSelection selection = LightSelection::BVH) : m_selection(selection) {}
+
+    /// Reconstrói a lista de luzes e a estrutura de escolha a partir dos objetos emissivos da cena
+    void build(const Scene& scene);
+
+    LightSelection selection() const { return m_selection; }
+
+    bool empty() const { return m_lights.empty(); }
+    size_t size() const { return m_lights.size(); }
+    const std::vector<AreaLight>& lights() const { return m_lights; }
+
+    /**
+     * @brief Amostra um ponto de luz visível do lado de fora de @p point
+     * @param normal Normal da superfície em @p point: a BVH evita luzes atrás dela
+     * @return false se não há luzes ou o ponto amostrado não emite em direção a @p point
+     */
+    bool sample(const Point3& point, const Vector3& normal, Sampler& sampler, LightSample& sample) const;
+
+    /**
+     * @brief Densidade (ângulo sólido) com que sample() chamado em (@p point, @p normal)
+     *        teria escolhido o ponto de @p light_hit, atingido por um raio saindo de @p point
+     * @return 0 se o primitivo atingido não é uma luz amostrável (ex.: plano emissivo)
+     */
+    float pdf(const Point3& point, const Vector3& normal, const HitRecord& light_hit) const;
+
+    /**
+     * @brief Amostra um raio emitido: luz pela potência (tabela de alias, em qualquer
+     *        seleção), ponto uniforme na área e direção com densidade cos / pi
+     *
+     * Triângulos escolhem a face com probabilidade 1/2. A soma de flux sobre N
+     * raios, dividida por N, estima a potência total emitida.
+     * @return false se não há luzes
+     */
+    bool sample_emission(Sampler& sampler, EmissionSample& sample) const;
+
+    /**
+     * @brief Densidades com que sample_emission() geraria o ponto de @p light_hit e
+     *        a direção @p direction (normalizada, partindo da luz)
+     * @return false se o primitivo atingido não é uma luz amostrável
+     */
+    bool emission_pdf(const HitRecord& light_hit, const Vector3& direction, float& pdf_position,
+                      float& pdf_direction) const;
+
+private:
+    /**
+     * @struct AliasBin
+     * @brief Célula da tabela de alias (Walker/Vose): fica com a própria luz com probabilidade q
+     */
+    struct AliasBin {
+        float q = 1.0f;
+        uint32_t alias = 0;
+    };
+
+    /**
+     * @struct LightBounds
+     * @brief Região, cone de normais e potência de um conjunto de luzes
+     *
+     * Todas as luzes são difusas: cada normal emite até pi/2 fora do cone.
+     */
+    struct LightBounds {
+        AABB bounds;
+        Vector3 axis{0, 0, 1};     ///< Eixo do cone que contém as normais
+        float cos_theta_o = 1.0f;  ///< Cosseno do meio-ângulo do cone (-1 = todas as direções)
+        float power = 0.0f;
+        bool two_sided = false;    ///< As normais valem nos dois sentidos (triângulos)
+    };
+
+    /**
+     * @struct LightBVHNode
+     * @brief Nó da BVH de luzes, em pré-ordem: o primeiro filho é o nó seguinte
+     */
+    struct LightBVHNode {
+        LightBounds bounds;
+        uint32_t offset = 0;  ///< Folha: índice da luz; nó interno: índice do segundo filho
+        bool leaf = false;
+    };
+
+    /// Chave de busca de um primitivo: (índice do objeto na cena, primitivo)
+    static uint64_t light_key(uint32_t object_index, uint32_t primitive_index) {
+        return (static_cast<uint64_t>(object_index) << 32) | primitive_index;
+    }
+
+    static LightBounds light_bounds(const AreaLight& light);
+    static LightBounds merge(const LightBounds& a, const LightBounds& b);
+    /// Estimativa da contribuição das luzes de @p bounds em @p point, de normal @p normal
+    /// (0 se nenhuma delas pode iluminar o ponto)
+    static float importance(const LightBounds& bounds, const Point3& point, const Vector3& normal);
+
+    void build_alias_table();
+    /// Constrói a subárvore sobre m_lights[indices[begin..end)] e retorna o seu nó
+    uint32_t build_bvh(std::vector<uint32_t>& indices, const std::vector<Point3>& centroids, size_t begin,
+                       size_t end, int depth, uint64_t trail);
+
+    /// Luz escolhida com @p u pela tabela de alias (probabilidade m_power_pdf)
+    uint32_t select_by_power(float u) const;
+    /// Escolhe a luz vista de @p point com @p u; false se nenhuma luz ilumina o ponto
+    bool select(const Point3& point, const Vector3& normal, float u, uint32_t& index, float& probability) const;
+    /// Probabilidade de select() em (@p point, @p normal) escolher a luz @p index
+    float selection_pdf(const Point3& point, const Vector3& normal, uint32_t index) const;
+
+    LightSelection m_selection;
+    std::vector<AreaLight> m_lights;
+    std::unordered_map<uint64_t, uint32_t> m_light_index;  ///< light_key() -> posição em m_lights
+
+    std::vector<AliasBin> m_alias;         ///< Tabela de alias pela potência (sempre construída)
+    std::vector<float> m_power_pdf;        ///< Probabilidade de cada luz na tabela de alias
+
+    std::vector<LightBVHNode> m_nodes;     ///< BVH de luzes (vazia na seleção por potência)
+    std::vector<uint64_t> m_light_trail;   ///< Caminho da raiz até a folha da luz (bit d: segundo filho)
+};
+
+/**
+ * @brief Peso de MIS pela heurística da potência (beta = 2) para uma amostra de densidade
+ *        @p pdf, combinada com uma estratégia que a geraria com densidade @p other_pdf
+ */
+inline float power_heuristic(float pdf, float other_pdf) {
+    const float a = pdf * pdf;
+    const float b = other_pdf * other_pdf;
+    return a + b > 0.0f ? a / (a + b) : 0.0f;
+}
+
+} // namespace PathRender
+
+#endif // PATHRENDER_LIGHT_SAMPLER_HPP_
@@ -1,21 +1,23 @@
 #ifndef PATHRENDER_PATHTRACER_HPP_
 #define PATHRENDER_PATHTRACER_HPP_
 
+#include "PathRender/core/sampler.hpp"
+#include "PathRender/rendering/AccumulationBuffer.hpp"
+#include "PathRender/rendering/Denoiser.hpp"
+#include "PathRender/rendering/FrameBuffer.hpp"
 #include "PathRender/rendering/IRenderAlgorithm.hpp"
-#include <random>
+#include "PathRender/rendering/LightSampler.hpp"
+#include "PathRender/rendering/RadianceCache.hpp"
+#include <cstdint>
+#include <string>
 #include <thread>
 #include <vector>
 #include <atomic>
+#include <memory>
 #include <mutex>
 
 namespace PathRender {
 
-struct LightPoint {
-    Point3 position;
-    Color color;
-    float intensity;
-};
-
 class PathTracer : public IRenderAlgorithm {
 public:
     PathTracer() = default; 
@@ -25,29 +27,195 @@ public:
     void set_direct_lighting_enabled(bool enabled) { m_direct_lighting_enabled = enabled; }
     bool is_direct_lighting_enabled() const { return m_direct_lighting_enabled; }
 
+    /// Semente dos números aleatórios: a mesma semente reproduz a mesma imagem
+    void set_seed(uint32_t seed) { m_seed = seed; }
+    uint32_t get_seed() const { return m_seed; }
+
+    /// Sampler usado na câmera e nos BRDFs (independente, estratificado, Halton ou Sobol)
+    void set_sampler_type(SamplerType type) { m_sampler_type = type; }
+    SamplerType get_sampler_type() const { return m_sampler_type; }
+
+    /// Escolha da luz amostrada em cada ponto: pela potência (alias) ou pela BVH de luzes
+    void set_light_selection(LightSelection selection) { m_light_selection = selection; }
+    LightSelection get_light_selection() const { return m_light_selection; }
+
+    /// Profundidade máxima dos caminhos; a roleta russa costuma encerrá-los bem antes
+    void set_max_depth(int depth) { m_max_depth = depth; }
+    int get_max_depth() const { return m_max_depth; }
+
+    // Radiance cache configuration
+    /// Se verdadeiro, caminhos terminam no RadianceCache ao atingir uma superfície difusa
+    /// a partir de get_radiance_cache_depth() rebotes, depois da iluminação direta dela
+    /// (mais rápido, com viés). O primeiro passe de um cache vazio só o aquece
+    void set_radiance_cache_enabled(bool enabled) { m_radiance_cache_enabled = enabled; }
+    bool is_radiance_cache_enabled() const { return m_radiance_cache_enabled; }
+    /// Rebote a partir do qual o cache é consultado; os vértices anteriores, e os que acham
+    /// a célula ainda vazia, o preenchem. 0 (padrão) é o modo de preview: só o primeiro
+    /// hit e sua iluminação direta são traçados, a indireta vem do cache
+    void set_radiance_cache_depth(int depth) { m_radiance_cache_depth = depth; }
+    int get_radiance_cache_depth() const { return m_radiance_cache_depth; }
+    /// Lado das células do cache em unidades da cena (0 = automático, pela extensão da cena)
+    void set_radiance_cache_cell_size(float size) { m_radiance_cache_cell_size = size; }
+    float get_radiance_cache_cell_size() const { return m_radiance_cache_cell_size; }
+    /// Se verdadeiro, o cache é mantido entre renders (a cena não pode mudar, a câmera
+    /// e as amostras sim) e o próximo render já o consulta no primeiro passe
+    void set_radiance_cache_persistent(bool persistent) { m_radiance_cache_persistent = persistent; }
+    bool is_radiance_cache_persistent() const { return m_radiance_cache_persistent; }
+
+    // Adaptive sampling configuration
+    /// Máximo de amostras por pixel (sem amostragem adaptativa, todos os pixels recebem este valor)
+    void set_max_samples(int samples) { m_max_samples = samples; }
+    int get_max_samples() const { return m_max_samples; }
+    /// Amostras do passe base, dadas a todos os pixels antes de estimar o erro
+    void set_min_samples(int samples) { m_min_samples = samples; }
+    int get_min_samples() const { return m_min_samples; }
+    /// Erro padrão máximo (em unidades da imagem final, 0..1) para um pixel parar de receber amostras; 0 desativa
+    void set_adaptive_threshold(float threshold) { m_adaptive_threshold = threshold; }
+    float get_adaptive_threshold() const { return m_adaptive_threshold; }
+
+    /// Amostras dadas a cada pixel ativo por passe
+    void set_pass_samples(int samples) { m_pass_samples = samples; }
+    int get_pass_samples() const { return m_pass_samples; }
+
+    // Checkpoint configuration
+    /// Arquivo onde o buffer de acumulação é salvo periodicamente (vazio = sem checkpoint)
+    void set_checkpoint_file(const std::string& filename) { m_checkpoint_file = filename; }
+    const std::string& get_checkpoint_file() const { return m_checkpoint_file; }
+    /// Intervalo mínimo entre checkpoints, em segundos (sempre há um ao final do render)
+    void set_checkpoint_interval(double seconds) { m_checkpoint_interval = seconds; }
+    double get_checkpoint_interval() const { return m_checkpoint_interval; }
+    /// Se verdadeiro, render() continua a partir do checkpoint em vez de começar do zero
+    void set_resume(bool resume) { m_resume = resume; }
+    bool is_resume_enabled() const { return m_resume; }
+
+    // Denoiser configuration
+    /// Se verdadeiro, render() filtra a imagem com o Denoiser guiado pelos AOVs do primeiro hit
+    void set_denoise_enabled(bool enabled) { m_denoise_enabled = enabled; }
+    bool is_denoise_enabled() const { return m_denoise_enabled; }
+    /// Parâmetros do filtro aplicado quando o denoiser está ativo
+    Denoiser& denoiser() { return m_denoiser; }
+    const Denoiser& denoiser() const { return m_denoiser; }
+
+    /**
+     * @brief Amostras usadas por pixel (acumuladas, incluindo as retomadas), na mesma ordem do buffer
+     */
+    std::vector<int> sample_counts() const;
+
+    /**
+     * @brief Buffer de acumulação do último render
+     */
+    const AccumulationBuffer& accumulation() const { return m_accumulation; }
+
+    /**
+     * @brief Canais do último render, preenchidos no próprio laço dos tiles
+     *
+     * Cor linear ("R", "G", "B"; filtrada se o denoiser está ativo, com a original
+     * em "noisy.*"), "samples", "variance" (da média da luminância) e os AOVs do
+     * primeiro hit: "A" (cobertura), "albedo.*", "N.*" e "Z", médias das amostras
+     * deste render que atingiram uma superfície não emissiva. Ao retomar um
+     * checkpoint, pixels que não recebem amostras novas ficam com cobertura 0.
+     */
+    const FrameBuffer& frame() const { return m_frame; }
+
 private:
-    Color trace_path(const Ray& ray, int depth, const Scene& scene, std::mt19937& thread_rng);
-    Vector3 random_unit_vector_in_hemisphere_of(const Vector3& normal, std::mt19937& thread_rng);
-    
-    // Direct lighting methods
-    void extract_light_points(const Scene& scene);
-    Color calculate_direct_lighting(const Point3& hit_point, const Vector3& normal, 
-                                   const Material& material, const Scene& scene, 
-                                   std::mt19937& thread_rng);
-    bool is_in_shadow(const Point3& point, const Point3& light_pos, const Scene& scene);
-    
-    // These helpers are pure math, so they are naturally thread-safe (const input)
-    Vector3 refract(const Vector3& uv, const Vector3& n, float etai_over_etat);
-    Vector3 mix(const Vector3& a, const Vector3& b, double c);
-    float reflectance(float cosine, float ref_idx);
-    
-    const int max_depth = 5;
+    /// Variância da média da luminância do pixel (luminância ao quadrado com menos de 2 amostras)
+    static float mean_variance(const PixelAccumulator& pixel);
+
+    /// Erro padrão estimado do pixel (luminância média, variância da média e amostras)
+    /// após a correção gamma da saída
+    static float pixel_error(float luminance, float variance, float samples);
+
+    /// Marca os pixels que recebem amostras no próximo passe adaptativo
+    void update_active_pixels(const FrameBuffer& frame, uint32_t max_samples, std::vector<uint8_t>& active) const;
+
+    /**
+     * @struct FirstHit
+     * @brief AOVs do primeiro hit de uma amostra da câmera (ou suas somas sobre as amostras de um pixel)
+     */
+    struct FirstHit {
+        float albedo[3] = {0.0f, 0.0f, 0.0f};  ///< Cor do material atingido, limitada a [0, 1]
+        Vector3 normal;                        ///< Normal voltada para a câmera
+        float depth = 0.0f;                    ///< Distância da câmera ao hit
+        uint32_t hits = 0;                     ///< Amostras que atingiram uma superfície não emissiva
+    };
+
+    /**
+     * @struct PathState
+     * @brief Estado de um caminho em construção, avançado rebote a rebote por trace_path
+     */
+    struct PathState {
+        Ray ray;                         ///< Próximo segmento a ser traçado
+        Color throughput{1.0, 1.0, 1.0}; ///< Produto das atenuações (e pesos da roleta russa) desde a câmera
+        Color radiance;                  ///< Radiância já coletada ao longo do caminho
+        int depth = 0;                   ///< Rebotes já realizados
+        float last_pdf = 0.0f;           ///< Densidade da direção do último rebote (0 = delta ou desconhecida)
+        Vector3 last_normal;             ///< Normal no ponto do último rebote (escolha da luz no MIS)
+    };
+
+    /**
+     * @struct CacheVertex
+     * @brief Vértice difuso de um caminho cuja radiância indireta de saída é inserida no cache ao fim do caminho
+     */
+    struct CacheVertex {
+        Point3 point;
+        Vector3 normal;
+        Color throughput;  ///< Throughput ao chegar no vértice
+        Color radiance;    ///< Radiância do caminho até a iluminação direta do vértice
+    };
+
+    /**
+     * @brief Estima a radiância ao longo de um raio da câmera (laço iterativo, sem recursão)
+     * @param first_hit Se não nulo, os AOVs do primeiro hit são somados a ele
+     */
+    Color trace_path(const Ray& camera_ray, const Scene& scene, Sampler& sampler,
+                     FirstHit* first_hit = nullptr);
+
+    /**
+     * @brief Iluminação direta por amostragem de luz: um ponto em uma luz emissiva,
+     *        ponderado pelo BRDF, pelo cosseno, pela densidade e pelo peso de MIS, se visível
+     */
+    Color calculate_direct_lighting(const Ray& ray, const HitRecord& hit, const Material& material,
+                                    const Scene& scene, Sampler& sampler) const;
+
+    /// Vértices de um caminho que alimentam o cache
+    static constexpr int kMaxCacheVertices = 8;
+
+    /// Primeiro rebote em que a roleta russa pode encerrar o caminho
+    static constexpr int kRouletteMinDepth = 3;
+
+    /// Lado (em pixels) dos tiles distribuídos entre as threads
+    static constexpr int kTileSize = 16;
+    /// Raio da vizinhança cujo maior erro decide se um pixel continua amostrando
+    static constexpr int kAdaptiveWindowRadius = 1;
     
     // Configuration flags
     bool m_direct_lighting_enabled = true;  // Default: enabled
+    int m_max_depth = 32;
+    uint32_t m_seed = 0;
+    SamplerType m_sampler_type = SamplerType::Sobol;
+    LightSelection m_light_selection = LightSelection::BVH;
+    int m_max_samples = 100;
+    int m_min_samples = 8;
+    float m_adaptive_threshold = 0.05f;
+    int m_pass_samples = 8;
+    std::string m_checkpoint_file;
+    double m_checkpoint_interval = 60.0;
+    bool m_resume = false;
+    bool m_denoise_enabled = false;
+    bool m_radiance_cache_enabled = false;
+    int m_radiance_cache_depth = 0;
+    float m_radiance_cache_cell_size = 0.0f;
+    bool m_radiance_cache_persistent = false;
+    
+    AccumulationBuffer m_accumulation;
+    FrameBuffer m_frame;
+    Denoiser m_denoiser;
     
-    // Light storage
-    std::vector<LightPoint> m_light_points;
+    // Emissive triangles and spheres sampled for direct lighting
+    LightSampler m_lights;
+
+    // Indirect outgoing radiance of diffuse surfaces, shared by all threads (allocated on first use)
+    std::unique_ptr<RadianceCache> m_radiance_cache;
 };
 
 } // namespace PathRender
@@ -0,0 +1,113 @@
+#ifndef PATHRENDER_PHOTON_MAP_HPP_
+#define PATHRENDER_PHOTON_MAP_HPP_
+
+#include "PathRender/core/point.hpp"
+#include "PathRender/core/vector.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace PathRender {
+
+/**
+ * @struct Photon
+ * @brief Fóton depositado em uma superfície
+ */
+struct Photon {
+    Point3 position;
+    Vector3 direction;  ///< Direção de onde o fóton chegou (wi, partindo da superfície)
+    Vector3 normal;     ///< Normal da superfície, do lado por onde o fóton chegou
+    float flux[3];      ///< Potência carregada, antes de dividir pelo número de fótons emitidos
+};
+
+/**
+ * @class PhotonMap
+ * @brief Fótons de um passe em uma kd-tree balanceada implícita
+ *
+ * build() ordena o vetor de fótons no lugar: o nó de cada intervalo [begin, end)
+ * é o fóton do meio, separado pela mediana do eixo mais longo do intervalo,
+ * então a árvore não tem ponteiros e ocupa só um byte (o eixo) a mais por fóton.
+ * A memória é reaproveitada entre passes: clear() não libera a capacidade.
+ */
+class PhotonMap {
+public:
+    /// Maior k aceito por kth_nearest_distance2()
+    static constexpr int kMaxNearest = 128;
+
+    void clear() {
+        m_photons.clear();
+        m_axis.clear();
+    }
+
+    /// Adiciona fótons; só são encontrados pelas buscas depois de build()
+    void add(const std::vector<Photon>& photons) { m_photons.insert(m_photons.end(), photons.begin(), photons.end()); }
+
+    /// Constrói a kd-tree sobre os fótons adicionados
+    void build();
+
+    size_t size() const { return m_photons.size(); }
+    bool empty() const { return m_photons.empty(); }
+
+    /**
+     * @brief Quadrado da distância de @p point ao k-ésimo fóton mais próximo
+     * @return @p max_distance2 se há menos de @p k fótons dentro dela
+     */
+    float kth_nearest_distance2(const Point3& point, int k, float max_distance2) const;
+
+    /**
+     * @brief Chama visit(photon) para cada fóton a uma distância de @p point menor
+     *        que sqrt(@p radius2), sem alocação (pilha de tamanho fixo)
+     */
+    template <typename Visit>
+    void for_each_in_radius(const Point3& point, float radius2, Visit&& visit) const;
+
+private:
+    struct Range {
+        uint32_t begin, end;
+    };
+
+    /// Profundidade máxima da árvore (intervalos divididos ao meio)
+    static constexpr int kMaxDepth = 64;
+
+    void build(uint32_t begin, uint32_t end);
+
+    static float coordinate(const Point3& p, int axis) { return axis == 0 ? p.x : axis == 1 ? p.y : p.z; }
+
+    std::vector<Photon> m_photons;
+    std::vector<uint8_t> m_axis;  ///< Eixo de separação do nó em cada posição
+};
+
+template <typename Visit>
+void PhotonMap::for_each_in_radius(const Point3& point, float radius2, Visit&& visit) const {
+    if (m_photons.empty()) {
+        return;
+    }
+    Range stack[kMaxDepth];
+    int top = 0;
+    stack[top++] = Range{0, static_cast<uint32_t>(m_photons.size())};
+    while (top > 0) {
+        const Range range = stack[--top];
+        const uint32_t middle = range.begin + (range.end - range.begin) / 2;
+        const Photon& photon = m_photons[middle];
+        if ((photon.position - point).length_squared() < radius2) {
+            visit(photon);
+        }
+
+        // The far side only if the sphere crosses the splitting plane
+        const float offset = coordinate(point, m_axis[middle]) - coordinate(photon.position, m_axis[middle]);
+        const Range below{range.begin, middle};
+        const Range above{middle + 1, range.end};
+        const Range& near = offset < 0.0f ? below : above;
+        const Range& far = offset < 0.0f ? above : below;
+        if (far.begin < far.end && offset * offset < radius2) {
+            stack[top++] = far;
+        }
+        if (near.begin < near.end) {
+            stack[top++] = near;
+        }
+    }
+}
+
+} // namespace PathRender
+
+#endif // PATHRENDER_PHOTON_MAP_HPP_
@@ -0,0 +1,143 @@
+#ifndef PATHRENDER_PHOTON_MAPPER_HPP_
+#define PATHRENDER_PHOTON_MAPPER_HPP_
+
+#include "PathRender/core/HitRecord.hpp"
+#include "PathRender/core/sampler.hpp"
+#include "PathRender/rendering/IRenderAlgorithm.hpp"
+#include "PathRender/rendering/LightSampler.hpp"
+#include "PathRender/rendering/PhotonMap.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace PathRender {
+
+/**
+ * @class PhotonMapper
+ * @brief Photon mapping progressivo estocástico (SPPM; Hachisuka e Jensen 2009,
+ *        "Stochastic Progressive Photon Mapping")
+ *
+ * Cada passe traça um caminho de câmera por pixel através das superfícies
+ * especulares (lobos delta) até o primeiro ponto com lobo difuso ou glossy, o
+ * ponto visível, onde a iluminação direta vem da amostragem de luz como no
+ * PathTracer. Em seguida emite fótons das luzes (em paralelo, pela potência) e
+ * os deposita em dois mapas, reconstruídos como kd-trees a cada passe: o de
+ * cáusticas, para fótons que só passaram por lobos delta (luz -> vidro ->
+ * difuso), e o global, para os demais. Cada ponto visível soma os fótons de cada
+ * mapa dentro do seu raio; o raio encolhe a cada passe (fração alpha dos fótons
+ * é mantida), então a estimativa converge para a solução sem viés enquanto a
+ * memória fica limitada aos fótons de um passe e a estatísticas por pixel. O
+ * raio inicial de cada pixel em cada mapa é a distância ao k-ésimo fóton mais
+ * próximo no primeiro passe em que o ponto visível existe: as cáusticas,
+ * concentradas, começam com raios bem menores que a iluminação indireta difusa.
+ *
+ * Cáusticas através de DielectricBRDF, que o PathTracer só encontra quando um
+ * caminho difuso acerta a luz depois do vidro, aparecem já nos primeiros passes.
+ */
+class PhotonMapper : public IRenderAlgorithm {
+public:
+    PhotonMapper() = default;
+    void render(std::vector<Color>& buffer, const SceneConfig& config) override;
+
+    /// Iluminação direta nos pontos visíveis pela amostragem de luz (senão, também pelos fótons)
+    void set_direct_lighting_enabled(bool enabled) { m_direct_lighting_enabled = enabled; }
+    bool is_direct_lighting_enabled() const { return m_direct_lighting_enabled; }
+
+    /// Passes (uma amostra de câmera por pixel e um lote de fótons em cada)
+    void set_passes(int passes) { m_passes = passes; }
+    int get_passes() const { return m_passes; }
+
+    /// Fótons emitidos por passe
+    void set_photons_per_pass(int photons) { m_photons_per_pass = photons; }
+    int get_photons_per_pass() const { return m_photons_per_pass; }
+
+    /// Fótons mais próximos que definem o raio inicial de cada pixel
+    void set_nearest_photons(int k) { m_nearest_photons = k; }
+    int get_nearest_photons() const { return m_nearest_photons; }
+
+    /// Fração dos fótons novos mantida a cada passe (entre 0 e 1; menor = raios encolhem mais rápido)
+    void set_alpha(float alpha) { m_alpha = alpha; }
+    float get_alpha() const { return m_alpha; }
+
+    /// Raio máximo de busca, em unidades da cena (0 = automático, 1/50 da diagonal da cena)
+    void set_max_radius(float radius) { m_max_radius = radius; }
+    float get_max_radius() const { return m_max_radius; }
+
+    /// Profundidade máxima dos caminhos de câmera e de fótons
+    void set_max_depth(int depth) { m_max_depth = depth; }
+    int get_max_depth() const { return m_max_depth; }
+
+    void set_seed(uint32_t seed) { m_seed = seed; }
+    uint32_t get_seed() const { return m_seed; }
+
+    /// Sampler dos caminhos de câmera (os fótons usam números independentes)
+    void set_sampler_type(SamplerType type) { m_sampler_type = type; }
+    SamplerType get_sampler_type() const { return m_sampler_type; }
+
+    void set_light_selection(LightSelection selection) { m_light_selection = selection; }
+    LightSelection get_light_selection() const { return m_light_selection; }
+
+private:
+    /// Ponto visível de um pixel no passe atual
+    struct VisiblePoint {
+        HitRecord hit;
+        Vector3 wo;
+        const BRDF* brdf = nullptr;  ///< nullptr: o caminho não encontrou uma superfície não especular
+        Color throughput;
+    };
+
+    /// Estatísticas progressivas de um pixel em um mapa de fótons
+    struct GatherState {
+        float radius2 = 0.0f;  ///< 0 até o raio inicial ser definido
+        float photons = 0.0f;  ///< Fótons acumulados (N), já descontados por alpha
+        Color flux;            ///< Soma de throughput x f x potência dos fótons, escalada com o raio (tau)
+    };
+
+    struct PixelState {
+        Color direct;  ///< Soma (sobre os passes) da emissão vista e da iluminação direta
+        GatherState caustic;
+        GatherState global;
+    };
+
+    /// Fótons depositados por um bloco de emissão, reaproveitados entre passes
+    struct PhotonBatch {
+        std::vector<Photon> caustic;
+        std::vector<Photon> global;
+    };
+
+    /// Caminho de câmera do pixel (@p i, @p j) no passe @p pass; retorna a radiância direta
+    Color trace_camera(const SceneConfig& config, int i, int j, uint32_t pass, Sampler& sampler,
+                       VisiblePoint& visible) const;
+
+    /// Emite os fótons [@p begin, @p end) do passe @p pass e os deposita em @p batch
+    void trace_photons(const Scene& scene, uint32_t pass, uint32_t begin, uint32_t end, PhotonBatch& batch) const;
+
+    /// Iluminação direta em @p hit por uma amostra de luz
+    Color direct_lighting(const Scene& scene, const HitRecord& hit, const Vector3& wo, const BRDF& brdf,
+                          Sampler& sampler) const;
+
+    /// Soma os fótons de @p map no raio de @p state e atualiza as estatísticas do pixel
+    void gather(const PhotonMap& map, const VisiblePoint& visible, float max_radius2, GatherState& state) const;
+
+    /// Fótons emitidos por bloco paralelo
+    static constexpr uint32_t kPhotonBatchSize = 4096;
+    static constexpr int kRouletteMinDepth = 3;
+
+    bool m_direct_lighting_enabled = true;
+    int m_passes = 100;
+    int m_photons_per_pass = 200000;
+    int m_nearest_photons = 32;
+    float m_alpha = 2.0f / 3.0f;
+    float m_max_radius = 0.0f;
+    int m_max_depth = 32;
+    uint32_t m_seed = 0;
+    SamplerType m_sampler_type = SamplerType::Sobol;
+    LightSelection m_light_selection = LightSelection::BVH;
+
+    LightSampler m_lights;
+    PhotonMap m_caustic_map;
+    PhotonMap m_global_map;
+};
+
+} // namespace PathRender
+
+#endif // PATHRENDER_PHOTON_MAPPER_HPP_
@@ -0,0 +1,94 @@
+#ifndef PATHRENDER_RADIANCE_CACHE_HPP_
+#define PATHRENDER_RADIANCE_CACHE_HPP_
+
+#include "PathRender/core/color.hpp"
+#include "PathRender/core/point.hpp"
+#include "PathRender/core/vector.hpp"
+#include "PathRender/scene/scene.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace PathRender {
+
+/**
+ * @class RadianceCache
+ * @brief Cache de radiância em espaço de mundo: tabela hash de células (posição, normal)
+ *
+ * Cada célula é um cubo de lado cell_size combinado com o eixo dominante da normal
+ * (6 direções), e guarda a radiância indireta média saindo das superfícies difusas
+ * nela, isto é, a que chega pelo rebote e não pela amostragem de luz (Spatially
+ * Hashed Radiance Cache, como no SHaRC). O PathTracer insere as estimativas dos
+ * vértices de cada caminho e, a partir de uma profundidade configurável, encerra
+ * o caminho com a iluminação direta do vértice mais o valor da célula: cadeias
+ * longas de rebotes difusos terminam cedo, ao custo de algum viés (a radiância é
+ * tratada como independente da direção e constante na célula).
+ *
+ * insert() não usa locks: uma célula é reservada com compare-and-swap da chave
+ * (sondagem linear) e as somas são inteiros em ponto fixo acumulados com
+ * fetch_add, então o resultado não depende da ordem das threads. lookup() lê só
+ * as médias congeladas pelo último commit(), chamado entre os passes: dentro de
+ * um passe, o que cada caminho vê não depende de quais outros caminhos já
+ * terminaram. A tabela não cresce; com ela cheia, novas células são descartadas.
+ */
+class RadianceCache {
+public:
+    /// Amostras que uma célula precisa ter (no último commit) para ser usada
+    static constexpr uint32_t kMinSamples = 8;
+
+    /// @param capacity_log2 log2 do número de células da tabela
+    explicit RadianceCache(int capacity_log2 = 18);
+
+    /// Esvazia a tabela e define o lado das células
+    void reset(float cell_size);
+
+    /// Lado automático das células: 1/32 da diagonal dos objetos limitados da cena
+    static float default_cell_size(const Scene& scene);
+
+    float cell_size() const { return m_cell_size; }
+    size_t capacity() const { return m_capacity; }
+
+    /// Soma uma estimativa da radiância saindo de @p point (sem locks, seguro entre threads)
+    void insert(const Point3& point, const Vector3& normal, const Color& radiance);
+
+    /**
+     * @brief Radiância média da célula de (@p point, @p normal) no último commit()
+     * @return false se a célula não existe ou tem menos de kMinSamples amostras
+     */
+    bool lookup(const Point3& point, const Vector3& normal, Color& radiance) const;
+
+    /// Congela as médias atuais para lookup(); não pode ser chamado junto com insert()
+    void commit();
+
+    /// Células ocupadas na tabela
+    size_t occupied() const;
+
+private:
+    struct Cell {
+        std::atomic<uint64_t> key{0};  ///< 0 = livre
+        std::atomic<uint64_t> sum[3] = {};  ///< Radiância em ponto fixo (kFixedPointScale)
+        std::atomic<uint32_t> samples{0};
+        float mean[3] = {0.0f, 0.0f, 0.0f};  ///< Médias congeladas por commit()
+        uint32_t committed_samples = 0;
+    };
+
+    /// Chave (não nula) da célula de (@p point, @p normal)
+    uint64_t cell_key(const Point3& point, const Vector3& normal) const;
+
+    /// Sondas da sondagem linear antes de desistir
+    static constexpr int kMaxProbes = 16;
+    /// Fator do ponto fixo das somas (resolução de 1.5e-5 em radiância)
+    static constexpr double kFixedPointScale = 65536.0;
+    /// Radiância máxima somada por amostra (evita estouro das somas)
+    static constexpr double kMaxRadiance = 1.0e6;
+
+    size_t m_capacity;
+    std::unique_ptr<Cell[]> m_cells;
+    float m_cell_size = 1.0f;
+    float m_inv_cell_size = 1.0f;
+};
+
+} // namespace PathRender
+
+#endif // PATHRENDER_RADIANCE_CACHE_HPP_
@@ -34,6 +34,27 @@ public:
      * @return Raio da câmera através do pixel (u, v)
      */
     Ray get_ray(float u, float v) const;
+
+    /**
+     * @brief Inverso de get_ray(): coordenadas (u, v) do raio que passa por @p point
+     * @return false se o ponto está atrás da câmera (u e v podem sair de [0, 1])
+     */
+    bool project(const Point3& point, float& u, float& v) const;
+
+    /**
+     * @brief Importância W_e da câmera de furo na direção @p direction (normalizada)
+     *
+     * Com (u, v) uniformes em [0, 1]^2, W_e = 1 / (A cos^4 θ), θ o ângulo com forward()
+     * e A a área do plano de visão (a distância 1); 0 atrás da câmera. O estimador de
+     * um ponto y visto da câmera é L(y -> câmera) W_e cos θ / d^2.
+     */
+    float importance(const Vector3& direction) const;
+
+    /// Densidade (ângulo sólido) de @p direction em get_ray() com (u, v) uniformes em [0, 1]^2: 1 / (A cos^3 θ)
+    float pdf(const Vector3& direction) const;
+
+    /// Eixo óptico: a direção para onde a câmera olha
+    Vector3 forward() const { return -m_w; }
     
     std::string to_string() const;
 
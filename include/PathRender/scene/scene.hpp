@@ -1,6 +1,7 @@
 #ifndef PATHRENDER_SCENE_HPP_
 #define PATHRENDER_SCENE_HPP_
 
+#include "PathRender/accel/wide_bvh.hpp"
 #include "PathRender/objects/objects.hpp"
 #include "PathRender/core/light.hpp"
 #include "PathRender/core/ray.hpp"
@@ -26,6 +27,17 @@ public:
     void add_light(const Light& light);
 
     const Light& get_light(size_t index) const;
+
+    /**
+     * @brief Constrói a BVH sobre os objetos limitados da cena
+     *
+     * Deve ser chamado depois que todos os objetos foram adicionados. Enquanto a
+     * cena não for finalizada (ou após add_object), intersect() testa todos os
+     * objetos linearmente.
+     */
+    void finalize();
+
+    bool is_finalized() const;
     
     /**
      * @brief Testa interseção do raio com todos os objetos da cena
@@ -36,6 +48,14 @@ public:
      * @return true se houver interseção, false caso contrário
      */
     bool intersect(const Ray& ray, float t_min, float t_max, HitRecord& hit) const;
+
+    /**
+     * @brief Testa se algum objeto não emissivo bloqueia o raio em (t_min, t_max)
+     *
+     * Consulta any-hit para raios de sombra: para no primeiro bloqueio, não
+     * preenche HitRecord e ignora objetos emissivos sem consultar seus materiais.
+     */
+    bool occluded(const Ray& ray, float t_min, float t_max) const;
     
     /**
      * @brief Remove todos os objetos da cena
@@ -57,6 +77,13 @@ public:
 private:
     std::vector<Light> m_lights;
     std::vector<std::shared_ptr<Object>> m_objects;
+
+    // Acceleration structure over bounded objects; unbounded ones (planes) are tested linearly
+    AccelBVH m_bvh;
+    std::vector<uint32_t> m_bvh_objects;  // Object index for each BVH leaf slot
+    std::vector<uint32_t> m_unbounded_objects;
+    std::vector<uint8_t> m_emissive_objects;  // Object::is_emissive(), cached by finalize()
+    bool m_finalized = false;
 };
 
 } // namespace PathRender
@@ -10,6 +10,13 @@ namespace Utils {
   // Helper: Generates a coordinate system (Tangent, Bitangent) given a Normal
   void build_orthonormal_basis(const Vector3& normal, Vector3& tangent, Vector3& bitangent);
 
+  // Maps a 2D sample in [0,1)^2 to the unit disk (Shirley-Chiu concentric map: low
+  // distortion, so stratified samples stay stratified)
+  void concentric_sample_disk(float u1, float u2, float& x, float& y);
+
+  // Cosine-weighted direction in the hemisphere of normal (pdf = cos / pi), from a 2D sample
+  Vector3 cosine_sample_hemisphere(const Vector3& normal, float u1, float u2);
+
 } // namespace Utils
 
 #endif // PATHRENDER_MATH_UTILS_HPP_
\ No newline at end of file
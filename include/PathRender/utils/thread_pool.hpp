@@ -0,0 +1,131 @@
+#ifndef PATHRENDER_THREAD_POOL_HPP_
+#define PATHRENDER_THREAD_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Utils {
+
+  /**
+   * @class ThreadPool
+   * @brief Conjunto persistente de threads com uma deque de tarefas por thread (work stealing)
+   *
+   * Cada thread consome sua própria deque pelo fim (LIFO, dados ainda em cache) e,
+   * quando ela esvazia, rouba tarefas do início das deques das outras. Tarefas
+   * submetidas de dentro de uma tarefa vão para a deque da thread atual; as
+   * submetidas de fora são distribuídas em rodízio.
+   *
+   * global() é compartilhado pelo renderizador e pela construção das BVHs, de
+   * modo que as threads são criadas uma única vez por processo.
+   */
+  class ThreadPool {
+  public:
+    /**
+     * @param thread_count Número de threads (0 = std::thread::hardware_concurrency())
+     */
+    explicit ThreadPool(size_t thread_count = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return m_workers.size(); }
+
+    /**
+     * @brief Recria as threads com outra quantidade (0 = hardware_concurrency)
+     *
+     * Não deve ser chamado enquanto houver tarefas em andamento.
+     */
+    void set_thread_count(size_t thread_count);
+
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Executa uma tarefa pendente na thread atual (da própria deque ou roubada)
+     * @return false se não havia tarefas
+     */
+    bool run_pending_task();
+
+    /**
+     * @brief Índice da thread do pool que está executando (0..size()-1), ou size()
+     *        para threads de fora do pool (ex.: a thread principal ajudando em wait())
+     */
+    size_t current_thread_index() const;
+
+    static ThreadPool& global();
+
+  private:
+    struct WorkQueue {
+      std::mutex mutex;
+      std::deque<std::function<void()>> tasks;
+    };
+
+    void start(size_t thread_count);
+    void stop();
+    void worker_loop(size_t index);
+    bool pop_task(size_t index, std::function<void()>& task);
+
+    std::vector<std::thread> m_workers;
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::atomic<size_t> m_next_queue{0};
+    std::atomic<size_t> m_queued{0};
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+  };
+
+  /**
+   * @class TaskGroup
+   * @brief Conjunto de tarefas submetidas a um ThreadPool que podem ser aguardadas juntas
+   *
+   * Tarefas podem adicionar novas tarefas ao mesmo grupo. wait() executa tarefas
+   * pendentes enquanto espera, então pode ser chamado de dentro de outra tarefa;
+   * sem nada para executar, dorme até o grupo terminar ou receber outra tarefa.
+   *
+   * Uma exceção lançada por uma tarefa não escapa da thread do pool: a primeira é
+   * guardada e relançada por wait(). O destrutor só aguarda e a descarta, então
+   * quem precisa dela chama wait() antes.
+   */
+  class TaskGroup {
+  public:
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::global()) : m_pool(pool) {}
+    ~TaskGroup() { finish(); }
+
+    void run(std::function<void()> task);
+
+    /**
+     * @brief Aguarda todas as tarefas do grupo
+     * @throws A primeira exceção lançada por uma delas
+     */
+    void wait();
+
+  private:
+    /// Aguarda todas as tarefas sem relançar exceções
+    void finish();
+
+    ThreadPool& m_pool;
+    std::atomic<size_t> m_pending{0};
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    size_t m_generation = 0;  ///< Muda a cada tarefa submetida e quando o grupo termina (m_mutex)
+    std::exception_ptr m_exception;  ///< Primeira exceção de uma tarefa (m_mutex)
+  };
+
+  /**
+   * @brief Executa body(begin, end) sobre blocos de [0, count) em paralelo
+   * @param grain Tamanho mínimo de cada bloco
+   */
+  void parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body,
+                    ThreadPool& pool = ThreadPool::global());
+
+} // namespace Utils
+
+#endif // PATHRENDER_THREAD_POOL_HPP_
@@ -0,0 +1,306 @@
+#include "PathRender/accel/bvh.hpp"
+#include "PathRender/utils/thread_pool.hpp"
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <mutex>
+
+namespace PathRender {
+
+namespace {
+
+// Nodes with at least this many primitives split bounds and binning across threads
+constexpr uint32_t kParallelBinThreshold = 1u << 16;
+// Subtrees with at least this many primitives are built as separate tasks
+constexpr uint32_t kParallelTaskThreshold = 1u << 12;
+constexpr size_t kBinGrain = 1u << 14;
+// BuildNode::left_arena when the left child is the next node of the same arena
+constexpr uint32_t kSameArena = std::numeric_limits<uint32_t>::max();
+
+} // namespace
+
+/**
+ * Each build task appends its nodes in pre-order to its own arena, so arenas only
+ * ever hold nodes that exist. The right child of a node is built by the same task
+ * (its index is stored in offset); the left child is either the next node of the
+ * arena or, when it was handed to another task, the root of that task's arena.
+ * compact() then links the arenas into the final depth-first layout.
+ */
+struct BVH::BuildContext {
+    std::vector<BuildPrimitive> prims;
+    // A deque keeps each arena in place while other tasks add theirs
+    std::deque<std::vector<BuildNode>> arenas;
+    std::mutex arenas_mutex;
+    Utils::TaskGroup tasks;
+};
+
+void BVH::build(const std::vector<AABB>& primitive_bounds, uint32_t leaf_batch) {
+    clear();
+    m_leaf_batch = std::max(leaf_batch, 1u);
+    m_max_leaf_size = std::max(kMaxLeafSize, m_leaf_batch);
+    if (primitive_bounds.empty()) {
+        return;
+    }
+
+    const size_t count = primitive_bounds.size();
+    BuildContext context;
+    context.prims.resize(count);
+    Utils::parallel_for(count, kBinGrain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            context.prims[i] = {primitive_bounds[i], primitive_bounds[i].centroid(), static_cast<uint32_t>(i)};
+        }
+    });
+
+    context.arenas.emplace_back();
+    build_recursive(context, context.arenas.front(), 0, static_cast<uint32_t>(count), 0);
+    context.tasks.wait();
+
+    size_t node_count = 0;
+    for (const std::vector<BuildNode>& arena : context.arenas) {
+        node_count += arena.size();
+    }
+    m_nodes.reserve(node_count);
+    m_nodes.emplace_back();
+    compact(context, 0, 0, 0);
+
+    m_primitive_indices.resize(count);
+    Utils::parallel_for(count, kBinGrain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            m_primitive_indices[i] = context.prims[i].index;
+        }
+    });
+}
+
+void BVH::clear() {
+    m_nodes.clear();
+    m_primitive_indices.clear();
+    m_sah_cost = 0.0f;
+}
+
+const AABB& BVH::bounds() const {
+    static const AABB empty_bounds;
+    return m_nodes.empty() ? empty_bounds : m_nodes[0].bounds;
+}
+
+void BVH::compact(const BuildContext& context, uint32_t arena, uint32_t source_index, uint32_t node_index) {
+    const BuildNode& build_node = context.arenas[arena][source_index];
+    const BVHNode& source = build_node.node;
+    m_nodes[node_index].bounds = source.bounds;
+
+    // Accumulate the SAH cost on the way (normalized by the root area at the end)
+    const float area = source.bounds.surface_area();
+    if (source.is_leaf()) {
+        m_nodes[node_index].offset = source.offset;
+        m_nodes[node_index].count = source.count;
+        m_sah_cost += area * intersection_cost(source.count);
+    } else {
+        const uint32_t left = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+        m_nodes.emplace_back();
+        m_nodes[node_index].offset = left;
+        m_nodes[node_index].count = 0;
+        m_sah_cost += area;
+        if (build_node.left_arena == kSameArena) {
+            compact(context, arena, source_index + 1, left);
+        } else {
+            compact(context, build_node.left_arena, 0, left);
+        }
+        compact(context, arena, source.offset, left + 1);
+    }
+
+    if (node_index == 0) {
+        const float root_area = source.bounds.surface_area();
+        m_sah_cost = root_area > 0.0f ? m_sah_cost / root_area : 0.0f;
+    }
+}
+
+uint32_t BVH::build_recursive(BuildContext& context, std::vector<BuildNode>& arena, uint32_t begin, uint32_t end,
+                              int depth) {
+    std::vector<BuildPrimitive>& prims = context.prims;
+    const uint32_t count = end - begin;
+    const bool parallel = count >= kParallelBinThreshold;
+    std::mutex merge_mutex;
+
+    AABB bounds, centroid_bounds;
+    // Accumulate in locals: the outputs are shared with other blocks and would
+    // otherwise be reloaded and stored on every iteration
+    const BuildPrimitive* data = prims.data();
+    auto bound_range = [data](size_t first, size_t last, AABB& range_bounds, AABB& range_centroids) {
+        AABB local_bounds, local_centroids;
+        for (size_t i = first; i < last; ++i) {
+            local_bounds.expand(data[i].bounds);
+            local_centroids.expand(data[i].centroid);
+        }
+        range_bounds.expand(local_bounds);
+        range_centroids.expand(local_centroids);
+    };
+    if (parallel) {
+        Utils::parallel_for(count, kBinGrain, [&](size_t first, size_t last) {
+            AABB local_bounds, local_centroids;
+            bound_range(begin + first, begin + last, local_bounds, local_centroids);
+            std::lock_guard<std::mutex> lock(merge_mutex);
+            bounds.expand(local_bounds);
+            centroid_bounds.expand(local_centroids);
+        });
+    } else {
+        bound_range(begin, end, bounds, centroid_bounds);
+    }
+    // Nodes are addressed by index: the recursion below grows the arena
+    const uint32_t node_index = static_cast<uint32_t>(arena.size());
+    arena.push_back({BVHNode{}, kSameArena});
+    arena[node_index].node.bounds = bounds;
+
+    auto make_leaf = [&]() {
+        arena[node_index].node.offset = begin;
+        arena[node_index].node.count = count;
+        return node_index;
+    };
+
+    // Invariant: a node at depth d has at most m_max_leaf_size << (kMaxDepth - d)
+    // primitives, so median splits alone still reach leaves by kMaxDepth
+    if (count <= 1 || depth == kMaxDepth) {
+        return make_leaf();
+    }
+
+    // Binned SAH: bucket centroids along each axis and evaluate every bin boundary.
+    // Cost model: traversal = 1, intersection = 1 per batch of leaf_batch primitives.
+    float axis_min[3], axis_scale[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        axis_min[axis] = AABB::axis(centroid_bounds.min, axis);
+        const float extent = AABB::axis(centroid_bounds.max, axis) - axis_min[axis];
+        axis_scale[axis] = extent > 0.0f ? kBinCount / extent : 0.0f;
+    }
+
+    AABB bin_bounds[3][kBinCount];
+    uint32_t bin_counts[3][kBinCount] = {};
+    auto bin_range = [data, &axis_min, &axis_scale](size_t first, size_t last, AABB (&range_bounds)[3][kBinCount],
+                                                    uint32_t (&range_counts)[3][kBinCount]) {
+        for (int axis = 0; axis < 3; ++axis) {
+            const float min = axis_min[axis];
+            const float scale = axis_scale[axis];
+            if (scale == 0.0f) {
+                continue;
+            }
+            for (size_t i = first; i < last; ++i) {
+                int bin = static_cast<int>((AABB::axis(data[i].centroid, axis) - min) * scale);
+                bin = std::min(bin, kBinCount - 1);
+                range_counts[axis][bin]++;
+                range_bounds[axis][bin].expand(data[i].bounds);
+            }
+        }
+    };
+    if (parallel) {
+        // Each block bins into its own histogram; histograms are merged under the lock
+        Utils::parallel_for(count, kBinGrain, [&](size_t first, size_t last) {
+            AABB local_bounds[3][kBinCount];
+            uint32_t local_counts[3][kBinCount] = {};
+            bin_range(begin + first, begin + last, local_bounds, local_counts);
+            std::lock_guard<std::mutex> lock(merge_mutex);
+            for (int axis = 0; axis < 3; ++axis) {
+                for (int b = 0; b < kBinCount; ++b) {
+                    bin_counts[axis][b] += local_counts[axis][b];
+                    bin_bounds[axis][b].expand(local_bounds[axis][b]);
+                }
+            }
+        });
+    } else {
+        bin_range(begin, end, bin_bounds, bin_counts);
+    }
+
+    int best_axis = -1;
+    int best_split = 0;
+    float best_cost = std::numeric_limits<float>::infinity();
+    const float leaf_cost = intersection_cost(count);
+    const float parent_area = bounds.surface_area();
+
+    for (int axis = 0; axis < 3; ++axis) {
+        if (axis_scale[axis] == 0.0f) {
+            continue;
+        }
+
+        // Sweep from the right to get the area/count of every suffix
+        float right_area[kBinCount];
+        uint32_t right_count[kBinCount];
+        AABB accum;
+        uint32_t accum_count = 0;
+        for (int b = kBinCount - 1; b > 0; --b) {
+            accum.expand(bin_bounds[axis][b]);
+            accum_count += bin_counts[axis][b];
+            right_area[b] = accum.surface_area();
+            right_count[b] = accum_count;
+        }
+
+        accum = AABB();
+        accum_count = 0;
+        for (int b = 0; b < kBinCount - 1; ++b) {
+            accum.expand(bin_bounds[axis][b]);
+            accum_count += bin_counts[axis][b];
+            if (accum_count == 0 || right_count[b + 1] == 0) {
+                continue;
+            }
+            float cost = 1.0f + (accum.surface_area() * intersection_cost(accum_count) +
+                                 right_area[b + 1] * intersection_cost(right_count[b + 1])) / parent_area;
+            if (cost < best_cost) {
+                best_cost = cost;
+                best_axis = axis;
+                best_split = b;
+            }
+        }
+    }
+
+    uint32_t mid;
+    if (best_axis == -1) {
+        // All centroids coincide: SAH can't separate them, split by count
+        if (count <= m_max_leaf_size) {
+            return make_leaf();
+        }
+        mid = begin + count / 2;
+    } else {
+        if (count <= m_max_leaf_size && best_cost >= leaf_cost) {
+            return make_leaf();
+        }
+
+        const float min = axis_min[best_axis];
+        const float scale = axis_scale[best_axis];
+        auto it = std::partition(prims.begin() + begin, prims.begin() + end,
+            [&](const BuildPrimitive& prim) {
+                int bin = static_cast<int>((AABB::axis(prim.centroid, best_axis) - min) * scale);
+                return std::min(bin, kBinCount - 1) <= best_split;
+            });
+        mid = static_cast<uint32_t>(it - prims.begin());
+        if (mid == begin || mid == end) {
+            mid = begin + count / 2;
+        }
+
+        // Skewed splits that peel off a few primitives per level would break the
+        // depth invariant; fall back to the centroid median on the SAH axis
+        const uint64_t child_limit = static_cast<uint64_t>(m_max_leaf_size) << std::min(kMaxDepth - depth - 1, 32);
+        if (std::max(mid - begin, end - mid) > child_limit) {
+            mid = begin + count / 2;
+            std::nth_element(prims.begin() + begin, prims.begin() + mid, prims.begin() + end,
+                [best_axis](const BuildPrimitive& a, const BuildPrimitive& b) {
+                    return AABB::axis(a.centroid, best_axis) < AABB::axis(b.centroid, best_axis);
+                });
+        }
+    }
+
+    if (mid - begin >= kParallelTaskThreshold) {
+        std::vector<BuildNode>* left_arena;
+        {
+            std::lock_guard<std::mutex> lock(context.arenas_mutex);
+            arena[node_index].left_arena = static_cast<uint32_t>(context.arenas.size());
+            left_arena = &context.arenas.emplace_back();
+        }
+        context.tasks.run([this, &context, left_arena, begin, mid, depth] {
+            build_recursive(context, *left_arena, begin, mid, depth + 1);
+        });
+    } else {
+        build_recursive(context, arena, begin, mid, depth + 1);
+    }
+    const uint32_t right = build_recursive(context, arena, mid, end, depth + 1);
+    arena[node_index].node.offset = right;
+    arena[node_index].node.count = 0;
+    return node_index;
+}
+
+} // namespace PathRender
@@ -0,0 +1,255 @@
+#include "PathRender/accel/simd.hpp"
+#include "simd_kernels.hpp"
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#if PATHRENDER_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+namespace PathRender {
+
+namespace {
+
+SimdLevel detect_cpu_level() {
+#if PATHRENDER_SIMD_X86
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool os_saves_ymm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+    __cpuidex(info, 7, 0);
+    if (os_saves_ymm && (info[1] & (1 << 5))) {
+        return SimdLevel::AVX2;
+    }
+#endif
+    return SimdLevel::SSE;  // SSE2 is part of x86-64
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+SimdLevel cpu_level() {
+    static const SimdLevel level = detect_cpu_level();
+    return level;
+}
+
+SimdLevel initial_level() {
+    SimdLevel level = cpu_level();
+    if (const char* env = std::getenv("PATHRENDER_SIMD")) {
+        if (std::strcmp(env, "scalar") == 0) {
+            level = SimdLevel::Scalar;
+        } else if (std::strcmp(env, "sse") == 0) {
+            level = std::min(level, SimdLevel::SSE);
+        } else if (std::strcmp(env, "avx2") != 0) {
+            std::cerr << "PATHRENDER_SIMD inválido: " << env << std::endl;
+        }
+    }
+    return level;
+}
+
+std::atomic<SimdLevel>& current_level() {
+    static std::atomic<SimdLevel> level{initial_level()};
+    return level;
+}
+
+} // namespace
+
+SimdLevel simd_level() {
+    return current_level().load(std::memory_order_relaxed);
+}
+
+void set_simd_level(SimdLevel level) {
+    current_level().store(std::min(level, cpu_level()), std::memory_order_relaxed);
+}
+
+uint32_t simd_width() {
+    switch (simd_level()) {
+        case SimdLevel::AVX2: return 8;
+        case SimdLevel::SSE: return 4;
+        default: return 1;
+    }
+}
+
+const char* simd_level_name(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::SSE: return "sse";
+        default: return "scalar";
+    }
+}
+
+namespace SimdKernels {
+
+bool intersect_triangles_scalar(const TriangleSoA& triangles, const Point3* vertices,
+                                uint32_t first, uint32_t count, const Ray& ray, float t_min, float& t_max,
+                                uint32_t& primitive, float& u, float& v) {
+    bool found = false;
+    for (uint32_t i = first; i < first + count; ++i) {
+        if (triangles.intersect(i, vertices, ray, t_min, t_max, t_max, u, v)) {
+            primitive = i;
+            found = true;
+        }
+    }
+    return found;
+}
+
+uint32_t intersect_boxes_scalar(const float* boxes, uint32_t width, const SimdRay& ray,
+                                float t_min, float t_max, float* t_entry) {
+    uint32_t mask = 0;
+    for (uint32_t lane = 0; lane < width; ++lane) {
+        float t0 = t_min, t1 = t_max;
+        for (int axis = 0; axis < 3; ++axis) {
+            float near = (boxes[axis * width + lane] - ray.origin[axis]) * ray.inv_dir[axis];
+            float far = (boxes[(axis + 3) * width + lane] - ray.origin[axis]) * ray.inv_dir[axis];
+            if (near > far) {
+                std::swap(near, far);
+            }
+            t0 = near > t0 ? near : t0;
+            t1 = far < t1 ? far : t1;
+        }
+        t_entry[lane] = t0;
+        if (t0 <= t1) {
+            mask |= 1u << lane;
+        }
+    }
+    return mask;
+}
+
+#if PATHRENDER_SIMD_X86
+
+bool intersect_triangles_sse(const TriangleSoA& triangles, const Point3* vertices,
+                             uint32_t first, uint32_t count, const Ray& ray, float t_min, float& t_max,
+                             uint32_t& primitive, float& u, float& v) {
+    const __m128 dx = _mm_set1_ps(ray.direction.x);
+    const __m128 dy = _mm_set1_ps(ray.direction.y);
+    const __m128 dz = _mm_set1_ps(ray.direction.z);
+    const __m128 ox = _mm_set1_ps(ray.origin.x);
+    const __m128 oy = _mm_set1_ps(ray.origin.y);
+    const __m128 oz = _mm_set1_ps(ray.origin.z);
+    const __m128 epsilon = _mm_set1_ps(t_min);
+    const __m128 neg_epsilon = _mm_set1_ps(-t_min);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+
+    bool found = false;
+    for (uint32_t base = 0; base < count; base += 4) {
+        const uint32_t i = first + base;
+        const __m128 valid = _mm_cmplt_ps(lanes, _mm_set1_ps(static_cast<float>(count - base)));
+
+        const __m128 e1x = _mm_loadu_ps(&triangles.e1_x[i]);
+        const __m128 e1y = _mm_loadu_ps(&triangles.e1_y[i]);
+        const __m128 e1z = _mm_loadu_ps(&triangles.e1_z[i]);
+        const __m128 e2x = _mm_loadu_ps(&triangles.e2_x[i]);
+        const __m128 e2y = _mm_loadu_ps(&triangles.e2_y[i]);
+        const __m128 e2z = _mm_loadu_ps(&triangles.e2_z[i]);
+
+        // Same operations, in the same order, as TriangleSoA::intersect
+        const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+        const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+        const __m128 parallel = _mm_and_ps(_mm_cmpgt_ps(det, neg_epsilon), _mm_cmplt_ps(det, epsilon));
+        const __m128 inv_det = _mm_div_ps(one, det);
+
+        // SSE2 has no gather: v0 is read lane by lane from the shared vertex buffer
+        const Point3& a = vertices[triangles.v0_index[i]];
+        const Point3& b = vertices[triangles.v0_index[i + 1]];
+        const Point3& c = vertices[triangles.v0_index[i + 2]];
+        const Point3& d = vertices[triangles.v0_index[i + 3]];
+        const __m128 sx = _mm_sub_ps(ox, _mm_setr_ps(a.x, b.x, c.x, d.x));
+        const __m128 sy = _mm_sub_ps(oy, _mm_setr_ps(a.y, b.y, c.y, d.y));
+        const __m128 sz = _mm_sub_ps(oz, _mm_setr_ps(a.z, b.z, c.z, d.z));
+        const __m128 hu = _mm_mul_ps(inv_det,
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)));
+        const __m128 bad_u = _mm_or_ps(
+            _mm_and_ps(_mm_cmplt_ps(hu, zero), _mm_cmpgt_ps(_mm_sub_ps(zero, hu), epsilon)),
+            _mm_and_ps(_mm_cmpgt_ps(hu, one), _mm_cmpgt_ps(_mm_sub_ps(hu, one), epsilon)));
+
+        const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+        const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+        const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+        const __m128 hv = _mm_mul_ps(inv_det,
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)));
+        const __m128 huv = _mm_add_ps(hu, hv);
+        const __m128 bad_v = _mm_or_ps(
+            _mm_and_ps(_mm_cmplt_ps(hv, zero), _mm_cmpgt_ps(_mm_sub_ps(zero, hv), epsilon)),
+            _mm_and_ps(_mm_cmpgt_ps(huv, one), _mm_cmpgt_ps(_mm_sub_ps(huv, one), epsilon)));
+
+        const __m128 ht = _mm_mul_ps(inv_det,
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)));
+        __m128 good = _mm_andnot_ps(_mm_or_ps(parallel, _mm_or_ps(bad_u, bad_v)), valid);
+        good = _mm_and_ps(good, _mm_and_ps(_mm_cmpgt_ps(ht, epsilon), _mm_cmplt_ps(ht, _mm_set1_ps(t_max))));
+
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(good));
+        if (mask) {
+            alignas(16) float ts[4], us[4], vs[4];
+            _mm_store_ps(ts, ht);
+            _mm_store_ps(us, hu);
+            _mm_store_ps(vs, hv);
+            while (mask) {
+                const int lane = Simd::lowest_bit(mask);
+                mask &= mask - 1;
+                if (ts[lane] < t_max) {
+                    t_max = ts[lane];
+                    primitive = i + lane;
+                    u = us[lane];
+                    v = vs[lane];
+                    found = true;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+#endif
+
+} // namespace SimdKernels
+
+namespace Simd {
+
+bool intersect_triangles(const TriangleSoA& triangles, const Point3* vertices,
+                         uint32_t first, uint32_t count, const Ray& ray, float t_min, float& t_max,
+                         uint32_t& primitive, float& u, float& v) {
+    switch (simd_level()) {
+#if PATHRENDER_SIMD_X86
+        case SimdLevel::AVX2:
+            return SimdKernels::intersect_triangles_avx2(triangles, vertices, first, count, ray, t_min, t_max, primitive, u, v);
+        case SimdLevel::SSE:
+            return SimdKernels::intersect_triangles_sse(triangles, vertices, first, count, ray, t_min, t_max, primitive, u, v);
+#endif
+        default:
+            return SimdKernels::intersect_triangles_scalar(triangles, vertices, first, count, ray, t_min, t_max, primitive, u, v);
+    }
+}
+
+uint32_t intersect_boxes4_scalar(const float* boxes, const SimdRay& ray, float t_min, float t_max, float* t_entry) {
+    return SimdKernels::intersect_boxes_scalar(boxes, 4, ray, t_min, t_max, t_entry);
+}
+
+uint32_t intersect_boxes8(const float* boxes, const SimdRay& ray, float t_min, float t_max, float* t_entry) {
+#if PATHRENDER_SIMD_X86
+    if (simd_level() == SimdLevel::AVX2) {
+        return SimdKernels::intersect_boxes8_avx2(boxes, ray, t_min, t_max, t_entry);
+    }
+#endif
+    return SimdKernels::intersect_boxes_scalar(boxes, 8, ray, t_min, t_max, t_entry);
+}
+
+} // namespace Simd
+
+} // namespace PathRender
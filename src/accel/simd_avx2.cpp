@@ -0,0 +1,121 @@
+// Kernels AVX2 (8 primitivos por vez). Compilados com target("avx2") apenas
+// nestas funções; só são chamados quando a CPU em execução suporta AVX2.
+#include "simd_kernels.hpp"
+
+#if PATHRENDER_SIMD_X86
+#include <immintrin.h>
+
+namespace PathRender {
+namespace SimdKernels {
+
+// The v0 gather below reads Point3 as three packed floats
+static_assert(sizeof(Point3) == 3 * sizeof(float), "Point3 must be three packed floats");
+
+PATHRENDER_TARGET_AVX2
+bool intersect_triangles_avx2(const TriangleSoA& triangles, const Point3* vertices,
+                              uint32_t first, uint32_t count, const Ray& ray, float t_min, float& t_max,
+                              uint32_t& primitive, float& u, float& v) {
+    const __m256 dx = _mm256_set1_ps(ray.direction.x);
+    const __m256 dy = _mm256_set1_ps(ray.direction.y);
+    const __m256 dz = _mm256_set1_ps(ray.direction.z);
+    const __m256 ox = _mm256_set1_ps(ray.origin.x);
+    const __m256 oy = _mm256_set1_ps(ray.origin.y);
+    const __m256 oz = _mm256_set1_ps(ray.origin.z);
+    const __m256 epsilon = _mm256_set1_ps(t_min);
+    const __m256 neg_epsilon = _mm256_set1_ps(-t_min);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 lanes = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    const __m256i three = _mm256_set1_epi32(3);
+    const float* coordinates = &vertices->x;
+
+    bool found = false;
+    for (uint32_t base = 0; base < count; base += 8) {
+        const uint32_t i = first + base;
+        const __m256 valid = _mm256_cmp_ps(lanes, _mm256_set1_ps(static_cast<float>(count - base)), _CMP_LT_OQ);
+
+        const __m256 e1x = _mm256_loadu_ps(&triangles.e1_x[i]);
+        const __m256 e1y = _mm256_loadu_ps(&triangles.e1_y[i]);
+        const __m256 e1z = _mm256_loadu_ps(&triangles.e1_z[i]);
+        const __m256 e2x = _mm256_loadu_ps(&triangles.e2_x[i]);
+        const __m256 e2y = _mm256_loadu_ps(&triangles.e2_y[i]);
+        const __m256 e2z = _mm256_loadu_ps(&triangles.e2_z[i]);
+
+        // Same operations, in the same order, as TriangleSoA::intersect (no FMA contraction)
+        const __m256 px = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+        const __m256 py = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+        const __m256 pz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+        const __m256 det = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, px), _mm256_mul_ps(e1y, py)), _mm256_mul_ps(e1z, pz));
+        const __m256 parallel = _mm256_and_ps(_mm256_cmp_ps(det, neg_epsilon, _CMP_GT_OQ), _mm256_cmp_ps(det, epsilon, _CMP_LT_OQ));
+        const __m256 inv_det = _mm256_div_ps(one, det);
+
+        // v0 is gathered from the shared vertex buffer (float offset 3 * index)
+        const __m256i v0 = _mm256_mullo_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&triangles.v0_index[i])), three);
+        const __m256 sx = _mm256_sub_ps(ox, _mm256_i32gather_ps(coordinates, v0, 4));
+        const __m256 sy = _mm256_sub_ps(oy, _mm256_i32gather_ps(coordinates + 1, v0, 4));
+        const __m256 sz = _mm256_sub_ps(oz, _mm256_i32gather_ps(coordinates + 2, v0, 4));
+        const __m256 hu = _mm256_mul_ps(inv_det,
+            _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, px), _mm256_mul_ps(sy, py)), _mm256_mul_ps(sz, pz)));
+        const __m256 bad_u = _mm256_or_ps(
+            _mm256_and_ps(_mm256_cmp_ps(hu, zero, _CMP_LT_OQ), _mm256_cmp_ps(_mm256_sub_ps(zero, hu), epsilon, _CMP_GT_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(hu, one, _CMP_GT_OQ), _mm256_cmp_ps(_mm256_sub_ps(hu, one), epsilon, _CMP_GT_OQ)));
+
+        const __m256 qx = _mm256_sub_ps(_mm256_mul_ps(sy, e1z), _mm256_mul_ps(sz, e1y));
+        const __m256 qy = _mm256_sub_ps(_mm256_mul_ps(sz, e1x), _mm256_mul_ps(sx, e1z));
+        const __m256 qz = _mm256_sub_ps(_mm256_mul_ps(sx, e1y), _mm256_mul_ps(sy, e1x));
+        const __m256 hv = _mm256_mul_ps(inv_det,
+            _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)), _mm256_mul_ps(dz, qz)));
+        const __m256 huv = _mm256_add_ps(hu, hv);
+        const __m256 bad_v = _mm256_or_ps(
+            _mm256_and_ps(_mm256_cmp_ps(hv, zero, _CMP_LT_OQ), _mm256_cmp_ps(_mm256_sub_ps(zero, hv), epsilon, _CMP_GT_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(huv, one, _CMP_GT_OQ), _mm256_cmp_ps(_mm256_sub_ps(huv, one), epsilon, _CMP_GT_OQ)));
+
+        const __m256 ht = _mm256_mul_ps(inv_det,
+            _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)), _mm256_mul_ps(e2z, qz)));
+        __m256 good = _mm256_andnot_ps(_mm256_or_ps(parallel, _mm256_or_ps(bad_u, bad_v)), valid);
+        good = _mm256_and_ps(good, _mm256_and_ps(_mm256_cmp_ps(ht, epsilon, _CMP_GT_OQ), _mm256_cmp_ps(ht, _mm256_set1_ps(t_max), _CMP_LT_OQ)));
+
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(good));
+        if (mask) {
+            alignas(32) float ts[8], us[8], vs[8];
+            _mm256_store_ps(ts, ht);
+            _mm256_store_ps(us, hu);
+            _mm256_store_ps(vs, hv);
+            while (mask) {
+                const int lane = Simd::lowest_bit(mask);
+                mask &= mask - 1;
+                if (ts[lane] < t_max) {
+                    t_max = ts[lane];
+                    primitive = i + lane;
+                    u = us[lane];
+                    v = vs[lane];
+                    found = true;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+PATHRENDER_TARGET_AVX2
+uint32_t intersect_boxes8_avx2(const float* boxes, const SimdRay& ray, float t_min, float t_max, float* t_entry) {
+    __m256 t0 = _mm256_set1_ps(t_min);
+    __m256 t1 = _mm256_set1_ps(t_max);
+    for (int axis = 0; axis < 3; ++axis) {
+        const __m256 origin = _mm256_set1_ps(ray.origin[axis]);
+        const __m256 inv_dir = _mm256_set1_ps(ray.inv_dir[axis]);
+        const __m256 a = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boxes + axis * 8), origin), inv_dir);
+        const __m256 b = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boxes + (axis + 3) * 8), origin), inv_dir);
+        // max/min return the second operand on NaN, keeping the running interval
+        t0 = _mm256_max_ps(_mm256_min_ps(a, b), t0);
+        t1 = _mm256_min_ps(_mm256_max_ps(a, b), t1);
+    }
+    _mm256_storeu_ps(t_entry, t0);
+    return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(t0, t1, _CMP_LE_OQ)));
+}
+
+} // namespace SimdKernels
+} // namespace PathRender
+
+#endif
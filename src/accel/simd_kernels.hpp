@@ -0,0 +1,45 @@
+#ifndef PATHRENDER_SIMD_KERNELS_HPP_
+#define PATHRENDER_SIMD_KERNELS_HPP_
+
+// Kernels por conjunto de instruções; a escolha entre eles é feita em simd.cpp
+
+#include "PathRender/accel/simd.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PATHRENDER_SIMD_X86 1
+#else
+#define PATHRENDER_SIMD_X86 0
+#endif
+
+#if PATHRENDER_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#define PATHRENDER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PATHRENDER_TARGET_AVX2
+#endif
+
+namespace PathRender {
+namespace SimdKernels {
+
+bool intersect_triangles_scalar(const TriangleSoA& triangles, const Point3* vertices,
+                                uint32_t first, uint32_t count, const Ray& ray, float t_min, float& t_max,
+                                uint32_t& primitive, float& u, float& v);
+
+uint32_t intersect_boxes_scalar(const float* boxes, uint32_t width, const SimdRay& ray,
+                                float t_min, float t_max, float* t_entry);
+
+#if PATHRENDER_SIMD_X86
+bool intersect_triangles_sse(const TriangleSoA& triangles, const Point3* vertices,
+                             uint32_t first, uint32_t count, const Ray& ray, float t_min, float& t_max,
+                             uint32_t& primitive, float& u, float& v);
+
+bool intersect_triangles_avx2(const TriangleSoA& triangles, const Point3* vertices,
+                              uint32_t first, uint32_t count, const Ray& ray, float t_min, float& t_max,
+                              uint32_t& primitive, float& u, float& v);
+
+uint32_t intersect_boxes8_avx2(const float* boxes, const SimdRay& ray, float t_min, float t_max, float* t_entry);
+#endif
+
+} // namespace SimdKernels
+} // namespace PathRender
+
+#endif // PATHRENDER_SIMD_KERNELS_HPP_
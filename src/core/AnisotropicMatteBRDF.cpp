@@ -1,57 +1,131 @@
 #include "PathRender/core/AnisotropicMatteBRDF.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace PathRender {
 
+namespace {
+
+// Share of cosine-weighted directions in TransportMode::Importance
+constexpr float kImportanceCosineShare = 0.25f;
+
+} // namespace
+
 // Static helper implementation (Math)
 Vector3 AnisotropicMatteBRDF::reflect(const Vector3& v, const Vector3& n) {
     return v - n * 2.0f * v.dot(n);
 }
 
-bool AnisotropicMatteBRDF::scatter(const Ray& r_in, const HitRecord& hit, ScatterRecord& srec, std::mt19937& rng) const {
-    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+// The lobe perturbs the perfect reflection R by (nu x) U + (nv y) V, where (U, V) is a
+// basis around R and (x, y) is a point of the unit ball projected onto the disk:
+// density 3 / (2 pi) sqrt(1 - x^2 - y^2). The direction is the central (gnomonic)
+// projection of the point R + a U + b V of the plane at distance 1 from the origin.
+float AnisotropicMatteBRDF::lobe_pdf(const HitRecord& hit, const Vector3& wo, const Vector3& wi) const {
+    if (nu <= 0.0f || nv <= 0.0f || wi.dot(hit.normal) <= 0.0f) {
+        return 0.0f;  // A zero roughness collapses the lobe onto a line: no density
+    }
+    const Vector3 reflected = reflect(-wo, hit.normal);
+    const float cos_gamma = wi.dot(reflected);
+    if (cos_gamma <= 0.0f) {
+        return 0.0f;
+    }
+    Vector3 r_u, r_v;
+    Utils::build_orthonormal_basis(reflected, r_u, r_v);
+    const float x = wi.dot(r_u) / cos_gamma / nu;
+    const float y = wi.dot(r_v) / cos_gamma / nv;
+    const float radius_squared = x * x + y * y;
+    if (radius_squared >= 1.0f) {
+        return 0.0f;
+    }
+    const float plane_density = 1.5f / static_cast<float>(M_PI) * std::sqrt(1.0f - radius_squared) / (nu * nv);
+    // Plane area -> solid angle at distance 1: dA = d_omega / cos^3
+    return plane_density / (cos_gamma * cos_gamma * cos_gamma);
+}
 
-    // 1. Calculate Perfect Reflection
-    Vector3 reflected = reflect(r_in.direction, hit.normal);
+float AnisotropicMatteBRDF::pdf(const HitRecord& hit, const Vector3& wo, const Vector3& wi, TransportMode mode) const {
+    const float lobe = lobe_pdf(hit, wo, wi);
+    if (mode == TransportMode::Radiance) {
+        return lobe;
+    }
+    const float cos_theta = std::max(wi.dot(hit.normal), 0.0f);
+    return kImportanceCosineShare * cos_theta / static_cast<float>(M_PI) + (1.0f - kImportanceCosineShare) * lobe;
+}
 
-    // 2. Build the Surface Basis (T, B, N)
-    Vector3 tangent, bitangent;
-    
-    Utils::build_orthonormal_basis(hit.normal, tangent, bitangent);
+Color AnisotropicMatteBRDF::eval(const HitRecord& hit, const Vector3& wo, const Vector3& wi) const {
+    const float cos_theta = wi.dot(hit.normal);
+    if (cos_theta <= 0.0f) {
+        return Color(0.0, 0.0, 0.0);
+    }
+    // Samples are weighted by the color, so f cos / pdf = color
+    return color * (lobe_pdf(hit, wo, wi) / cos_theta);
+}
 
-    // 3. Generate Random Point in Unit Sphere
-    auto random_in_unit_sphere = [&]() {
-        while(true) {
-            float x = dist(rng) * 2.0f - 1.0f;
-            float y = dist(rng) * 2.0f - 1.0f;
-            float z = dist(rng) * 2.0f - 1.0f;
-            if(x*x + y*y + z*z <= 1) return Vector3(x,y,z);
-        }
-    };
-    Vector3 rand_vec = random_in_unit_sphere();
-
-    // 4. Apply Anisotropic Scaling
-    // Instead of adding 'rand_vec * fuzz', we scale the components differently.
-    // We treat the reflection direction as the "Z-axis" of our perturbation space.
-    
-    // We need a basis aligned with the REFLECTION vector, not the SURFACE normal
-    Vector3 r_u, r_v;
-    Utils::build_orthonormal_basis(reflected, r_u, r_v);
+bool AnisotropicMatteBRDF::sample(const HitRecord& hit, const Vector3& wo, Sampler& sampler, ScatterRecord& srec,
+                                  TransportMode mode) const {
+    // A single lobe from the camera: the lobe choice dimension is then skipped so the
+    // direction comes from one 2D pair
+    bool cosine = false;
+    if (mode == TransportMode::Importance) {
+        cosine = sampler.get_1d() < kImportanceCosineShare;
+    } else {
+        sampler.skip(1);
+    }
+    const float u1 = sampler.get_1d();
+    const float u2 = sampler.get_1d();
+
+    Vector3 final_direction;
+    bool mirror = false;
+    if (cosine) {
+        final_direction = Utils::cosine_sample_hemisphere(hit.normal, u1, u2);
+    } else {
+        // 1. Calculate Perfect Reflection
+        Vector3 reflected = reflect(-wo, hit.normal);
+
+        // 2. Point of the disk with the density of the unit ball projected onto it, in
+        // closed form: P(r < R) = 1 - (1 - R^2)^(3/2)
+        const float radius = std::sqrt(std::max(0.0f, 1.0f - std::pow(1.0f - u1, 2.0f / 3.0f)));
+        const float angle = 2.0f * static_cast<float>(M_PI) * u2;
+        const float x = radius * std::cos(angle);
+        const float y = radius * std::sin(angle);
 
-    // Scale the perturbation:
-    // If nu is high (0.8), we add a lot of noise in the U direction (blurry).
-    // If nv is low (0.1), we add very little noise in the V direction (sharp).
-    Vector3 perturbation = (r_u * rand_vec.x * nu) + (r_v * rand_vec.y * nv) + (reflected * rand_vec.z * 0.0f);
+        // 3. Apply Anisotropic Scaling
+        // We need a basis aligned with the REFLECTION vector, not the SURFACE normal
+        Vector3 r_u, r_v;
+        Utils::build_orthonormal_basis(reflected, r_u, r_v);
 
-    Vector3 final_direction = (reflected + perturbation).normalized();
+        // Scale the perturbation:
+        // If nu is high (0.8), we add a lot of noise in the U direction (blurry).
+        // If nv is low (0.1), we add very little noise in the V direction (sharp).
+        Vector3 perturbation = (r_u * x * nu) + (r_v * y * nv);
 
-    // 5. Safety check: Ensure we didn't scatter into the surface
-    if (final_direction.dot(hit.normal) <= 0) {
-        // Simple fix: clamp it or just return the perfect reflection
-        final_direction = reflected; 
+        final_direction = (reflected + perturbation).normalized();
+
+        // 4. Safety check: Ensure we didn't scatter into the surface
+        if (final_direction.dot(hit.normal) <= 0) {
+            final_direction = reflected;
+            mirror = true;
+        }
     }
 
     srec.out_ray = Ray(hit.point + hit.normal * 0.001f, final_direction);
     srec.attenuation = color;
+    if (mirror) {
+        // The lost part of the lobe becomes the perfect reflection, a delta lobe, which
+        // light subpaths only reach through the lobe share
+        srec.pdf = 0.0f;
+        if (mode == TransportMode::Importance) {
+            srec.attenuation = color / (1.0 - kImportanceCosineShare);
+        }
+        return true;
+    }
+    srec.pdf = pdf(hit, wo, final_direction, mode);
+    if (mode == TransportMode::Importance) {
+        if (srec.pdf <= 0.0f) {
+            return false;
+        }
+        // Flux leaves along final_direction: f(wo = final_direction, wi = wo)
+        srec.attenuation = eval(hit, final_direction, wo) * (final_direction.dot(hit.normal) / srec.pdf);
+    }
     return true;
 }
 
@@ -1,17 +1,9 @@
 #include "PathRender/core/DieletricBRDF.hpp"
+#include "PathRender/utils/math_utils.hpp"
+#include <algorithm>
 
 namespace PathRender {
 
-Vector3 DielectricBRDF::random_unit_vector(std::mt19937& rng) const {
-    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-    float z = dist(rng) * 2.0f - 1.0f;
-    float a = dist(rng) * M_PI * 2.0f;
-    float r = sqrt(1.0f - z * z);
-    float x = r * cos(a);
-    float y = r * sin(a);
-    return Vector3(x, y, z);
-}
-
 // Static helper implementation (Math)
 Vector3 DielectricBRDF::reflect(const Vector3& v, const Vector3& n) {
     return v - n * 2.0f * v.dot(n);
@@ -31,23 +23,35 @@ float DielectricBRDF::reflectance(float cosine, float ref_idx) {
     return r0 + (1 - r0) * pow((1 - cosine), 5);
 }
 
+Color DielectricBRDF::eval(const HitRecord& hit, const Vector3& /*wo*/, const Vector3& wi) const {
+    if (wi.dot(hit.normal) <= 0.0f) {
+        return Color(0.0, 0.0, 0.0);
+    }
+    // Diffuse lobe only: reflection and refraction are delta lobes
+    return color * (kd / (kd + kt) / M_PI);
+}
+
+float DielectricBRDF::pdf(const HitRecord& hit, const Vector3& /*wo*/, const Vector3& wi,
+                          TransportMode /*mode*/) const {
+    return static_cast<float>(kd / (kd + kt) * std::max(0.0f, wi.dot(hit.normal)) / M_PI);
+}
+
 // The main scatter function
-bool DielectricBRDF::scatter(const Ray& r_in, const HitRecord& hit, ScatterRecord& srec, std::mt19937& rng) const {
-    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+bool DielectricBRDF::sample(const HitRecord& hit, const Vector3& wo, Sampler& sampler, ScatterRecord& srec,
+                            TransportMode mode) const {
 
     double total = kd + kt;
-    double rayProbability = dist(rng) * total; 
+    double rayProbability = sampler.get_1d() * total; 
     if (rayProbability < kd) {
-        Vector3 direction = (hit.normal + random_unit_vector(rng)).normalized();
-        
-        // Catch degenerate rays
-        if (direction.length() < 0.001f) {
-            direction = hit.normal;
-        } 
+        // Cosine-weighted from the next 2D pair
+        const float u1 = sampler.get_1d();
+        const float u2 = sampler.get_1d();
+        Vector3 direction = Utils::cosine_sample_hemisphere(hit.normal, u1, u2);
 
-        Point3 hit_point = r_in.origin + r_in.direction * hit.t;
-        srec.out_ray = Ray(hit_point + hit.normal * 0.01, direction);
+        srec.out_ray = Ray(hit.point + hit.normal * 0.01, direction);
         srec.attenuation = color;
+        // The lobe is picked with kd / total
+        srec.pdf = static_cast<float>(kd / total * std::max(0.0f, direction.dot(hit.normal)) / M_PI);
         return true;
     } else {
         // 1. attenuation is always 1 (glass doesn't absorb light, usually)
@@ -56,9 +60,9 @@ bool DielectricBRDF::scatter(const Ray& r_in, const HitRecord& hit, ScatterRecor
         // 2. Determine refraction ratio
         // If front_face is true, we are going Air -> Glass (1.0 / ir)
         // If front_face is false, we are going Glass -> Air (ir / 1.0)
-        float refraction_ratio = hit.front_face ? (1.0f / ir) : ir;
+        float refraction_ratio = DielectricBRDF::refraction_ratio(hit);
 
-        Vector3 unit_direction = r_in.direction.normalized();
+        Vector3 unit_direction = -wo;
         
         // 3. Check for Total Internal Reflection
         // Sometimes light cannot escape the glass (critical angle)
@@ -68,7 +72,7 @@ bool DielectricBRDF::scatter(const Ray& r_in, const HitRecord& hit, ScatterRecor
         bool cannot_refract = refraction_ratio * sin_theta > 1.0;
         Vector3 direction;
 
-        if (cannot_refract || reflectance(cos_theta, refraction_ratio) > dist(rng)) {
+        if (cannot_refract || reflectance(cos_theta, refraction_ratio) > sampler.get_1d()) {
             // Must Reflect
             direction = reflect(unit_direction, hit.normal);
         } else {
@@ -77,6 +81,10 @@ bool DielectricBRDF::scatter(const Ray& r_in, const HitRecord& hit, ScatterRecor
         }
 
         srec.out_ray = Ray(hit.point, direction);
+        srec.pdf = 0.0f;  // Delta lobes
+        if (mode == TransportMode::Importance) {
+            srec.attenuation = srec.attenuation * flux_scale(hit, srec);
+        }
         return true;
     }
 }
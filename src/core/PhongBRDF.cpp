@@ -1,66 +1,107 @@
 #include "PathRender/core/PhongBRDF.hpp"
+#include "PathRender/utils/math_utils.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace PathRender {
 
-double PhongBRDF::random(std::mt19937& rng) const {
-    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-    return dist(rng);
+namespace {
+
+// Density of normalize(r + fuzz * u) for u uniform on the unit sphere (0 < fuzz <= 1):
+// the ray along wi crosses the sphere of radius fuzz around r at t = a -+ s, and each
+// crossing contributes t^2 / (4 pi fuzz^2 |cos|) with |cos| = s / fuzz
+float fuzzy_reflection_pdf(const Vector3& reflected, const Vector3& wi, float fuzz) {
+    const float a = reflected.dot(wi);
+    const float discriminant = a * a - 1.0f + fuzz * fuzz;
+    if (a <= 0.0f || discriminant <= 0.0f) {
+        return 0.0f;
+    }
+    const float s = std::sqrt(discriminant);
+    return (a * a + discriminant) / (2.0f * static_cast<float>(M_PI) * fuzz * s);
+}
+
+} // namespace
+
+double PhongBRDF::random(Sampler& sampler) const {
+    return sampler.get_1d();
 };
 
 Vector3 PhongBRDF::reflect(const Vector3& v, const Vector3& n) const {
     return v - n * 2.0f * v.dot(n);
 }
 
-Vector3 PhongBRDF::random_unit_vector(std::mt19937& rng) const {
-    float z = random(rng) * 2.0f - 1.0f;
-    float a = random(rng) * M_PI * 2.0f;
+Vector3 PhongBRDF::random_unit_vector(Sampler& sampler) const {
+    float z = random(sampler) * 2.0f - 1.0f;
+    float a = random(sampler) * M_PI * 2.0f;
     float r = sqrt(1.0f - z * z);
     float x = r * cos(a);
     float y = r * sin(a);
     return Vector3(x, y, z);
 }
 
-bool PhongBRDF::scatter(const Ray& r_in, const HitRecord& hit, ScatterRecord& srec, std::mt19937& rng) const {
-    Point3 hit_point = r_in.origin + r_in.direction * hit.t;
-    Vector3 normal = hit.normal;
+float PhongBRDF::fuzz() const {
+    // Convert 'Shininess' (n) to 'Roughness' (fuzz)
+    // Heuristic: n=5 -> fuzz=0.4 (Blurry), n=100 -> fuzz=0.02 (Sharp)
+    return (n > 0.0f) ? std::min(2.0f / n, 1.0f) : 1.0f;
+}
+
+Color PhongBRDF::eval(const HitRecord& hit, const Vector3& wo, const Vector3& wi) const {
+    const float cos_theta = wi.dot(hit.normal);
+    if (cos_theta <= 0.0f) {
+        return Color(0.0, 0.0, 0.0);
+    }
+    // Every sample is weighted by the color, so f cos / pdf = color for both lobes
+    return color * (pdf(hit, wo, wi) / cos_theta);
+}
+
+float PhongBRDF::pdf(const HitRecord& hit, const Vector3& wo, const Vector3& wi, TransportMode /*mode*/) const {
+    const float cos_theta = wi.dot(hit.normal);
+    if (cos_theta <= 0.0f) {
+        return 0.0f;
+    }
+    const float total = kd + ks;
+    float density = kd / total * cos_theta / static_cast<float>(M_PI);
+    if (ks > 0.0f) {
+        density += ks / total * fuzzy_reflection_pdf(reflect(-wo, hit.normal), wi, fuzz());
+    }
+    return density;
+}
+
+bool PhongBRDF::sample(const HitRecord& hit, const Vector3& wo, Sampler& sampler, ScatterRecord& srec,
+                       TransportMode mode) const {
+    const Vector3& normal = hit.normal;
 
     double total = kd + ks;
-    double rayProbability = random(rng) * total; 
+    double rayProbability = random(sampler) * total; 
+    Vector3 direction;
     if (rayProbability < kd) {
-        Vector3 direction = (normal + random_unit_vector(rng)).normalized();
-        
-        // Catch degenerate rays
-        if (direction.length() < 0.001f) {
-            direction = normal;
-        } 
-
-        srec.out_ray = Ray(hit_point + normal * 0.01, direction);
-        srec.attenuation = color;
-        return true;
+        // Cosine-weighted from the next 2D pair
+        const float u1 = sampler.get_1d();
+        const float u2 = sampler.get_1d();
+        direction = Utils::cosine_sample_hemisphere(normal, u1, u2);
     } else {
-        Vector3 reflected = reflect(r_in.direction.normalized(), normal);
-        
-        // Convert 'Shininess' (n) to 'Roughness' (fuzz)
-        // Heuristic: n=5 -> fuzz=0.4 (Blurry), n=100 -> fuzz=0.02 (Sharp)
-        float fuzz = (n > 0.0f) ? (2.0f / n) : 1.0f; 
-
-        // Clamp fuzz to reasonable limits
-        if (fuzz > 1.0f) {
-            fuzz = 1.0f;
-        }
+        Vector3 reflected = reflect(-wo, normal);
 
         // Apply fuzz: Add a random sphere vector to the reflection
-        Vector3 direction = (reflected + random_unit_vector(rng) * fuzz).normalized();
+        direction = (reflected + random_unit_vector(sampler) * fuzz()).normalized();
         
         // Catch bad scatters (ray going into the surface)
         if (direction.dot(normal) <= 0) {
             return false;
         } 
+    }
 
-        srec.out_ray = Ray(hit_point + normal * 0.01, direction);
-        srec.attenuation = color;
-        return true;
+    srec.out_ray = Ray(hit.point + normal * 0.01, direction);
+    srec.attenuation = color;
+    srec.pdf = pdf(hit, wo, direction);
+    if (mode == TransportMode::Importance) {
+        if (srec.pdf <= 0.0f) {
+            return false;
+        }
+        // f_r cos / pdf = color holds for the incoming cosine; flux leaves along direction
+        srec.attenuation = eval(hit, direction, wo) * (direction.dot(normal) / srec.pdf);
     }
+    return true;
 }
 
 } // namespace PathRender
@@ -0,0 +1,179 @@
+#include "PathRender/core/sampler.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace PathRender {
+
+namespace {
+
+constexpr float kOneMinusEpsilon = 0x1.fffffep-1f;
+
+constexpr uint32_t kPrimes[HaltonSampler::kMaxDimensions] = {
+    2,   3,   5,   7,   11,  13,  17,  19,  23,  29,  31,  37,  41,  43,  47,  53,
+    59,  61,  67,  71,  73,  79,  83,  89,  97,  101, 103, 107, 109, 113, 127, 131,
+    137, 139, 149, 151, 157, 163, 167, 173, 179, 181, 191, 193, 197, 199, 211, 223,
+    227, 229, 233, 239, 241, 251, 257, 263, 269, 271, 277, 281, 283, 293, 307, 311};
+
+// 32-bit hash of (seed, pixel, a, b); does not depend on the sample index
+uint32_t pixel_hash(uint32_t seed, uint32_t pixel, uint32_t a, uint32_t b) {
+    const uint64_t key = (static_cast<uint64_t>(pixel) << 32) | a;
+    const uint64_t stream = (static_cast<uint64_t>(seed) << 32) | b;
+    return static_cast<uint32_t>(Sampler::mix64(key ^ Sampler::mix64(~stream)));
+}
+
+// Element i of a pseudo-random permutation of [0, length) chosen by seed
+// (Kensler, "Correlated Multi-Jittered Sampling", 2013)
+uint32_t permutation_element(uint32_t i, uint32_t length, uint32_t seed) {
+    uint32_t w = length - 1;
+    w |= w >> 1;
+    w |= w >> 2;
+    w |= w >> 4;
+    w |= w >> 8;
+    w |= w >> 16;
+    do {
+        i ^= seed;
+        i *= 0xe170893d;
+        i ^= seed >> 16;
+        i ^= (i & w) >> 4;
+        i ^= seed >> 8;
+        i *= 0x0929eb3f;
+        i ^= seed >> 23;
+        i ^= (i & w) >> 1;
+        i *= 1 | seed >> 27;
+        i *= 0x6935fa69;
+        i ^= (i & w) >> 11;
+        i *= 0x74dcb303;
+        i ^= (i & w) >> 2;
+        i *= 0x9e501cc3;
+        i ^= (i & w) >> 2;
+        i *= 0xc860a3df;
+        i &= w;
+        i ^= i >> 5;
+    } while (i >= length);
+    return (i + seed) % length;
+}
+
+uint32_t reverse_bits(uint32_t x) {
+    x = (x << 16) | (x >> 16);
+    x = ((x & 0x00ff00ff) << 8) | ((x & 0xff00ff00) >> 8);
+    x = ((x & 0x0f0f0f0f) << 4) | ((x & 0xf0f0f0f0) >> 4);
+    x = ((x & 0x33333333) << 2) | ((x & 0xcccccccc) >> 2);
+    x = ((x & 0x55555555) << 1) | ((x & 0xaaaaaaaa) >> 1);
+    return x;
+}
+
+// Base-2 Owen scrambling: every bit is flipped by a hash of the bits above it
+// (Laine-Karras permutation with Vegdahl's constants, applied to reversed bits)
+uint32_t nested_uniform_scramble(uint32_t x, uint32_t seed) {
+    x = reverse_bits(x);
+    x ^= x * 0x3d20adea;
+    x += seed;
+    x *= (seed >> 16) | 1;
+    x ^= x * 0x05526c56;
+    x ^= x * 0x53a22864;
+    return reverse_bits(x);
+}
+
+// First two Sobol dimensions: van der Corput and the x + 1 primitive polynomial
+uint32_t sobol_2d(uint32_t index, uint32_t dimension) {
+    uint32_t result = 0;
+    uint32_t direction = 1u << 31;
+    for (; index != 0; index >>= 1) {
+        if (index & 1) {
+            result ^= direction;
+        }
+        direction = dimension == 0 ? direction >> 1 : direction ^ (direction >> 1);
+    }
+    return result;
+}
+
+// Radical inverse of index in the given base with each digit permuted by a hash
+// of the digits before it (Owen scrambling), down to float resolution
+float owen_scrambled_radical_inverse(uint32_t index, uint32_t base, uint32_t seed) {
+    const double inverse_base = 1.0 / base;
+    double inverse_base_m = 1.0;
+    uint64_t reversed_digits = 0;
+    do {
+        const uint32_t next = index / base;
+        uint32_t digit = index - next * base;
+        digit = permutation_element(digit, base, static_cast<uint32_t>(Sampler::mix64(seed ^ reversed_digits)));
+        reversed_digits = reversed_digits * base + digit;
+        inverse_base_m *= inverse_base;
+        index = next;
+    } while (inverse_base_m > 0x1p-24);
+    return std::min(static_cast<float>(reversed_digits * inverse_base_m), kOneMinusEpsilon);
+}
+
+} // namespace
+
+StratifiedSampler::StratifiedSampler(uint32_t seed, int samples_per_pixel)
+    : Sampler(seed),
+      m_grid(static_cast<uint32_t>(std::max(1.0, std::floor(std::sqrt(static_cast<double>(samples_per_pixel)))))) {}
+
+float StratifiedSampler::get_1d() {
+    const uint32_t dimension = m_dimension++;
+    const uint32_t cells = m_grid * m_grid;
+    const uint32_t round = m_sample / cells;
+    const uint32_t cell = permutation_element(m_sample % cells, cells, pixel_hash(m_seed, m_pixel, dimension / 2, round));
+    const uint32_t stratum = (dimension & 1) ? cell / m_grid : cell % m_grid;
+    return std::min((static_cast<float>(stratum) + uniform(dimension)) / static_cast<float>(m_grid), kOneMinusEpsilon);
+}
+
+float HaltonSampler::get_1d() {
+    const uint32_t dimension = m_dimension++;
+    if (dimension >= kMaxDimensions) {
+        return uniform(dimension);
+    }
+    return owen_scrambled_radical_inverse(m_sample, kPrimes[dimension], pixel_hash(m_seed, m_pixel, dimension, 0));
+}
+
+float SobolSampler::get_1d() {
+    const uint32_t dimension = m_dimension++;
+    const uint32_t pair = dimension / 2;
+    // Same shuffled index for both dimensions of the pair, independent scrambles per dimension
+    const uint32_t index = nested_uniform_scramble(m_sample, pixel_hash(m_seed, m_pixel, pair, 0));
+    const uint32_t value = nested_uniform_scramble(sobol_2d(index, dimension & 1),
+                                                   pixel_hash(m_seed, m_pixel, pair, 1 + (dimension & 1)));
+    return static_cast<float>(value >> 8) * (1.0f / 16777216.0f);
+}
+
+std::unique_ptr<Sampler> make_sampler(SamplerType type, uint32_t seed, int samples_per_pixel) {
+    switch (type) {
+        case SamplerType::Stratified:
+            return std::make_unique<StratifiedSampler>(seed, samples_per_pixel);
+        case SamplerType::Halton:
+            return std::make_unique<HaltonSampler>(seed);
+        case SamplerType::Sobol:
+            return std::make_unique<SobolSampler>(seed);
+        case SamplerType::Independent:
+        default:
+            return std::make_unique<IndependentSampler>(seed);
+    }
+}
+
+const char* sampler_type_name(SamplerType type) {
+    switch (type) {
+        case SamplerType::Stratified:
+            return "stratified";
+        case SamplerType::Halton:
+            return "halton";
+        case SamplerType::Sobol:
+            return "sobol";
+        case SamplerType::Independent:
+        default:
+            return "independent";
+    }
+}
+
+bool parse_sampler_type(const std::string& name, SamplerType& type) {
+    for (SamplerType candidate :
+         {SamplerType::Independent, SamplerType::Stratified, SamplerType::Halton, SamplerType::Sobol}) {
+        if (name == sampler_type_name(candidate)) {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace PathRender
@@ -1,59 +1,163 @@
 #include "PathRender/objects/mesh.hpp"
+#include "PathRender/accel/simd.hpp"
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <sstream>
+#include <stdexcept>
 
 namespace PathRender {
 
 bool Mesh::intersect(const Ray& ray, float t_min, float t_max, HitRecord& hit) const {
-    bool intersected = false;
-    float closest_so_far = t_max;
-    for (const Triangle& triangle : m_triangles) {
-        HitRecord temp_hit;
-        if (triangle.intersect(ray, t_min, closest_so_far, temp_hit)) {
-            hit = temp_hit;
-            hit.object = std::make_shared<Mesh>(*this);
-            intersected = true;
-            closest_so_far = hit.t;
+    auto test_range = [&](uint32_t first, uint32_t count, float& t_closest) {
+        bool hit_range = false;
+        for (uint32_t i = first; i < first + count; ++i) {
+            if (m_triangles.intersect(i, m_vertices.data(), ray, t_min, t_closest, hit.t, hit.u, hit.v)) {
+                hit.primitive_index = i;
+                hit_range = true;
+                t_closest = hit.t;
+            }
         }
+        return hit_range;
+    };
+
+    if (!m_bvh.empty()) {
+        // Triangles are stored in leaf order, so each leaf is a contiguous range
+        // tested by the SIMD kernel (the SoA arrays are padded after the build)
+        return m_bvh.traverse(ray, t_min, t_max, [&](uint32_t first, uint32_t count, float& t_closest) {
+            if (Simd::intersect_triangles(m_triangles, m_vertices.data(), first, count, ray, t_min, t_closest,
+                                          hit.primitive_index, hit.u, hit.v)) {
+                hit.t = t_closest;
+                return true;
+            }
+            return false;
+        });
     }
-    return intersected;
+    return test_range(0, static_cast<uint32_t>(m_triangles.size()), t_max);
 }
 
-void Mesh::add_triangle(const Triangle& triangle) {
-    m_triangles.push_back(triangle);
+bool Mesh::occluded(const Ray& ray, float t_min, float t_max) const {
+    if (m_bvh.empty()) {
+        HitRecord hit;
+        for (uint32_t i = 0; i < m_triangles.size(); ++i) {
+            if (!get_primitive_material(i).is_light &&
+                m_triangles.intersect(i, m_vertices.data(), ray, t_min, t_max, hit.t, hit.u, hit.v)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if (std::find(m_emissive_materials.begin(), m_emissive_materials.end(), 1) == m_emissive_materials.end()) {
+        // No emissive triangles: any hit in a leaf blocks the ray
+        return m_bvh.traverse_any(ray, t_min, t_max, [&](uint32_t first, uint32_t count) {
+            float t_closest = t_max, u, v;
+            uint32_t primitive;
+            return Simd::intersect_triangles(m_triangles, m_vertices.data(), first, count, ray, t_min, t_closest, primitive, u, v);
+        });
+    }
+
+    return m_bvh.traverse_any(ray, t_min, t_max, [&](uint32_t first, uint32_t count) {
+        float t, u, v;
+        for (uint32_t i = first; i < first + count; ++i) {
+            if (!m_emissive_materials[m_material_indices[i]] && m_triangles.intersect(i, m_vertices.data(), ray, t_min, t_max, t, u, v)) {
+                return true;
+            }
+        }
+        return false;
+    });
 }
 
-void Mesh::add_vertex(const Point3& vertex) {
+bool Mesh::is_emissive() const {
+    if (!m_material.is_light) {
+        return false;
+    }
+    for (const Material& material : m_materials) {
+        if (!material.is_light) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Mesh::compute_surface(const Ray& ray, HitRecord& hit) const {
+    hit.point = ray.at(hit.t);
+    hit.set_face_normal(ray, m_triangles.get_normal(hit.primitive_index));
+}
+
+uint32_t Mesh::add_vertex(const Point3& vertex) {
     m_vertices.push_back(vertex);
+    return static_cast<uint32_t>(m_vertices.size() - 1);
+}
+
+void Mesh::add_triangle(uint32_t a, uint32_t b, uint32_t c, uint16_t material_index) {
+    // Checked first: a rejected triangle must leave every per-triangle array unchanged
+    if (std::max({a, b, c}) >= m_vertices.size()) {
+        throw std::out_of_range("Mesh::add_triangle: índice de vértice inválido");
+    }
+    m_indices.push_back(a);
+    m_indices.push_back(b);
+    m_indices.push_back(c);
+    m_material_indices.push_back(material_index);
+    m_triangles.push_back(m_vertices.data(), a, b, c);
+    m_bvh.clear();
+}
+
+uint16_t Mesh::add_material(const Material& material) {
+    m_materials.push_back(material);
+    return static_cast<uint16_t>(m_materials.size());
+}
+
+const Material& Mesh::get_primitive_material(uint32_t primitive_index) const {
+    uint16_t index = m_material_indices[primitive_index];
+    return index == 0 ? m_material : m_materials[index - 1];
 }
 
-const std::vector<Triangle>& Mesh::get_triangles() const { 
-    return m_triangles; 
+size_t Mesh::triangle_count() const {
+    return m_material_indices.size();
 }
 
-const std::vector<Point3>& Mesh::get_vertices() const { 
-    return m_vertices; 
+const std::vector<uint32_t>& Mesh::get_indices() const {
+    return m_indices;
 }
 
-void Mesh::set_color(const Color& color) { 
-    m_material.brdf->color = color; 
+const std::vector<Point3>& Mesh::get_vertices() const {
+    return m_vertices;
 }
 
-const Color& Mesh::get_color() const { 
-    return m_material.brdf->color; 
+const TriangleSoA& Mesh::get_triangles() const {
+    return m_triangles;
 }
 
-void Mesh::set_name(std::string name) { 
-    m_name = name; 
+size_t Mesh::memory_usage() const {
+    return m_vertices.capacity() * sizeof(Point3) +
+           m_indices.capacity() * sizeof(uint32_t) +
+           m_material_indices.capacity() * sizeof(uint16_t) +
+           m_triangles.memory_usage() +
+           m_bvh.memory_usage();
 }
 
-const std::string& Mesh::get_name() const { 
-    return m_name; 
+void Mesh::set_color(const Color& color) {
+    m_material.brdf->color = color;
+}
+
+const Color& Mesh::get_color() const {
+    return m_material.brdf->color;
+}
+
+void Mesh::set_name(std::string name) {
+    m_name = name;
+}
+
+const std::string& Mesh::get_name() const {
+    return m_name;
 }
 
 std::string Mesh::print_triangles() const {
     std::string result;
-    for (const auto& triangle : m_triangles) {
-        result += triangle.to_string() + "\n";
+    for (size_t i = 0; i < triangle_count(); ++i) {
+        result += "Triangle(" + std::to_string(m_indices[3 * i]) + ", " + std::to_string(m_indices[3 * i + 1]) +
+                  ", " + std::to_string(m_indices[3 * i + 2]) + ", material=" + std::to_string(m_material_indices[i]) + ")\n";
     }
     return result;
 }
@@ -74,7 +178,7 @@ Point3 Mesh::get_position() const {
     if (m_vertices.empty()) {
         return Point3(0.0f, 0.0f, 0.0f);
     }
-    
+
     Vector3 sum(0.0f, 0.0f, 0.0f);
     for (auto vertex : m_vertices) {
         sum = sum + Vector3(vertex.x, vertex.y, vertex.z);
@@ -82,4 +186,61 @@ Point3 Mesh::get_position() const {
     return sum / static_cast<float>(m_vertices.size());
 }
 
+AABB Mesh::get_bounds() const {
+    if (!m_bvh.empty()) {
+        return m_bvh.bounds();
+    }
+
+    AABB bounds;
+    for (uint32_t index : m_indices) {
+        bounds.expand(m_vertices[index]);
+    }
+    return bounds;
+}
+
+void Mesh::build_acceleration() {
+    auto start = std::chrono::steady_clock::now();
+    const size_t count = triangle_count();
+    std::vector<AABB> bounds;
+    bounds.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        AABB box(m_vertices[m_indices[3 * i]], m_vertices[m_indices[3 * i + 1]]);
+        box.expand(m_vertices[m_indices[3 * i + 2]]);
+        bounds.push_back(box);
+    }
+    m_bvh.build(bounds, simd_width());
+
+    // Store triangles in leaf order so every leaf is a contiguous range
+    std::vector<uint32_t> indices;
+    std::vector<uint16_t> material_indices;
+    indices.reserve(m_indices.size());
+    material_indices.reserve(count);
+    m_triangles = TriangleSoA();
+    m_triangles.reserve(count + kMaxSimdWidth - 1);  // Room for pad(), so it does not reallocate
+    for (uint32_t tri : m_bvh.primitive_indices()) {
+        uint32_t a = m_indices[3 * tri], b = m_indices[3 * tri + 1], c = m_indices[3 * tri + 2];
+        indices.insert(indices.end(), {a, b, c});
+        material_indices.push_back(m_material_indices[tri]);
+        m_triangles.push_back(m_vertices.data(), a, b, c);
+    }
+    m_triangles.pad(kMaxSimdWidth);
+
+    m_emissive_materials.clear();
+    m_emissive_materials.push_back(m_material.is_light);
+    for (const Material& material : m_materials) {
+        m_emissive_materials.push_back(material.is_light);
+    }
+
+    if (count >= kLoggedBuildSize) {
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+        std::ostringstream log;
+        log << "BVH" << PATHRENDER_BVH_WIDTH << " da malha " << (m_name.empty() ? "(sem nome)" : m_name) << ": "
+            << count << " triângulos, " << m_bvh.node_count() << " nós, custo SAH " << m_bvh.sah_cost()
+            << " (" << elapsed.count() << " ms)\n";
+        std::cout << log.str() << std::flush;
+    }
+    m_indices = std::move(indices);
+    m_material_indices = std::move(material_indices);
+}
+
 } // namespace PathRender
@@ -18,13 +18,15 @@ bool Plane::intersect(const Ray& ray, float t_min, float t_max, HitRecord& hit)
     }
 
     hit.t = t;
-    hit.point = ray.at(t);
-    hit.object = std::make_shared<Plane>(*this);
-    hit.set_face_normal(ray, m_normal);
-
+    hit.primitive_index = 0;
     return true;
 }
 
+void Plane::compute_surface(const Ray& ray, HitRecord& hit) const {
+    hit.point = ray.at(hit.t);
+    hit.set_face_normal(ray, m_normal);
+}
+
 const Color& Plane::get_color() const { 
     return m_material.brdf->color; 
 }
@@ -46,4 +48,8 @@ Point3 Plane::get_position() const {
     return m_point;
 }
 
+AABB Plane::get_bounds() const {
+    return AABB::infinite();
+}
+
 } // namespace PathRender
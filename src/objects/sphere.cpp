@@ -29,12 +29,14 @@ bool Sphere::intersect(const Ray& ray, float t_min, float t_max, HitRecord& hit)
     }
 
     hit.t = root;
+    hit.primitive_index = 0;
+    return true;
+}
+
+void Sphere::compute_surface(const Ray& ray, HitRecord& hit) const {
     hit.point = ray.at(hit.t);
-    hit.object = std::make_shared<Sphere>(*this);
     Vector3 outward_normal = (hit.point - m_center) / m_radius;
     hit.set_face_normal(ray, outward_normal);
-
-    return true;
 }
 
 const Color& Sphere::get_color() const { 
@@ -57,4 +59,9 @@ Point3 Sphere::get_position() const {
     return m_center;
 }
 
+AABB Sphere::get_bounds() const {
+    Vector3 r(m_radius, m_radius, m_radius);
+    return AABB(m_center - r, m_center + r);
+}
+
 } // namespace PathRender
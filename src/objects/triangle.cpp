@@ -3,66 +3,57 @@
 
 namespace PathRender {
 
-Triangle::Triangle(const Point3& A, const Point3& B, const Point3& C, const Material& material)
-    : m_vertices({A, B, C}) { m_material = material; }
-
-Vector3 Triangle::get_normal() const {
-    Vector3 edge1 = m_vertices[1] - m_vertices[0];
-    Vector3 edge2 = m_vertices[2] - m_vertices[0];
-    return edge1.cross(edge2).normalized();
+void TriangleSoA::clear() {
+    v0_index.clear();
+    for (std::vector<float>* array : {&e1_x, &e1_y, &e1_z, &e2_x, &e2_y, &e2_z, &n_x, &n_y, &n_z}) {
+        array->clear();
+    }
+    m_size = 0;
 }
 
-// https://en.wikipedia.org/wiki/M%C3%B6ller%E2%80%93Trumbore_intersection_algorithm
-bool Triangle::intersect(const Ray& ray, float t_min, float t_max, HitRecord& hit) const {
-    const float epsilon = t_min;
-    Point3 a = m_vertices[0], 
-           b = m_vertices[1], 
-           c = m_vertices[2];
-
-    Vector3 edge1 = b - a;
-    Vector3 edge2 = c - a;
-    Vector3 ray_cross_e2 = ray.direction.cross(edge2);
-    float det = edge1.dot(ray_cross_e2);
-
-    if (det > -epsilon && det < epsilon) {
-        return false;    // This ray is parallel to this triangle.
+void TriangleSoA::pad(size_t width) {
+    // A block of 'width' lanes starting at the last triangle must stay in bounds;
+    // padding lanes point at vertex 0, which exists whenever a triangle does
+    size_t padded = m_size + width - 1;
+    v0_index.resize(padded, 0);
+    for (std::vector<float>* array : {&e1_x, &e1_y, &e1_z, &e2_x, &e2_y, &e2_z, &n_x, &n_y, &n_z}) {
+        array->resize(padded, 0.0f);
     }
+}
 
-    float inv_det = 1.0 / det;
-    Vector3 s = ray.origin - a;
-    float u = inv_det * (s.dot(ray_cross_e2));
-
-    if ((u < 0 && std::abs(u) > epsilon) || (u > 1 && std::abs(u-1) > epsilon)) {
-        return false;
+void TriangleSoA::reserve(size_t count) {
+    v0_index.reserve(count);
+    for (std::vector<float>* array : {&e1_x, &e1_y, &e1_z, &e2_x, &e2_y, &e2_z, &n_x, &n_y, &n_z}) {
+        array->reserve(count);
     }
+}
 
-    Vector3 s_cross_e1 = s.cross(edge1);
-    float v = inv_det * (ray.direction.dot(s_cross_e1));
-
-    if ((v < 0 && std::abs(v) > epsilon) || (u + v > 1 && std::abs(u + v - 1) > epsilon)) {
-        return false;
+void TriangleSoA::push_back(const Point3* vertices, uint32_t a, uint32_t b, uint32_t c) {
+    Vector3 edge1 = vertices[b] - vertices[a];
+    Vector3 edge2 = vertices[c] - vertices[a];
+    Vector3 normal = edge1.cross(edge2).normalized();
+
+    if (v0_index.size() != m_size) {
+        // Drop padding before appending
+        v0_index.resize(m_size);
+        for (std::vector<float>* array : {&e1_x, &e1_y, &e1_z, &e2_x, &e2_y, &e2_z, &n_x, &n_y, &n_z}) {
+            array->resize(m_size);
+        }
     }
 
-    // At this stage we can compute t to find out where the intersection point is on the line.
-    float t = inv_det * edge2.dot(s_cross_e1);
-
-    if (t > epsilon && t < t_max) // ray intersection
-    {
-        hit.t = t;
-        hit.point = ray.at(t);
-        Vector3 outward_normal = this->get_normal();
-        hit.set_face_normal(ray, outward_normal);
-        return  true; 
-    }
-    return false;
+    v0_index.push_back(a);
+    e1_x.push_back(edge1.x); e1_y.push_back(edge1.y); e1_z.push_back(edge1.z);
+    e2_x.push_back(edge2.x); e2_y.push_back(edge2.y); e2_z.push_back(edge2.z);
+    n_x.push_back(normal.x); n_y.push_back(normal.y); n_z.push_back(normal.z);
+    m_size++;
 }
 
-Point3 Triangle::get_position() const {
-    auto&& v = m_vertices;
-    Vector3 a = Vector3(v[0].x, v[0].y, v[0].z), 
-            b = Vector3(v[1].x, v[1].y, v[1].z), 
-            c = Vector3(v[2].x, v[2].y, v[2].z);
-    return (a + b + c) / 3.0;
+size_t TriangleSoA::memory_usage() const {
+    size_t bytes = v0_index.capacity() * sizeof(uint32_t);
+    for (const std::vector<float>* array : {&e1_x, &e1_y, &e1_z, &e2_x, &e2_y, &e2_z, &n_x, &n_y, &n_z}) {
+        bytes += array->capacity() * sizeof(float);
+    }
+    return bytes;
 }
 
 } // namespace PathRender
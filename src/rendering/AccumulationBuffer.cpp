@@ -0,0 +1,162 @@
+#include "PathRender/rendering/AccumulationBuffer.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace PathRender {
+
+namespace {
+
+constexpr char kCheckpointMagic[4] = {'P', 'R', 'C', 'K'};
+constexpr uint32_t kCheckpointVersion = 2;  // 2: luminance mean and M2 instead of sums
+
+constexpr size_t kHeaderBytes = 4 + 4 * sizeof(uint32_t);
+constexpr size_t kPixelBytes = 6 * sizeof(uint32_t);
+static_assert(std::numeric_limits<float>::is_iec559 && sizeof(float) == 4, "checkpoints store IEEE 754 floats");
+
+// Every field is written byte by byte in little-endian, whatever the host order
+void put_u32(unsigned char* out, uint32_t value) {
+    out[0] = static_cast<unsigned char>(value);
+    out[1] = static_cast<unsigned char>(value >> 8);
+    out[2] = static_cast<unsigned char>(value >> 16);
+    out[3] = static_cast<unsigned char>(value >> 24);
+}
+
+uint32_t get_u32(const unsigned char* in) {
+    return static_cast<uint32_t>(in[0]) | static_cast<uint32_t>(in[1]) << 8 |
+           static_cast<uint32_t>(in[2]) << 16 | static_cast<uint32_t>(in[3]) << 24;
+}
+
+void put_f32(unsigned char* out, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put_u32(out, bits);
+}
+
+float get_f32(const unsigned char* in) {
+    const uint32_t bits = get_u32(in);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+void PixelAccumulator::add(const Color& sample) {
+    sum[0] += static_cast<float>(sample.r);
+    sum[1] += static_cast<float>(sample.g);
+    sum[2] += static_cast<float>(sample.b);
+    const float luminance = static_cast<float>(0.2126 * sample.r + 0.7152 * sample.g + 0.0722 * sample.b);
+    samples++;
+    const float delta = luminance - luminance_mean;
+    luminance_mean += delta / samples;
+    luminance_m2 += delta * (luminance - luminance_mean);
+}
+
+Color PixelAccumulator::mean() const {
+    if (samples == 0) {
+        return Color();
+    }
+    return Color(sum[0] / samples, sum[1] / samples, sum[2] / samples);
+}
+
+void AccumulationBuffer::reset(int width, int height) {
+    m_width = width;
+    m_height = height;
+    m_passes = 0;
+    m_pixels.assign(static_cast<size_t>(width) * height, PixelAccumulator());
+}
+
+uint64_t AccumulationBuffer::total_samples() const {
+    uint64_t total = 0;
+    for (const PixelAccumulator& pixel : m_pixels) {
+        total += pixel.samples;
+    }
+    return total;
+}
+
+bool AccumulationBuffer::save(const std::string& filename) const {
+    const std::string temporary = filename + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Erro ao criar checkpoint: " << temporary << std::endl;
+            return false;
+        }
+
+        std::vector<unsigned char> bytes(kHeaderBytes + m_pixels.size() * kPixelBytes);
+        std::memcpy(bytes.data(), kCheckpointMagic, sizeof(kCheckpointMagic));
+        put_u32(&bytes[4], kCheckpointVersion);
+        put_u32(&bytes[8], static_cast<uint32_t>(m_width));
+        put_u32(&bytes[12], static_cast<uint32_t>(m_height));
+        put_u32(&bytes[16], m_passes);
+        unsigned char* out = &bytes[kHeaderBytes];
+        for (const PixelAccumulator& pixel : m_pixels) {
+            put_f32(out, pixel.sum[0]);
+            put_f32(out + 4, pixel.sum[1]);
+            put_f32(out + 8, pixel.sum[2]);
+            put_f32(out + 12, pixel.luminance_mean);
+            put_f32(out + 16, pixel.luminance_m2);
+            put_u32(out + 20, pixel.samples);
+            out += kPixelBytes;
+        }
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file) {
+            std::cerr << "Erro ao gravar checkpoint: " << temporary << std::endl;
+            return false;
+        }
+    }
+
+    // rename() replaces the previous checkpoint in one step on POSIX; Windows
+    // refuses to overwrite, so the old file is removed first there
+#ifdef _WIN32
+    std::remove(filename.c_str());
+#endif
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        std::cerr << "Erro ao substituir checkpoint: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+AccumulationBuffer AccumulationBuffer::load(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Não foi possível abrir o checkpoint: " + filename);
+    }
+
+    unsigned char header[kHeaderBytes];
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || std::memcmp(header, kCheckpointMagic, sizeof(kCheckpointMagic)) != 0) {
+        throw std::runtime_error("Arquivo não é um checkpoint do PathRender: " + filename);
+    }
+    const uint32_t version = get_u32(&header[4]);
+    if (version != kCheckpointVersion) {
+        throw std::runtime_error("Versão de checkpoint não suportada (" + std::to_string(version) + "): " + filename);
+    }
+
+    AccumulationBuffer buffer(static_cast<int>(get_u32(&header[8])), static_cast<int>(get_u32(&header[12])));
+    buffer.m_passes = get_u32(&header[16]);
+    std::vector<unsigned char> bytes(buffer.m_pixels.size() * kPixelBytes);
+    file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+        throw std::runtime_error("Checkpoint truncado: " + filename);
+    }
+    const unsigned char* in = bytes.data();
+    for (PixelAccumulator& pixel : buffer.m_pixels) {
+        pixel.sum[0] = get_f32(in);
+        pixel.sum[1] = get_f32(in + 4);
+        pixel.sum[2] = get_f32(in + 8);
+        pixel.luminance_mean = get_f32(in + 12);
+        pixel.luminance_m2 = get_f32(in + 16);
+        pixel.samples = get_u32(in + 20);
+        in += kPixelBytes;
+    }
+    return buffer;
+}
+
+} // namespace PathRender
@@ -0,0 +1,458 @@
+#include "PathRender/rendering/BidirectionalPathTracer.hpp"
+#include "PathRender/utils/thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+namespace PathRender {
+
+namespace {
+
+// Light subpaths draw their numbers from a stream apart from the camera subpaths
+constexpr uint32_t kLightPathSeed = 0x6C696768u;
+
+// Gap left at both ends of a connection between two surfaces, like the offset of scattered rays
+constexpr float kConnectionEpsilon = 0.01f;
+
+// Delta lobes store density 0; in the MIS ratios they cancel out instead
+float remap_zero(float pdf) {
+    return pdf != 0.0f ? pdf : 1.0f;
+}
+
+bool is_black(const Color& c) {
+    return c.r + c.g + c.b <= 0.0;
+}
+
+double max_component(const Color& c) {
+    return std::max({c.r, c.g, c.b});
+}
+
+} // namespace
+
+void BidirectionalPathTracer::render(std::vector<Color>& buffer, const SceneConfig& config) {
+    std::cout << "BIDIRECTIONAL PATH TRACER RENDER" << std::endl;
+
+    m_lights = LightSampler(LightSelection::Power);
+    m_lights.build(config.scene);
+    std::cout << "Found " << m_lights.size() << " emissive primitives (selection: "
+              << light_selection_name(m_lights.selection()) << ")" << std::endl;
+    if (m_lights.empty()) {
+        std::cerr << "Aviso: nenhuma luz com área finita, só os caminhos de câmera que atingem luzes contribuem"
+                  << std::endl;
+    }
+
+    const int width = config.output_params.width;
+    const int height = config.output_params.height;
+    const int samples_per_pixel = std::max(m_samples_per_pixel, 1);
+    const int max_depth = std::max(m_max_depth, 0);
+    const int tiles_x = (width + kTileSize - 1) / kTileSize;
+    const int tiles_y = (height + kTileSize - 1) / kTileSize;
+    const int tile_count = tiles_x * tiles_y;
+
+    // One workspace per pool thread (plus the caller): the subpaths of every sample
+    // reuse the same vertex arrays
+    Utils::ThreadPool& pool = Utils::ThreadPool::global();
+    std::vector<Workspace> workspaces(pool.size() + 1);
+    for (Workspace& workspace : workspaces) {
+        workspace.camera.resize(max_depth + 2);
+        workspace.light.resize(max_depth + 1);
+        workspace.camera_sampler = make_sampler(m_sampler_type, m_seed, samples_per_pixel);
+        workspace.light_sampler = make_sampler(m_sampler_type, m_seed ^ kLightPathSeed, samples_per_pixel);
+        workspace.light_image.assign(static_cast<size_t>(width) * height, Color(0.0, 0.0, 0.0));
+    }
+
+    std::atomic<int> tiles_done{0};
+    std::mutex print_mutex;
+
+    auto render_one = [&](int tile) {
+        const int x0 = (tile % tiles_x) * kTileSize;
+        const int y0 = (tile / tiles_x) * kTileSize;
+        const int x1 = std::min(x0 + kTileSize, width);
+        const int y1 = std::min(y0 + kTileSize, height);
+        Workspace& workspace = workspaces[pool.current_thread_index()];
+
+        for (int j = y0; j < y1; ++j) {
+            for (int i = x0; i < x1; ++i) {
+                Color radiance(0.0, 0.0, 0.0);
+                for (int sample = 0; sample < samples_per_pixel; ++sample) {
+                    radiance += trace_sample(config, i, j, static_cast<uint32_t>(sample), workspace);
+                }
+                // Camera strategies only: the light images are added once every tile is done
+                buffer[static_cast<size_t>(height - 1 - j) * width + i] = radiance;
+            }
+        }
+
+        int completed = ++tiles_done;
+        if (print_mutex.try_lock()) {
+            std::cout << "\rProgress: " << std::fixed << std::setprecision(1) << 100.0f * completed / tile_count << "%   ";
+            std::cout.flush();
+            print_mutex.unlock();
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        Utils::TaskGroup tasks;
+        for (int tile = 0; tile < tile_count; ++tile) {
+            tasks.run([&render_one, tile] { render_one(tile); });
+        }
+        tasks.wait();
+    }
+
+    // Each light subpath stands for one camera sample: the light images share the average
+    for (size_t p = 0; p < buffer.size(); ++p) {
+        Color radiance = buffer[p];
+        for (const Workspace& workspace : workspaces) {
+            radiance += workspace.light_image[p];
+        }
+        // Average and gamma 2
+        const Color pixel_color = radiance / static_cast<double>(samples_per_pixel);
+        buffer[p] = Color(std::sqrt(pixel_color.r), std::sqrt(pixel_color.g), std::sqrt(pixel_color.b));
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const double samples = static_cast<double>(width) * height * samples_per_pixel;
+    std::cout << "\nRender Complete! " << std::setprecision(2) << seconds << " s, "
+              << samples / seconds / 1e6 << " M amostras/s" << std::endl;
+}
+
+Color BidirectionalPathTracer::trace_sample(const SceneConfig& config, int i, int j, uint32_t sample,
+                                            Workspace& workspace) const {
+    const int width = config.output_params.width;
+    const int height = config.output_params.height;
+    const Scene& scene = config.scene;
+    const int max_depth = std::max(m_max_depth, 0);
+    const uint32_t pixel = static_cast<uint32_t>(j * width + i);
+
+    // Camera subpath: vertex 0 is the lens. The camera ray density covers the whole film,
+    // as the light subpaths of t = 1 do
+    Sampler& camera_sampler = *workspace.camera_sampler;
+    camera_sampler.start_pixel_sample(pixel, sample);
+    const float u = (float(i) + camera_sampler.get_1d()) / (width - 1);
+    const float v = (float(j) + camera_sampler.get_1d()) / (height - 1);
+    const Ray camera_ray = config.camera.get_ray(u, v);
+    const float camera_pdf = config.camera.pdf(camera_ray.direction) / film_area(width, height);
+    PathVertex* camera = workspace.camera.data();
+    camera[0] = PathVertex();
+    camera[0].hit.point = camera_ray.origin;
+    camera[0].beta = Color(1.0, 1.0, 1.0);
+    const int camera_count = random_walk(scene, camera_ray, camera[0].beta, camera_pdf, camera_sampler, 0, false,
+                                         camera, 1, max_depth + 2);
+
+    // Light subpath: vertex 0 is the point on the light. Bounce b uses the dimensions
+    // of bounce b + 1: the first ones hold the emission
+    Sampler& light_sampler = *workspace.light_sampler;
+    light_sampler.start_pixel_sample(pixel, sample);
+    PathVertex* light = workspace.light.data();
+    int light_count = 0;
+    EmissionSample emission;
+    if (max_depth > 0 && m_lights.sample_emission(light_sampler, emission)) {
+        light[0] = PathVertex();
+        light[0].hit.point = emission.point;
+        light[0].hit.normal = emission.normal;
+        light[0].emission = emission.radiance;
+        light[0].beta = emission.radiance / emission.pdf_position;
+        light[0].pdf_forward = emission.pdf_position;
+        light[0].is_light = true;
+        light_count = random_walk(scene, emission.ray, emission.flux, emission.pdf_direction, light_sampler, 1, true,
+                                  light, 1, max_depth + 1);
+    }
+
+    // Every strategy (s, t) with t >= 2 and at most max_depth bounces; s = 1 samples
+    // its own point on a light, so it does not need the light subpath
+    Color radiance(0.0, 0.0, 0.0);
+    for (int t = 2; t <= camera_count; ++t) {
+        for (int s = 0; s <= std::max(light_count, 1) && s + t - 2 <= max_depth; ++s) {
+            PathVertex sampled;
+            const Color contribution = connect(scene, light, s, camera, t, sampled, camera_sampler);
+            if (!is_black(contribution)) {
+                radiance += contribution * mis_weight(light, s, camera, t, sampled);
+            }
+        }
+    }
+
+    // Strategies (s >= 2, t = 1): each light vertex lands on the pixel it projects to
+    for (int s = 2; s <= light_count && s - 1 <= max_depth; ++s) {
+        PathVertex sampled;
+        size_t index = 0;
+        const Color contribution = connect_camera(config, light, s, camera[0], sampled, index);
+        if (!is_black(contribution)) {
+            workspace.light_image[index] += contribution * mis_weight(light, s, camera, 1, sampled);
+        }
+    }
+    return radiance;
+}
+
+int BidirectionalPathTracer::random_walk(const Scene& scene, Ray ray, Color beta, float pdf, Sampler& sampler,
+                                         int bounce_offset, bool light_path, PathVertex* path, int count,
+                                         int max_count) const {
+    // Roulette on the throughput relative to the start: light subpaths begin at the
+    // emitted power, not at 1
+    const double start = std::max(max_component(beta), 1e-30);
+    for (int bounce = bounce_offset; count < max_count; ++bounce) {
+        sampler.start_bounce(bounce, Sampler::kRouletteDimension);
+        const float roulette = sampler.get_1d();
+        if (bounce - bounce_offset >= kRouletteMinDepth) {
+            const double survival = std::min(1.0, max_component(beta) / start);
+            if (roulette >= survival) {
+                break;
+            }
+            beta = beta / survival;
+        }
+
+        HitRecord hit;
+        if (!scene.intersect(ray, 0.001f, 10000000000.0f, hit)) {
+            break;
+        }
+        const Material& material = hit.object->get_primitive_material(hit.primitive_index);
+        if (light_path && material.is_light) {
+            break;  // Lights do not scatter: nothing to connect to
+        }
+
+        PathVertex& previous = path[count - 1];
+        PathVertex& vertex = path[count];
+        vertex = PathVertex();
+        vertex.hit = hit;
+        vertex.beta = beta;
+        vertex.to_previous = -ray.direction.normalized();
+        vertex.pdf_forward = area_density(pdf, previous, vertex);
+        ++count;
+        if (material.is_light) {
+            vertex.is_light = true;
+            vertex.emission = material.brdf->color;
+            break;
+        }
+
+        vertex.brdf = material.brdf.get();
+        sampler.start_bounce(bounce, Sampler::kBRDFDimension);
+        ScatterRecord srec;
+        const TransportMode mode = light_path ? TransportMode::Importance : TransportMode::Radiance;
+        const TransportMode reverse_mode = light_path ? TransportMode::Radiance : TransportMode::Importance;
+        if (!vertex.brdf->sample(hit, vertex.to_previous, sampler, srec, mode)) {
+            break;
+        }
+        const Vector3 direction = srec.out_ray.direction.normalized();
+        if (srec.pdf > 0.0f) {
+            // Density of the reverse step, coming from direction and sampling the previous
+            // vertex as the subpath of the other side would
+            const float reverse = vertex.brdf->pdf(hit, direction, vertex.to_previous, reverse_mode);
+            previous.pdf_reverse = area_density(reverse, vertex, previous);
+        } else {
+            vertex.delta = true;
+            previous.pdf_reverse = 0.0f;
+        }
+        beta = beta * srec.attenuation;
+        if (is_black(beta)) {
+            break;
+        }
+        pdf = srec.pdf;
+        ray = srec.out_ray;
+    }
+    return count;
+}
+
+Color BidirectionalPathTracer::connect(const Scene& scene, const PathVertex* light, int s, const PathVertex* camera,
+                                       int t, PathVertex& sampled, Sampler& sampler) const {
+    const PathVertex& pt = camera[t - 1];
+    if (s == 0) {
+        // The camera subpath found a light by itself
+        return pt.is_light ? pt.beta * pt.emission : Color(0.0, 0.0, 0.0);
+    }
+    if (!pt.brdf) {
+        return Color(0.0, 0.0, 0.0);
+    }
+
+    if (s == 1) {
+        // Light sampling at pt, with the numbers the PathTracer uses at the same bounce
+        sampler.start_bounce(t - 2, Sampler::kLightDimension);
+        LightSample light_sample;
+        if (!m_lights.sample(pt.hit.point, pt.hit.normal, sampler, light_sample)) {
+            return Color(0.0, 0.0, 0.0);
+        }
+        const float cos_surface = pt.hit.normal.dot(light_sample.direction);
+        if (cos_surface <= 0.0f) {
+            return Color(0.0, 0.0, 0.0);
+        }
+        const Color f = pt.brdf->eval(pt.hit, pt.to_previous, light_sample.direction);
+        if (is_black(f)) {
+            return Color(0.0, 0.0, 0.0);
+        }
+        const Ray shadow_ray(pt.hit.point + light_sample.direction * 0.001f, light_sample.direction);
+        if (scene.occluded(shadow_ray, 0.001f, light_sample.distance - 0.001f)) {
+            return Color(0.0, 0.0, 0.0);
+        }
+        sampled.hit.point = pt.hit.point + light_sample.direction * light_sample.distance;
+        sampled.hit.normal = light_sample.normal;
+        sampled.emission = light_sample.radiance;
+        sampled.beta = light_sample.radiance / light_sample.pdf_position;
+        sampled.pdf_forward = light_sample.pdf_position;
+        sampled.pdf_emission = light_sample.pdf_emission;
+        sampled.is_light = true;
+        return pt.beta * f * light_sample.radiance * (cos_surface / light_sample.pdf);
+    }
+
+    // Both ends are surfaces: only the lobes with a density connect
+    const PathVertex& qs = light[s - 1];
+    const Vector3 offset = pt.hit.point - qs.hit.point;
+    const float distance2 = offset.length_squared();
+    if (distance2 <= 0.0f) {
+        return Color(0.0, 0.0, 0.0);
+    }
+    const float distance = std::sqrt(distance2);
+    const Vector3 direction = offset / distance;  // From qs to pt
+    const float cos_light_side = qs.hit.normal.dot(direction);
+    const float cos_camera_side = -pt.hit.normal.dot(direction);
+    if (cos_light_side <= 0.0f || cos_camera_side <= 0.0f) {
+        return Color(0.0, 0.0, 0.0);
+    }
+    const Color f_light_side = qs.brdf->eval(qs.hit, direction, qs.to_previous);
+    const Color f_camera_side = pt.brdf->eval(pt.hit, pt.to_previous, -direction);
+    if (is_black(f_light_side) || is_black(f_camera_side)) {
+        return Color(0.0, 0.0, 0.0);
+    }
+    // Emitters block here: a camera path stops at the first light it hits, so a light
+    // between the two vertices (or a ceiling lit from above a lamp) must not connect
+    // through it, which occluded() would allow. The segment stops short of both
+    // surfaces, or grazing connections hit the receiver itself
+    const Ray shadow_ray(qs.hit.point, direction);
+    HitRecord blocker;
+    if (scene.intersect(shadow_ray, kConnectionEpsilon, distance - kConnectionEpsilon, blocker)) {
+        return Color(0.0, 0.0, 0.0);
+    }
+    return qs.beta * f_light_side * f_camera_side * pt.beta * (cos_light_side * cos_camera_side / distance2);
+}
+
+Color BidirectionalPathTracer::connect_camera(const SceneConfig& config, const PathVertex* light, int s,
+                                              const PathVertex& lens, PathVertex& sampled, size_t& pixel) const {
+    const PathVertex& qs = light[s - 1];
+    if (!qs.brdf) {
+        return Color(0.0, 0.0, 0.0);
+    }
+    const int width = config.output_params.width;
+    const int height = config.output_params.height;
+    float u, v;
+    if (!config.camera.project(qs.hit.point, u, v)) {
+        return Color(0.0, 0.0, 0.0);
+    }
+    const int i = static_cast<int>(std::floor(u * (width - 1)));
+    const int j = static_cast<int>(std::floor(v * (height - 1)));
+    if (i < 0 || i >= width || j < 0 || j >= height) {
+        return Color(0.0, 0.0, 0.0);
+    }
+
+    const Vector3 offset = lens.hit.point - qs.hit.point;
+    const float distance2 = offset.length_squared();
+    if (distance2 <= 0.0f) {
+        return Color(0.0, 0.0, 0.0);
+    }
+    const float distance = std::sqrt(distance2);
+    const Vector3 direction = offset / distance;  // From qs to the lens
+    const float cos_light_side = qs.hit.normal.dot(direction);
+    if (cos_light_side <= 0.0f) {
+        return Color(0.0, 0.0, 0.0);
+    }
+    const Color f = qs.brdf->eval(qs.hit, direction, qs.to_previous);
+    if (is_black(f)) {
+        return Color(0.0, 0.0, 0.0);
+    }
+    // Emitters block, as in connect()
+    const Ray shadow_ray(qs.hit.point, direction);
+    HitRecord blocker;
+    if (config.scene.intersect(shadow_ray, kConnectionEpsilon, distance - kConnectionEpsilon, blocker)) {
+        return Color(0.0, 0.0, 0.0);
+    }
+
+    // W_e and the density are per unit (u, v) area; the film spreads them over film_area()
+    const Camera& camera = config.camera;
+    const float scale = 1.0f / film_area(width, height);
+    const float importance = camera.importance(-direction) * scale;
+    const float cos_camera = -direction.dot(camera.forward());
+    sampled = lens;
+    sampled.pdf_emission = camera.pdf(-direction) * scale;
+    pixel = static_cast<size_t>(height - 1 - j) * width + i;
+    return qs.beta * f * (cos_light_side * importance * cos_camera / distance2);
+}
+
+float BidirectionalPathTracer::mis_weight(const PathVertex* light, int s, const PathVertex* camera, int t,
+                                          const PathVertex& sampled) const {
+    // A light seen straight from the lens has no other strategy: (1, 1) is not used
+    if (s + t == 2) {
+        return 1.0f;
+    }
+    // Densities of the connection's end vertices and their neighbours as if the path
+    // had been sampled the other way (Veach's p_{i-1} / p_i ratios, as in pbrt)
+    const PathVertex& pt = t == 1 ? sampled : camera[t - 1];
+    const PathVertex* qs = s == 1 ? &sampled : s > 1 ? &light[s - 1] : nullptr;
+    float pt_reverse = 0.0f, pt_minus_reverse = 0.0f, qs_reverse = 0.0f, qs_minus_reverse = 0.0f;
+    if (s == 0) {
+        float pdf_position, pdf_direction;
+        if (!m_lights.emission_pdf(pt.hit, pt.to_previous, pdf_position, pdf_direction)) {
+            return 1.0f;  // A light the light subpaths never start on
+        }
+        pt_reverse = pdf_position;
+        pt_minus_reverse = area_density(pdf_direction, pt, camera[t - 2]);
+    } else {
+        const Vector3 to_camera = (pt.hit.point - qs->hit.point).normalized();
+        if (t == 1) {
+            // The lens: only the camera ray density, the pinhole itself is never sampled
+            qs_reverse = area_density(pt.pdf_emission, pt, *qs);
+        } else {
+            const float light_side =
+                s == 1 ? qs->pdf_emission
+                       : qs->brdf->pdf(qs->hit, qs->to_previous, to_camera, TransportMode::Importance);
+            pt_reverse = area_density(light_side, *qs, pt);
+            pt_minus_reverse = area_density(
+                pt.brdf->pdf(pt.hit, -to_camera, pt.to_previous, TransportMode::Importance), pt, camera[t - 2]);
+            qs_reverse = area_density(pt.brdf->pdf(pt.hit, pt.to_previous, -to_camera), pt, *qs);
+        }
+        if (s > 1) {
+            qs_minus_reverse = area_density(qs->brdf->pdf(qs->hit, to_camera, qs->to_previous), *qs, light[s - 2]);
+        }
+    }
+
+    // Moving the connection towards the camera: strategies (s + 1, t - 1), ... down to t = 1
+    float sum = 0.0f;
+    float ratio = 1.0f;
+    for (int i = t - 1; i >= 1; --i) {
+        const float reverse = i == t - 1 ? pt_reverse : i == t - 2 ? pt_minus_reverse : camera[i].pdf_reverse;
+        ratio *= remap_zero(reverse) / remap_zero(camera[i].pdf_forward);
+        const bool delta = i != t - 1 && camera[i].delta;
+        if (!delta && !camera[i - 1].delta) {
+            sum += ratio * ratio;
+        }
+    }
+
+    // Moving it towards the light: strategies (s - 1, t + 1), ... down to s = 0
+    ratio = 1.0f;
+    for (int i = s - 1; i >= 0; --i) {
+        const PathVertex& vertex = i == s - 1 ? *qs : light[i];
+        const float reverse = i == s - 1 ? qs_reverse : i == s - 2 ? qs_minus_reverse : light[i].pdf_reverse;
+        ratio *= remap_zero(reverse) / remap_zero(vertex.pdf_forward);
+        const bool delta = i != s - 1 && light[i].delta;
+        if (!delta && !(i > 0 && light[i - 1].delta)) {
+            sum += ratio * ratio;
+        }
+    }
+    return 1.0f / (1.0f + sum);
+}
+
+float BidirectionalPathTracer::film_area(int width, int height) {
+    // Pixel i covers u in [i, i + 1) / (width - 1), so the film runs past u = 1
+    return float(width) / (width - 1) * float(height) / (height - 1);
+}
+
+float BidirectionalPathTracer::area_density(float pdf, const PathVertex& from, const PathVertex& to) {
+    const Vector3 offset = to.hit.point - from.hit.point;
+    const float distance2 = offset.length_squared();
+    if (distance2 <= 0.0f) {
+        return 0.0f;
+    }
+    // Solid angle -> area: p_A = p_w |cos| / d^2 (the lens has no normal and gets 0)
+    return pdf * std::fabs(to.hit.normal.dot(offset)) / (distance2 * std::sqrt(distance2));
+}
+
+} // namespace PathRender
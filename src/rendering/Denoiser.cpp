@@ -0,0 +1,225 @@
+#include "PathRender/rendering/Denoiser.hpp"
+#include "PathRender/core/vector.hpp"
+#include "PathRender/utils/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace PathRender {
+
+namespace {
+
+// Albedo below this is clamped before dividing, so black channels stay finite
+constexpr float kMinAlbedo = 0.01f;
+
+// B3-spline weights of the 5x5 kernel (separable: h[x] * h[y])
+constexpr float kKernel[3] = {3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f};
+
+// 3x3 Gaussian used to smooth the variance estimate before it scales the luminance weight
+constexpr float kGaussian[2] = {1.0f / 2.0f, 1.0f / 4.0f};
+
+/// Demodulated irradiance and the variance of its luminance
+struct Texel {
+    float rgb[3] = {0.0f, 0.0f, 0.0f};
+    float variance = 0.0f;
+
+    float luminance() const { return 0.2126f * rgb[0] + 0.7152f * rgb[1] + 0.0722f * rgb[2]; }
+};
+
+float clamped_albedo(float value) {
+    return std::max(value, kMinAlbedo);
+}
+
+} // namespace
+
+void Denoiser::denoise(FrameBuffer& frame) const {
+    const int width = frame.width();
+    const int height = frame.height();
+    const size_t count = frame.pixel_count();
+
+    float* color[3] = {frame.channel(Channels::kRed), frame.channel(Channels::kGreen),
+                       frame.channel(Channels::kBlue)};
+    const float* coverage = frame.channel(Channels::kCoverage);
+    const float* albedo[3] = {frame.channel(Channels::kAlbedo[0]), frame.channel(Channels::kAlbedo[1]),
+                              frame.channel(Channels::kAlbedo[2])};
+    const float* depth = frame.channel(Channels::kDepth);
+    const float* variance = frame.channel(Channels::kVariance);
+
+    // Pixels mostly covered by the background or a light are left as they are
+    std::vector<uint8_t> surface(count);
+    std::vector<Vector3> normal(count);
+    const float* normal_channel[3] = {frame.channel(Channels::kNormal[0]), frame.channel(Channels::kNormal[1]),
+                                      frame.channel(Channels::kNormal[2])};
+    for (size_t p = 0; p < count; ++p) {
+        surface[p] = coverage[p] >= 0.5f && depth[p] > 0.0f;
+        const Vector3 n(normal_channel[0][p], normal_channel[1][p], normal_channel[2][p]);
+        const float length = n.length();
+        normal[p] = length > 0.0f ? n / length : n;
+    }
+
+    // Demodulate: filter the illumination, not the texture on top of it
+    std::vector<Texel> current(count), next(count);
+    for (size_t p = 0; p < count; ++p) {
+        if (!surface[p]) {
+            continue;
+        }
+        const float a[3] = {clamped_albedo(albedo[0][p]), clamped_albedo(albedo[1][p]), clamped_albedo(albedo[2][p])};
+        for (int c = 0; c < 3; ++c) {
+            current[p].rgb[c] = color[c][p] / a[c];
+        }
+        const float luminance = 0.2126f * a[0] + 0.7152f * a[1] + 0.0722f * a[2];
+        current[p].variance = variance[p] / (luminance * luminance);
+    }
+
+    // Screen-space depth slope per axis: the depth step expected between neighbours
+    // on the same surface, so tilted planes are not split into bands. The smaller of
+    // the two one-sided differences ignores the jump at an occlusion edge
+    std::vector<float> slope_x(count, 0.0f), slope_y(count, 0.0f);
+    auto slope = [&](int x, int y, int dx, int dy) {
+        const size_t p = static_cast<size_t>(y) * width + x;
+        float result = std::numeric_limits<float>::infinity();
+        for (int side : {-1, 1}) {
+            const int qx = x + side * dx;
+            const int qy = y + side * dy;
+            if (qx < 0 || qx >= width || qy < 0 || qy >= height) {
+                continue;
+            }
+            const size_t q = static_cast<size_t>(qy) * width + qx;
+            if (surface[q]) {
+                result = std::min(result, std::fabs(depth[q] - depth[p]));
+            }
+        }
+        return std::isinf(result) ? 0.0f : result;
+    };
+    Utils::parallel_for(height, 16, [&](size_t begin, size_t end) {
+        for (int y = static_cast<int>(begin); y < static_cast<int>(end); ++y) {
+            for (int x = 0; x < width; ++x) {
+                const size_t p = static_cast<size_t>(y) * width + x;
+                if (surface[p]) {
+                    slope_x[p] = slope(x, y, 1, 0);
+                    slope_y[p] = slope(x, y, 0, 1);
+                }
+            }
+        }
+    });
+
+    const int tiles_x = (width + kTileSize - 1) / kTileSize;
+    const int tiles_y = (height + kTileSize - 1) / kTileSize;
+
+    auto filter_tile = [&](int tile, int step) {
+        const int x0 = (tile % tiles_x) * kTileSize;
+        const int y0 = (tile / tiles_x) * kTileSize;
+        const int x1 = std::min(x0 + kTileSize, width);
+        const int y1 = std::min(y0 + kTileSize, height);
+
+        for (int y = y0; y < y1; ++y) {
+            for (int x = x0; x < x1; ++x) {
+                const size_t p = static_cast<size_t>(y) * width + x;
+                const Texel& center = current[p];
+                if (!surface[p]) {
+                    next[p] = center;
+                    continue;
+                }
+
+                // Smoothed variance: a single noisy estimate would make the weights noisy too
+                float smoothed_variance = 0.0f, gaussian_sum = 0.0f;
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        const int qx = x + dx, qy = y + dy;
+                        if (qx < 0 || qx >= width || qy < 0 || qy >= height) {
+                            continue;
+                        }
+                        const size_t q = static_cast<size_t>(qy) * width + qx;
+                        if (!surface[q]) {
+                            continue;
+                        }
+                        const float w = kGaussian[std::abs(dx)] * kGaussian[std::abs(dy)];
+                        smoothed_variance += w * current[q].variance;
+                        gaussian_sum += w;
+                    }
+                }
+                smoothed_variance /= gaussian_sum;
+
+                const float luminance = center.luminance();
+                const float luminance_scale = m_sigma_luminance * std::sqrt(std::max(smoothed_variance, 0.0f)) + 1e-6f;
+                const Vector3& center_normal = normal[p];
+                const float center_depth = depth[p];
+                const float center_albedo[3] = {albedo[0][p], albedo[1][p], albedo[2][p]};
+
+                Texel sum;
+                float weight_sum = 0.0f;
+                for (int ky = -2; ky <= 2; ++ky) {
+                    for (int kx = -2; kx <= 2; ++kx) {
+                        const int qx = x + kx * step, qy = y + ky * step;
+                        if (qx < 0 || qx >= width || qy < 0 || qy >= height) {
+                            continue;
+                        }
+                        const size_t q = static_cast<size_t>(qy) * width + qx;
+                        if (!surface[q]) {
+                            continue;
+                        }
+                        const Texel& sample = current[q];
+
+                        const float cos_normal = std::max(0.0f, center_normal.dot(normal[q]));
+                        const float w_normal = std::pow(cos_normal, m_sigma_normal);
+                        const float expected_depth =
+                            (slope_x[p] * std::abs(kx) + slope_y[p] * std::abs(ky)) * step;
+                        const float w_depth = std::fabs(center_depth - depth[q]) /
+                                              (m_sigma_depth * expected_depth + 1e-3f * center_depth);
+                        float albedo_distance = 0.0f;
+                        for (int c = 0; c < 3; ++c) {
+                            const float d = center_albedo[c] - albedo[c][q];
+                            albedo_distance += d * d;
+                        }
+                        const float w_albedo = albedo_distance / (m_sigma_albedo * m_sigma_albedo);
+                        const float w_luminance = std::fabs(luminance - sample.luminance()) / luminance_scale;
+
+                        const float w = kKernel[std::abs(kx)] * kKernel[std::abs(ky)] * w_normal *
+                                        std::exp(-w_depth - w_albedo - w_luminance);
+                        for (int c = 0; c < 3; ++c) {
+                            sum.rgb[c] += w * sample.rgb[c];
+                        }
+                        // The variance of a weighted mean: sum(w^2 var) / (sum w)^2
+                        sum.variance += w * w * sample.variance;
+                        weight_sum += w;
+                    }
+                }
+
+                if (weight_sum <= 0.0f) {
+                    next[p] = center;  // Only with a degenerate (zero) normal
+                    continue;
+                }
+                const float inv_weight = 1.0f / weight_sum;
+                for (int c = 0; c < 3; ++c) {
+                    next[p].rgb[c] = sum.rgb[c] * inv_weight;
+                }
+                next[p].variance = sum.variance * inv_weight * inv_weight;
+            }
+        }
+    };
+
+    Utils::ThreadPool& pool = Utils::ThreadPool::global();
+    for (int iteration = 0; iteration < m_iterations; ++iteration) {
+        const int step = 1 << iteration;
+        Utils::TaskGroup tasks(pool);
+        for (int tile = 0; tile < tiles_x * tiles_y; ++tile) {
+            tasks.run([&filter_tile, tile, step] { filter_tile(tile, step); });
+        }
+        tasks.wait();
+        std::swap(current, next);
+    }
+
+    // Remodulate; pixels without a surface keep their noisy value
+    for (size_t p = 0; p < count; ++p) {
+        if (!surface[p]) {
+            continue;
+        }
+        for (int c = 0; c < 3; ++c) {
+            color[c][p] = current[p].rgb[c] * clamped_albedo(albedo[c][p]);
+        }
+    }
+}
+
+} // namespace PathRender
@@ -0,0 +1,186 @@
+#include "PathRender/rendering/FrameBuffer.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+
+namespace PathRender {
+
+namespace {
+
+// OpenEXR 2.0 single-part scanline file, as laid out in "The OpenEXR File Layout":
+// magic, version, header attributes, a table of chunk offsets, then the chunks.
+// Values are little-endian, like the checkpoints of AccumulationBuffer.
+constexpr uint32_t kExrMagic = 20000630;
+constexpr uint32_t kExrVersion = 2;
+constexpr int32_t kExrPixelFloat = 2;
+
+/// Header and pixel data are assembled in memory, then written in one go
+class ExrWriter {
+public:
+    void bytes(const void* data, size_t size) {
+        const char* begin = static_cast<const char*>(data);
+        m_buffer.insert(m_buffer.end(), begin, begin + size);
+    }
+    template <typename T>
+    void value(T v) { bytes(&v, sizeof(v)); }
+    void string(const std::string& s) { bytes(s.c_str(), s.size() + 1); }
+
+    /// Attribute: name, type name, size in bytes, then the value written by the caller
+    void attribute(const std::string& name, const std::string& type, int32_t size) {
+        string(name);
+        string(type);
+        value(size);
+    }
+
+    size_t size() const { return m_buffer.size(); }
+    const std::vector<char>& buffer() const { return m_buffer; }
+
+private:
+    std::vector<char> m_buffer;
+};
+
+} // namespace
+
+FrameBuffer::FrameBuffer(const FrameBuffer& other) : m_width(other.m_width), m_height(other.m_height) {
+    for (const Channel& channel : other.m_channels) {
+        const size_t index = add_channel(channel.name);
+        std::copy(channel.data.get(), channel.data.get() + pixel_count(), m_channels[index].data.get());
+    }
+}
+
+FrameBuffer& FrameBuffer::operator=(const FrameBuffer& other) {
+    if (this != &other) {
+        FrameBuffer copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+void FrameBuffer::reset(int width, int height) {
+    m_width = width;
+    m_height = height;
+    m_channels.clear();
+}
+
+std::unique_ptr<float[], FrameBuffer::AlignedDelete> FrameBuffer::allocate_plane() const {
+    // Padded to whole cache lines, so no two planes share one
+    const size_t bytes = (pixel_count() * sizeof(float) + kAlignment - 1) / kAlignment * kAlignment;
+    float* data = static_cast<float*>(::operator new[](std::max(bytes, kAlignment), std::align_val_t(kAlignment)));
+    std::fill(data, data + bytes / sizeof(float), 0.0f);
+    return std::unique_ptr<float[], AlignedDelete>(data);
+}
+
+size_t FrameBuffer::add_channel(const std::string& name) {
+    const int existing = find_channel(name);
+    if (existing >= 0) {
+        return static_cast<size_t>(existing);
+    }
+    m_channels.push_back(Channel{name, allocate_plane()});
+    return m_channels.size() - 1;
+}
+
+int FrameBuffer::find_channel(const std::string& name) const {
+    for (size_t i = 0; i < m_channels.size(); ++i) {
+        if (m_channels[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+float* FrameBuffer::channel(const std::string& name) {
+    const int index = find_channel(name);
+    if (index < 0) {
+        throw std::out_of_range("FrameBuffer sem o canal " + name);
+    }
+    return m_channels[index].data.get();
+}
+
+const float* FrameBuffer::channel(const std::string& name) const {
+    const int index = find_channel(name);
+    if (index < 0) {
+        throw std::out_of_range("FrameBuffer sem o canal " + name);
+    }
+    return m_channels[index].data.get();
+}
+
+bool FrameBuffer::save_exr(const std::string& filename) const {
+    if (m_channels.empty() || pixel_count() == 0) {
+        std::cerr << "FrameBuffer vazio, nada a gravar em: " << filename << std::endl;
+        return false;
+    }
+
+    // The format requires the channel list (and the data of each line) in name order
+    std::vector<size_t> order(m_channels.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&](size_t a, size_t b) { return m_channels[a].name < m_channels[b].name; });
+
+    ExrWriter exr;
+    exr.value(kExrMagic);
+    exr.value(kExrVersion);
+
+    int32_t channel_list_size = 1;
+    for (const Channel& channel : m_channels) {
+        channel_list_size += static_cast<int32_t>(channel.name.size() + 1 + 16);
+    }
+    exr.attribute("channels", "chlist", channel_list_size);
+    for (size_t index : order) {
+        exr.string(m_channels[index].name);
+        exr.value(kExrPixelFloat);
+        exr.value(uint32_t{0});  // pLinear and three reserved bytes
+        exr.value(int32_t{1});   // x and y sampling
+        exr.value(int32_t{1});
+    }
+    exr.value(char{0});
+
+    exr.attribute("compression", "compression", 1);
+    exr.value(uint8_t{0});  // NO_COMPRESSION: one scanline per chunk
+    const int32_t window[4] = {0, 0, m_width - 1, m_height - 1};
+    exr.attribute("dataWindow", "box2i", sizeof(window));
+    exr.bytes(window, sizeof(window));
+    exr.attribute("displayWindow", "box2i", sizeof(window));
+    exr.bytes(window, sizeof(window));
+    exr.attribute("lineOrder", "lineOrder", 1);
+    exr.value(uint8_t{0});  // INCREASING_Y: row 0 is the top, as in the planes
+    exr.attribute("pixelAspectRatio", "float", 4);
+    exr.value(1.0f);
+    exr.attribute("screenWindowCenter", "v2f", 8);
+    exr.value(0.0f);
+    exr.value(0.0f);
+    exr.attribute("screenWindowWidth", "float", 4);
+    exr.value(1.0f);
+    exr.value(char{0});  // End of the header
+
+    const int32_t line_bytes = static_cast<int32_t>(m_width * m_channels.size() * sizeof(float));
+    const uint64_t first_chunk = exr.size() + static_cast<uint64_t>(m_height) * sizeof(uint64_t);
+    for (int y = 0; y < m_height; ++y) {
+        exr.value(first_chunk + static_cast<uint64_t>(y) * (2 * sizeof(int32_t) + line_bytes));
+    }
+    for (int y = 0; y < m_height; ++y) {
+        exr.value(static_cast<int32_t>(y));
+        exr.value(line_bytes);
+        for (size_t index : order) {
+            exr.bytes(m_channels[index].data.get() + static_cast<size_t>(y) * m_width, m_width * sizeof(float));
+        }
+    }
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao criar arquivo: " << filename << std::endl;
+        return false;
+    }
+    file.write(exr.buffer().data(), static_cast<std::streamsize>(exr.size()));
+    if (!file) {
+        std::cerr << "Erro ao gravar arquivo: " << filename << std::endl;
+        return false;
+    }
+    std::cout << "Camadas salvas em: " << filename << " (" << m_channels.size() << " canais)" << std::endl;
+    return true;
+}
+
+} // namespace PathRender
@@ -0,0 +1,530 @@
+#include "PathRender/rendering/LightSampler.hpp"
+#include "PathRender/objects/mesh.hpp"
+#include "PathRender/objects/sphere.hpp"
+#include "PathRender/utils/math_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace PathRender {
+
+namespace {
+
+float luminance(const Color& color) {
+    return static_cast<float>(0.2126 * color.r + 0.7152 * color.g + 0.0722 * color.b);
+}
+
+float safe_sqrt(float x) {
+    return std::sqrt(std::max(0.0f, x));
+}
+
+// cos(max(0, a - b)) and sin(max(0, a - b)) from the sines and cosines of a and b
+float cos_sub_clamped(float sin_a, float cos_a, float sin_b, float cos_b) {
+    return cos_a > cos_b ? 1.0f : cos_a * cos_b + sin_a * sin_b;
+}
+
+float sin_sub_clamped(float sin_a, float cos_a, float sin_b, float cos_b) {
+    return cos_a > cos_b ? 0.0f : sin_a * cos_b - cos_a * sin_b;
+}
+
+float angle_between(const Vector3& a, const Vector3& b) {
+    return std::acos(std::clamp(a.dot(b), -1.0f, 1.0f));
+}
+
+// Rotates v by angle around the unit axis (Rodrigues)
+Vector3 rotate(const Vector3& v, const Vector3& axis, float angle) {
+    const float c = std::cos(angle);
+    const float s = std::sin(angle);
+    return v * c + axis.cross(v) * s + axis * (axis.dot(v) * (1.0f - c));
+}
+
+} // namespace
+
+const char* light_selection_name(LightSelection selection) {
+    switch (selection) {
+        case LightSelection::Power:
+            return "power";
+        case LightSelection::BVH:
+        default:
+            return "bvh";
+    }
+}
+
+bool parse_light_selection(const std::string& name, LightSelection& selection) {
+    for (LightSelection candidate : {LightSelection::Power, LightSelection::BVH}) {
+        if (name == light_selection_name(candidate)) {
+            selection = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+LightSampler::LightBounds LightSampler::light_bounds(const AreaLight& light) {
+    LightBounds bounds;
+    bounds.power = light.power;
+    if (light.shape == AreaLight::Shape::Triangle) {
+        bounds.bounds = AABB(light.origin, light.origin + light.edge1);
+        bounds.bounds.expand(light.origin + light.edge2);
+        bounds.axis = light.edge1.cross(light.edge2).normalized();
+        bounds.cos_theta_o = 1.0f;
+        bounds.two_sided = true;
+    } else {
+        const Vector3 r(light.radius, light.radius, light.radius);
+        bounds.bounds = AABB(light.origin - r, light.origin + r);
+        bounds.cos_theta_o = -1.0f;  // Normals in every direction
+    }
+    return bounds;
+}
+
+LightSampler::LightBounds LightSampler::merge(const LightBounds& a, const LightBounds& b) {
+    LightBounds merged;
+    merged.bounds = a.bounds;
+    merged.bounds.expand(b.bounds);
+    merged.power = a.power + b.power;
+    merged.two_sided = a.two_sided || b.two_sided;
+
+    // Smallest cone holding both cones (pbrt-v4, DirectionCone Union)
+    const float theta_a = std::acos(std::clamp(a.cos_theta_o, -1.0f, 1.0f));
+    const float theta_b = std::acos(std::clamp(b.cos_theta_o, -1.0f, 1.0f));
+    const float theta_d = angle_between(a.axis, b.axis);
+    const float pi = static_cast<float>(M_PI);
+    if (std::min(theta_d + theta_b, pi) <= theta_a) {
+        merged.axis = a.axis;
+        merged.cos_theta_o = a.cos_theta_o;
+        return merged;
+    }
+    if (std::min(theta_d + theta_a, pi) <= theta_b) {
+        merged.axis = b.axis;
+        merged.cos_theta_o = b.cos_theta_o;
+        return merged;
+    }
+    const float theta_o = 0.5f * (theta_a + theta_d + theta_b);
+    const Vector3 rotation_axis = a.axis.cross(b.axis);
+    if (theta_o >= pi || rotation_axis.length_squared() == 0.0f) {
+        merged.axis = a.axis;
+        merged.cos_theta_o = -1.0f;
+        return merged;
+    }
+    merged.axis = rotate(a.axis, rotation_axis.normalized(), theta_o - theta_a).normalized();
+    merged.cos_theta_o = std::cos(theta_o);
+    return merged;
+}
+
+float LightSampler::importance(const LightBounds& bounds, const Point3& point, const Vector3& normal) {
+    // Distance to the center, clamped to the bounding sphere so that points
+    // inside a cluster do not blow up
+    const Point3 center = bounds.bounds.centroid();
+    const Vector3 from_center = point - center;
+    const float radius_squared = 0.25f * bounds.bounds.extent().length_squared();
+    const float distance_squared = from_center.length_squared();
+
+    // Angle between the cone axis and the direction to the point
+    float cos_theta_w = distance_squared > 0.0f ? bounds.axis.dot(from_center) / std::sqrt(distance_squared) : 1.0f;
+    if (bounds.two_sided) {
+        cos_theta_w = std::fabs(cos_theta_w);
+    }
+    const float sin_theta_w = safe_sqrt(1.0f - cos_theta_w * cos_theta_w);
+
+    // Half-angle under which the point sees the bounds (everything, from inside)
+    float cos_theta_b = -1.0f;
+    if (distance_squared > radius_squared) {
+        cos_theta_b = safe_sqrt(1.0f - radius_squared / distance_squared);
+    }
+    const float sin_theta_b = safe_sqrt(1.0f - cos_theta_b * cos_theta_b);
+
+    // Smallest angle between any normal of the cone and any direction from the
+    // bounds to the point; diffuse emitters reach up to pi/2 from their normal
+    const float sin_theta_o = safe_sqrt(1.0f - bounds.cos_theta_o * bounds.cos_theta_o);
+    const float cos_theta_x = cos_sub_clamped(sin_theta_w, cos_theta_w, sin_theta_o, bounds.cos_theta_o);
+    const float sin_theta_x = sin_sub_clamped(sin_theta_w, cos_theta_w, sin_theta_o, bounds.cos_theta_o);
+    const float cos_theta_p = cos_sub_clamped(sin_theta_x, cos_theta_x, sin_theta_b, cos_theta_b);
+    if (cos_theta_p <= 0.0f) {
+        return 0.0f;
+    }
+    float result = bounds.power * cos_theta_p / std::max(distance_squared, radius_squared);
+
+    // Lights behind the surface cannot reach it: the whole box lies behind the tangent
+    // plane if not even its farthest corner along the normal is in front of it
+    const Vector3 half_extent = bounds.bounds.extent() * 0.5f;
+    const float corner_height = -normal.dot(from_center) + std::fabs(normal.x) * half_extent.x +
+                                std::fabs(normal.y) * half_extent.y + std::fabs(normal.z) * half_extent.z;
+    if (corner_height <= 0.0f) {
+        return 0.0f;
+    }
+
+    // Same bound for the cosine at the receiver, from the cone that holds the bounds
+    if (distance_squared > 0.0f) {
+        const float cos_theta_i = -normal.dot(from_center) / std::sqrt(distance_squared);
+        const float sin_theta_i = safe_sqrt(1.0f - cos_theta_i * cos_theta_i);
+        const float cos_theta_pi = cos_sub_clamped(sin_theta_i, cos_theta_i, sin_theta_b, cos_theta_b);
+        if (cos_theta_pi <= 0.0f) {
+            return 0.0f;
+        }
+        result *= cos_theta_pi;
+    }
+    return result;
+}
+
+void LightSampler::build(const Scene& scene) {
+    m_lights.clear();
+    m_light_index.clear();
+    m_alias.clear();
+    m_power_pdf.clear();
+    m_nodes.clear();
+    m_light_trail.clear();
+
+    const auto& objects = scene.get_objects();
+    for (uint32_t object_index = 0; object_index < objects.size(); ++object_index) {
+        const auto& object = objects[object_index];
+        if (const auto* mesh = dynamic_cast<const Mesh*>(object.get())) {
+            const std::vector<Point3>& vertices = mesh->get_vertices();
+            const std::vector<uint32_t>& indices = mesh->get_indices();
+            for (uint32_t t = 0; t < mesh->triangle_count(); ++t) {
+                const Material& material = mesh->get_primitive_material(t);
+                if (!material.is_light) {
+                    continue;
+                }
+                AreaLight light;
+                light.shape = AreaLight::Shape::Triangle;
+                light.origin = vertices[indices[3 * t]];
+                light.edge1 = vertices[indices[3 * t + 1]] - light.origin;
+                light.edge2 = vertices[indices[3 * t + 2]] - light.origin;
+                light.radiance = material.brdf->color;
+                light.area = 0.5f * light.edge1.cross(light.edge2).length();
+                light.object = mesh;
+                light.object_index = object_index;
+                light.primitive_index = t;
+                m_lights.push_back(light);
+            }
+        } else if (const auto* sphere = dynamic_cast<const Sphere*>(object.get())) {
+            const Material& material = sphere->get_material();
+            if (!material.is_light) {
+                continue;
+            }
+            AreaLight light;
+            light.shape = AreaLight::Shape::Sphere;
+            light.origin = sphere->get_center();
+            light.radius = sphere->get_radius();
+            light.radiance = material.brdf->color;
+            light.area = 4.0f * static_cast<float>(M_PI) * light.radius * light.radius;
+            light.object = sphere;
+            light.object_index = object_index;
+            m_lights.push_back(light);
+        } else if (object->is_emissive()) {
+            std::cerr << "Aviso: objeto emissivo sem área finita ignorado na amostragem de luz: "
+                      << object->to_string() << std::endl;
+        }
+    }
+
+    // Degenerate or black emitters get no samples. Emitted power is pi L A per
+    // emitting face: triangles emit from both faces
+    m_lights.erase(std::remove_if(m_lights.begin(), m_lights.end(),
+                                  [](AreaLight& light) {
+                                      const float faces = light.shape == AreaLight::Shape::Triangle ? 2.0f : 1.0f;
+                                      light.power = luminance(light.radiance) * light.area * faces;
+                                      return !(light.power > 0.0f);
+                                  }),
+                   m_lights.end());
+
+    for (uint32_t i = 0; i < m_lights.size(); ++i) {
+        m_light_index[light_key(m_lights[i].object_index, m_lights[i].primitive_index)] = i;
+    }
+    if (m_lights.empty()) {
+        return;
+    }
+
+    // The alias table also picks the lights that emit photons, whatever the selection
+    build_alias_table();
+    if (m_selection == LightSelection::BVH) {
+        std::vector<uint32_t> indices(m_lights.size());
+        for (uint32_t i = 0; i < indices.size(); ++i) {
+            indices[i] = i;
+        }
+        std::vector<Point3> centroids(m_lights.size());
+        for (uint32_t i = 0; i < centroids.size(); ++i) {
+            centroids[i] = light_bounds(m_lights[i]).bounds.centroid();
+        }
+        m_light_trail.assign(m_lights.size(), 0);
+        m_nodes.reserve(2 * m_lights.size() - 1);
+        build_bvh(indices, centroids, 0, indices.size(), 0, 0);
+    }
+}
+
+void LightSampler::build_alias_table() {
+    const size_t count = m_lights.size();
+    double total = 0.0;
+    for (const AreaLight& light : m_lights) {
+        total += light.power;
+    }
+
+    // Vose's method: bins under the average are topped up by bins above it
+    m_alias.assign(count, AliasBin());
+    m_power_pdf.resize(count);
+    std::vector<double> scaled(count);
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    for (uint32_t i = 0; i < count; ++i) {
+        m_power_pdf[i] = static_cast<float>(m_lights[i].power / total);
+        scaled[i] = m_lights[i].power / total * count;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        const uint32_t under = small.back();
+        small.pop_back();
+        const uint32_t over = large.back();
+        m_alias[under].q = static_cast<float>(scaled[under]);
+        m_alias[under].alias = over;
+        scaled[over] -= 1.0 - scaled[under];
+        if (scaled[over] < 1.0) {
+            large.pop_back();
+            small.push_back(over);
+        }
+    }
+    // Whatever is left is 1 up to rounding
+    for (uint32_t i : small) {
+        m_alias[i].q = 1.0f;
+    }
+    for (uint32_t i : large) {
+        m_alias[i].q = 1.0f;
+    }
+}
+
+uint32_t LightSampler::build_bvh(std::vector<uint32_t>& indices, const std::vector<Point3>& centroids,
+                                 size_t begin, size_t end, int depth, uint64_t trail) {
+    const uint32_t node_index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+
+    if (end - begin == 1) {
+        const uint32_t light = indices[begin];
+        m_nodes[node_index].bounds = light_bounds(m_lights[light]);
+        m_nodes[node_index].offset = light;
+        m_nodes[node_index].leaf = true;
+        m_light_trail[light] = trail;
+        return node_index;
+    }
+
+    // Median split along the longest axis of the light centroids
+    AABB centroid_bounds;
+    for (size_t i = begin; i < end; ++i) {
+        centroid_bounds.expand(centroids[indices[i]]);
+    }
+    const int axis = centroid_bounds.longest_axis();
+    const size_t middle = begin + (end - begin) / 2;
+    std::nth_element(indices.begin() + begin, indices.begin() + middle, indices.begin() + end,
+                     [&](uint32_t a, uint32_t b) {
+                         return AABB::axis(centroids[a], axis) < AABB::axis(centroids[b], axis);
+                     });
+
+    // Depth stays below 64 for any light count that fits in memory (median split)
+    const uint32_t first = build_bvh(indices, centroids, begin, middle, depth + 1, trail);
+    const uint32_t second = build_bvh(indices, centroids, middle, end, depth + 1, trail | (uint64_t(1) << depth));
+    m_nodes[node_index].bounds = merge(m_nodes[first].bounds, m_nodes[second].bounds);
+    m_nodes[node_index].offset = second;
+    return node_index;
+}
+
+uint32_t LightSampler::select_by_power(float u) const {
+    // One bin per light; the fraction of u left inside the bin picks the light or its alias
+    const float scaled = u * static_cast<float>(m_alias.size());
+    const size_t bin = std::min(static_cast<size_t>(scaled), m_alias.size() - 1);
+    return scaled - static_cast<float>(bin) < m_alias[bin].q ? static_cast<uint32_t>(bin) : m_alias[bin].alias;
+}
+
+bool LightSampler::select(const Point3& point, const Vector3& normal, float u, uint32_t& index, float& probability) const {
+    if (m_selection == LightSelection::Power) {
+        index = select_by_power(u);
+        probability = m_power_pdf[index];
+        return true;
+    }
+
+    // Walk down the tree choosing each child by its importance, reusing u
+    uint32_t node = 0;
+    probability = 1.0f;
+    while (!m_nodes[node].leaf) {
+        const uint32_t first = node + 1;
+        const uint32_t second = m_nodes[node].offset;
+        const float importance_first = importance(m_nodes[first].bounds, point, normal);
+        const float importance_second = importance(m_nodes[second].bounds, point, normal);
+        const float total = importance_first + importance_second;
+        if (total <= 0.0f) {
+            return false;
+        }
+        const float p_first = importance_first / total;
+        if (u < p_first) {
+            node = first;
+            u = std::min(u / p_first, 0x1.fffffep-1f);
+            probability *= p_first;
+        } else {
+            node = second;
+            u = std::min((u - p_first) / (1.0f - p_first), 0x1.fffffep-1f);
+            probability *= importance_second / total;
+        }
+    }
+    index = m_nodes[node].offset;
+    return true;
+}
+
+float LightSampler::selection_pdf(const Point3& point, const Vector3& normal, uint32_t index) const {
+    if (m_selection == LightSelection::Power) {
+        return m_power_pdf[index];
+    }
+
+    // Same choices as select(), following the light's path from the root
+    const uint64_t trail = m_light_trail[index];
+    uint32_t node = 0;
+    float probability = 1.0f;
+    for (int depth = 0; !m_nodes[node].leaf; ++depth) {
+        const uint32_t first = node + 1;
+        const uint32_t second = m_nodes[node].offset;
+        const float importance_first = importance(m_nodes[first].bounds, point, normal);
+        const float importance_second = importance(m_nodes[second].bounds, point, normal);
+        const float total = importance_first + importance_second;
+        if (total <= 0.0f) {
+            return 0.0f;
+        }
+        if ((trail >> depth) & 1) {
+            node = second;
+            probability *= importance_second / total;
+        } else {
+            node = first;
+            probability *= importance_first / total;
+        }
+    }
+    return probability;
+}
+
+bool LightSampler::sample(const Point3& point, const Vector3& normal, Sampler& sampler, LightSample& sample) const {
+    const float u_light = sampler.get_1d();
+    const float u1 = sampler.get_1d();
+    const float u2 = sampler.get_1d();
+    if (m_lights.empty()) {
+        return false;
+    }
+
+    uint32_t index;
+    float selection_probability;
+    if (!select(point, normal, u_light, index, selection_probability) || selection_probability <= 0.0f) {
+        return false;
+    }
+    const AreaLight& light = m_lights[index];
+
+    // Uniform point on the light's area, and its normal
+    Point3 light_point;
+    Vector3 light_normal;
+    if (light.shape == AreaLight::Shape::Triangle) {
+        const float su = std::sqrt(u1);
+        light_point = light.origin + light.edge1 * (1.0f - su) + light.edge2 * (u2 * su);
+        light_normal = light.edge1.cross(light.edge2).normalized();
+    } else {
+        const float z = 1.0f - 2.0f * u1;
+        const float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+        const float phi = 2.0f * static_cast<float>(M_PI) * u2;
+        light_normal = Vector3(r * std::cos(phi), r * std::sin(phi), z);
+        light_point = light.origin + light_normal * light.radius;
+    }
+
+    const Vector3 to_light = light_point - point;
+    const float distance_squared = to_light.length_squared();
+    if (distance_squared <= 0.0f) {
+        return false;
+    }
+    sample.distance = std::sqrt(distance_squared);
+    sample.direction = to_light / sample.distance;
+
+    // Triangles emit from both faces; a sphere point facing away is hidden by the sphere itself
+    float cos_light = -light_normal.dot(sample.direction);
+    if (light.shape == AreaLight::Shape::Triangle) {
+        cos_light = std::fabs(cos_light);
+    }
+    if (cos_light <= 0.0f) {
+        return false;
+    }
+
+    // Area density -> solid angle density: p_w = p_A d^2 / cos_light
+    const float faces = light.shape == AreaLight::Shape::Triangle ? 2.0f : 1.0f;
+    sample.pdf_position = selection_probability / light.area;
+    sample.pdf = sample.pdf_position * distance_squared / cos_light;
+    sample.pdf_emission = cos_light / (static_cast<float>(M_PI) * faces);
+    sample.normal = light_normal.dot(sample.direction) < 0.0f ? light_normal : -light_normal;
+    sample.radiance = light.radiance;
+    return true;
+}
+
+float LightSampler::pdf(const Point3& point, const Vector3& normal, const HitRecord& light_hit) const {
+    const auto found = m_light_index.find(light_key(light_hit.object_index, light_hit.primitive_index));
+    if (found == m_light_index.end()) {
+        return 0.0f;
+    }
+    const AreaLight& light = m_lights[found->second];
+
+    const Vector3 to_light = light_hit.point - point;
+    const float distance_squared = to_light.length_squared();
+    // The hit normal faces the incoming ray, so this is the cosine at the light
+    const float cos_light = -light_hit.normal.dot(to_light) / std::sqrt(distance_squared);
+    if (cos_light <= 0.0f) {
+        return 0.0f;
+    }
+    return selection_pdf(point, normal, found->second) / light.area * distance_squared / cos_light;
+}
+
+bool LightSampler::sample_emission(Sampler& sampler, EmissionSample& sample) const {
+    const float u_light = sampler.get_1d();
+    const float u_face = sampler.get_1d();
+    const float u1 = sampler.get_1d();
+    const float u2 = sampler.get_1d();
+    const float u3 = sampler.get_1d();
+    const float u4 = sampler.get_1d();
+    if (m_lights.empty()) {
+        return false;
+    }
+
+    const uint32_t index = select_by_power(u_light);
+    const AreaLight& light = m_lights[index];
+
+    Point3 light_point;
+    Vector3 light_normal;
+    float faces = 1.0f;
+    if (light.shape == AreaLight::Shape::Triangle) {
+        const float su = std::sqrt(u1);
+        light_point = light.origin + light.edge1 * (1.0f - su) + light.edge2 * (u2 * su);
+        light_normal = light.edge1.cross(light.edge2).normalized();
+        if (u_face < 0.5f) {
+            light_normal = -light_normal;
+        }
+        faces = 2.0f;
+    } else {
+        const float z = 1.0f - 2.0f * u1;
+        const float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+        const float phi = 2.0f * static_cast<float>(M_PI) * u2;
+        light_normal = Vector3(r * std::cos(phi), r * std::sin(phi), z);
+        light_point = light.origin + light_normal * light.radius;
+    }
+
+    // L_e cos / (p_light p_face / A x cos / pi) = L_e pi A faces / p_light
+    const Vector3 direction = Utils::cosine_sample_hemisphere(light_normal, u3, u4);
+    sample.ray = Ray(light_point + light_normal * 0.01f, direction);
+    sample.flux = light.radiance * (static_cast<float>(M_PI) * light.area * faces / m_power_pdf[index]);
+    sample.point = light_point;
+    sample.normal = light_normal;
+    sample.radiance = light.radiance;
+    sample.pdf_position = m_power_pdf[index] / light.area;
+    sample.pdf_direction = std::max(0.0f, light_normal.dot(direction)) / (static_cast<float>(M_PI) * faces);
+    return true;
+}
+
+bool LightSampler::emission_pdf(const HitRecord& light_hit, const Vector3& direction, float& pdf_position,
+                                float& pdf_direction) const {
+    const auto found = m_light_index.find(light_key(light_hit.object_index, light_hit.primitive_index));
+    if (found == m_light_index.end()) {
+        return false;
+    }
+    const AreaLight& light = m_lights[found->second];
+    const float faces = light.shape == AreaLight::Shape::Triangle ? 2.0f : 1.0f;
+    pdf_position = m_power_pdf[found->second] / light.area;
+    // The hit normal faces where the ray came from, which is the emitting side
+    pdf_direction = std::max(0.0f, light_hit.normal.dot(direction)) / (static_cast<float>(M_PI) * faces);
+    return true;
+}
+
+} // namespace PathRender
@@ -1,6 +1,14 @@
 #include "PathRender/rendering/PathTracer.hpp"
+#include "PathRender/utils/thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
 #include <iomanip>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
 
 namespace PathRender {
 
@@ -11,242 +19,493 @@ void PathTracer::render(std::vector<Color>& buffer, const SceneConfig& config) {
     
     const Scene& scene = config.scene;
     
-    // Extract light points for direct lighting (only if enabled)
+    // Emissive surfaces sampled for direct lighting (only if enabled)
+    m_lights = LightSampler(m_light_selection);
     if (m_direct_lighting_enabled) {
-        extract_light_points(scene);
-        std::cout << "Found " << m_light_points.size() << " light sources for direct lighting" << std::endl;
+        m_lights.build(scene);
+        std::cout << "Found " << m_lights.size() << " emissive primitives for direct lighting (selection: "
+                  << light_selection_name(m_light_selection) << ")" << std::endl;
     } else {
         std::cout << "Direct lighting disabled - using pure Monte Carlo" << std::endl;
     }
+    if (m_radiance_cache_enabled) {
+        if (!m_radiance_cache) {
+            m_radiance_cache = std::make_unique<RadianceCache>();
+        }
+        const float cell_size = m_radiance_cache_cell_size > 0.0f ? m_radiance_cache_cell_size
+                                                                  : RadianceCache::default_cell_size(scene);
+        // A kept cache answers from the first pass; a new one is warmed by it (every lookup misses)
+        const bool reused = m_radiance_cache_persistent && m_radiance_cache->cell_size() == cell_size &&
+                            m_radiance_cache->occupied() > 0;
+        if (!reused) {
+            m_radiance_cache->reset(cell_size);
+        }
+        std::cout << "Radiance cache: células de " << cell_size << " unidades, consultado a partir do rebote "
+                  << m_radiance_cache_depth << (reused ? " (reaproveitado)" : "") << std::endl;
+    }
     const Camera& camera = config.camera;
     const int width = config.output_params.width;
     const int height = config.output_params.height;
-    const int number_of_rays = 100;
+    const uint32_t max_samples = static_cast<uint32_t>(std::max(m_max_samples, 1));
+    const uint32_t pass_samples = static_cast<uint32_t>(std::max(m_pass_samples, 1));
+    const bool adaptive = m_adaptive_threshold > 0.0f && static_cast<uint32_t>(m_min_samples) < max_samples;
+    // Samples every pixel gets before its error is trusted (2 are needed for a variance)
+    const uint32_t base_samples = adaptive ? static_cast<uint32_t>(std::max(m_min_samples, 2)) : 0;
     
-    // Thread management variables
-    const int num_threads = 8;
-    std::vector<std::thread> threads;
-    int rows_per_thread = height / num_threads;
-    
-    // Atomic counter for progress bar (safe to increment from multiple threads)
-    std::atomic<int> pixels_rendered{0};
-    int total_pixels = width * height;
+    // Work is split into small tiles pulled by the shared pool (the same threads that
+    // build the BVHs): expensive tiles (glass, light) no longer stall a whole band
+    Utils::ThreadPool& pool = Utils::ThreadPool::global();
+    const int tiles_x = (width + kTileSize - 1) / kTileSize;
+    const int tiles_y = (height + kTileSize - 1) / kTileSize;
+    const int tile_count = tiles_x * tiles_y;
+
+    // Running sums per pixel, in image order (row 0 at the top), optionally resumed from disk
+    AccumulationBuffer& pixels = m_accumulation;
+    if (m_resume && !m_checkpoint_file.empty()) {
+        pixels = AccumulationBuffer::load(m_checkpoint_file);
+        if (pixels.width() != width || pixels.height() != height) {
+            throw std::runtime_error("Checkpoint " + m_checkpoint_file + " tem " + std::to_string(pixels.width()) +
+                                     "x" + std::to_string(pixels.height()) + " pixels, a cena tem " +
+                                     std::to_string(width) + "x" + std::to_string(height));
+        }
+        std::cout << "Retomando checkpoint " << m_checkpoint_file << ": " << pixels.total_samples()
+                  << " amostras, " << pixels.passes() << " passes" << std::endl;
+    } else {
+        pixels.reset(width, height);
+    }
+    std::vector<uint8_t> active(pixels.size(), 1);
+
+    // Output channels, written as each pixel finishes its samples of a pass. The
+    // first-hit AOVs average the samples of this render only: resumed_samples holds
+    // the count each pixel had in the checkpoint
+    m_frame.reset(width, height);
+    const char* const color_channels[] = {Channels::kRed, Channels::kGreen, Channels::kBlue};
+    float* color[3];
+    for (int c = 0; c < 3; ++c) {
+        color[c] = m_frame.channel(m_frame.add_channel(color_channels[c]));
+    }
+    float* sample_count = m_frame.channel(m_frame.add_channel(Channels::kSamples));
+    float* variance = m_frame.channel(m_frame.add_channel(Channels::kVariance));
+    auto store_pixel = [&](size_t index, const PixelAccumulator& pixel) {
+        const Color mean = pixel.mean();
+        color[0][index] = static_cast<float>(mean.r);
+        color[1][index] = static_cast<float>(mean.g);
+        color[2][index] = static_cast<float>(mean.b);
+        sample_count[index] = static_cast<float>(pixel.samples);
+        variance[index] = mean_variance(pixel);
+    };
+    float* coverage = m_frame.channel(m_frame.add_channel(Channels::kCoverage));
+    float* albedo[3], *normal[3];
+    for (int c = 0; c < 3; ++c) {
+        albedo[c] = m_frame.channel(m_frame.add_channel(Channels::kAlbedo[c]));
+        normal[c] = m_frame.channel(m_frame.add_channel(Channels::kNormal[c]));
+    }
+    float* depth = m_frame.channel(m_frame.add_channel(Channels::kDepth));
+    std::vector<uint32_t> resumed_samples;
+    if (pixels.total_samples() > 0) {
+        resumed_samples.resize(pixels.size());
+        for (size_t p = 0; p < pixels.size(); ++p) {
+            resumed_samples[p] = pixels[p].samples;
+            store_pixel(p, pixels[p]);
+        }
+    }
+
+    // Progress is reported once per tile
+    std::atomic<int> tiles_done{0};
+    std::atomic<long long> samples_taken{0};
+    std::atomic<int> pixels_sampled{0};
     std::mutex print_mutex; // To prevent garbled console output
 
-    // The function that each thread will run
-    auto render_chunk = [&](int start_row, int end_row, int thread_id) {
-        // 1. Create a LOCAL Random Number Generator for this thread
-        // We seed it with random_device + thread_id to ensure unique sequences
-        std::mt19937 thread_rng(std::random_device{}() + thread_id);
-        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    // Busy time per pool thread (the last slot is the calling thread, which helps in wait())
+    std::vector<double> busy_seconds(pool.size() + 1, 0.0);
 
-        for (int j = start_row; j < end_row; ++j) {
-            for (int i = 0; i < width; ++i) {
-                Color pixel_color(0, 0, 0);
+    // Every pass first brings pixels up to the base samples, then adds up to
+    // pass_samples to the active ones (all unfinished pixels when sampling
+    // uniformly, only those still above the error threshold when adaptive)
+    auto render_tile = [&](int tile, uint32_t pass) {
+        const auto tile_start = std::chrono::steady_clock::now();
+        const int x0 = (tile % tiles_x) * kTileSize;
+        const int y0 = (tile / tiles_x) * kTileSize;
+        const int x1 = std::min(x0 + kTileSize, width);
+        const int y1 = std::min(y0 + kTileSize, height);
+
+        // Random numbers depend only on (seed, pixel, sample index, dimension), never on
+        // the thread or tile order, so the image is reproducible bit for bit
+        std::unique_ptr<Sampler> tile_sampler = make_sampler(m_sampler_type, m_seed, m_max_samples);
+        Sampler& sampler = *tile_sampler;
+        int tile_samples = 0;
+        int tile_pixels = 0;
+
+        for (int j = y0; j < y1; ++j) {
+            for (int i = x0; i < x1; ++i) {
+                const size_t index = static_cast<size_t>(height - 1 - j) * width + i;
+                PixelAccumulator& pixel = pixels[index];
+                uint32_t samples = 0;
+                if (pixel.samples < base_samples) {
+                    samples = base_samples - pixel.samples;
+                } else if (active[index]) {
+                    samples = std::min(pass_samples, max_samples - pixel.samples);
+                }
+                if (samples == 0) {
+                    continue;
+                }
 
                 // Anti-Aliasing Loop
-                for(int k = 0; k < number_of_rays; k++){    
-                    // Use local thread_rng
-                    float u = (float(i) + dist(thread_rng)) / (width - 1);
-                    float v = (float(j) + dist(thread_rng)) / (height - 1);
+                const uint32_t previous_samples = pixel.samples - (resumed_samples.empty() ? 0 : resumed_samples[index]);
+                FirstHit first_hits;
+                for (uint32_t k = 0; k < samples; k++) {
+                    sampler.start_pixel_sample(static_cast<uint32_t>(j * width + i), pixel.samples);
+                    float u = (float(i) + sampler.get_1d()) / (width - 1);
+                    float v = (float(j) + sampler.get_1d()) / (height - 1);
                     
                     Ray ray = camera.get_ray(u, v);
-                    // Pass the local RNG down the chain
-                    pixel_color += trace_path(ray, 0, scene, thread_rng);                
+                    // Pass the sampler down the chain
+                    pixel.add(trace_path(ray, scene, sampler, &first_hits));
                 }
+                store_pixel(index, pixel);
 
-                pixel_color /= (double)number_of_rays;
-                pixel_color = Color(sqrt(pixel_color.r), sqrt(pixel_color.g), sqrt(pixel_color.b));
-                
-                // Write to buffer (Thread safe because each thread writes to unique indices)
-                buffer[(height - 1 - j) * width + i] = pixel_color;
-
-                // Progress Bar Logic
-                int completed = ++pixels_rendered; // Atomic increment
-                
-                // Only print every 100 pixels to save console IO time
-                if (completed % 100 == 0 || completed == total_pixels) {
-                    // Try to lock. If busy, just skip printing this frame (optimization)
-                    if (print_mutex.try_lock()) {
-                        float progress = (float)completed / total_pixels * 100.0f;
-                        std::cout << "\rProgress: " << std::fixed << std::setprecision(1) << progress << "%   ";
-                        std::cout.flush();
-                        print_mutex.unlock();
+                // Fold this pass into the AOV means (the coverage gives back the earlier hit count)
+                const float previous_hits = std::round(coverage[index] * previous_samples);
+                const float hits = previous_hits + first_hits.hits;
+                coverage[index] = hits / (previous_samples + samples);
+                if (first_hits.hits > 0) {
+                    const float keep = previous_hits / hits;
+                    const float inv_hits = 1.0f / hits;
+                    const float normal_sum[3] = {first_hits.normal.x, first_hits.normal.y, first_hits.normal.z};
+                    for (int c = 0; c < 3; ++c) {
+                        albedo[c][index] = albedo[c][index] * keep + first_hits.albedo[c] * inv_hits;
+                        normal[c][index] = normal[c][index] * keep + normal_sum[c] * inv_hits;
                     }
+                    depth[index] = depth[index] * keep + first_hits.depth * inv_hits;
                 }
+                tile_samples += samples;
+                tile_pixels++;
             }
         }
+
+        // Each slot is only written by its own thread
+        busy_seconds[pool.current_thread_index()] +=
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - tile_start).count();
+        samples_taken.fetch_add(tile_samples);
+        pixels_sampled.fetch_add(tile_pixels);
+
+        int completed = ++tiles_done;
+        // Try to lock. If busy, just skip printing this tile
+        if (print_mutex.try_lock()) {
+            float progress = (float)completed / tile_count * 100.0f;
+            std::cout << "\rPasse " << pass << ": " << std::fixed << std::setprecision(1) << progress << "%   ";
+            std::cout.flush();
+            print_mutex.unlock();
+        }
     };
 
-    // 2. Launch Threads
-    for (int t = 0; t < num_threads; ++t) {
-        int start_row = t * rows_per_thread;
-        int end_row = (t == num_threads - 1) ? height : (t + 1) * rows_per_thread;
-        
-        // Emplace_back creates and starts the thread
-        threads.emplace_back(render_chunk, start_row, end_row, t);
+    const auto render_start = std::chrono::steady_clock::now();
+    auto last_checkpoint = render_start;
+    int passes = 0;
+    for (uint32_t pass = pixels.passes(); ; ++pass) {
+        if (adaptive) {
+            update_active_pixels(m_frame, max_samples, active);
+        } else {
+            for (size_t p = 0; p < pixels.size(); ++p) {
+                active[p] = pixels[p].samples < max_samples;
+            }
+        }
+        tiles_done = 0;
+        pixels_sampled = 0;
+        Utils::TaskGroup tasks(pool);
+        for (int tile = 0; tile < tile_count; ++tile) {
+            tasks.run([&render_tile, tile, pass] { render_tile(tile, pass); });
+        }
+        tasks.wait();
+        if (pixels_sampled == 0) {
+            break;  // Every pixel converged or reached max_samples
+        }
+        if (m_radiance_cache_enabled) {
+            m_radiance_cache->commit();  // Estimates of this pass become visible to the next one
+        }
+        passes++;
+        pixels.set_passes(pass + 1);
+
+        const auto now = std::chrono::steady_clock::now();
+        if (!m_checkpoint_file.empty() &&
+            std::chrono::duration<double>(now - last_checkpoint).count() >= m_checkpoint_interval) {
+            pixels.save(m_checkpoint_file);
+            last_checkpoint = now;
+        }
+    }
+    const double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - render_start).count();
+    if (!m_checkpoint_file.empty() && pixels.save(m_checkpoint_file)) {
+        std::cout << "\nCheckpoint salvo em: " << m_checkpoint_file;
     }
 
-    // 3. Wait for all threads to finish
-    for (auto& t : threads) {
-        t.join();
+    // Resolve: the color channels already hold the means; optionally denoise them, then gamma 2
+    double denoise_seconds = 0.0;
+    if (m_denoise_enabled) {
+        const auto denoise_start = std::chrono::steady_clock::now();
+        const char* const noisy_channels[] = {"noisy.R", "noisy.G", "noisy.B"};
+        for (int c = 0; c < 3; ++c) {
+            std::copy(color[c], color[c] + pixels.size(), m_frame.channel(m_frame.add_channel(noisy_channels[c])));
+        }
+        m_denoiser.denoise(m_frame);
+        denoise_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - denoise_start).count();
     }
-    
+    for (size_t p = 0; p < pixels.size(); ++p) {
+        buffer[p] = Color(std::sqrt(color[0][p]), std::sqrt(color[1][p]), std::sqrt(color[2][p]));
+    }
+
     std::cout << "\nRender Complete!" << std::endl;
-}
 
-Vector3 PathTracer::random_unit_vector_in_hemisphere_of(const Vector3& normal, std::mt19937& thread_rng) {
-    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-    Vector3 v;
-    while (true) {
-        // 1. Gera um vetor aleatório dentro do cubo [-1, 1]
-        // random() * 2.0 - 1.0 converte o range [0, 1] para [-1, 1]
-        float x = dist(thread_rng) * 2.0f - 1.0f;
-        float y = dist(thread_rng) * 2.0f - 1.0f;
-        float z = dist(thread_rng) * 2.0f - 1.0f;
-
-        // 2. Calcula o comprimento ao quadrado
-        float lenSq = x*x + y*y + z*z;
-
-        // 3. Se estiver dentro da esfera unitária (e não for zero), aceitamos
-        if (lenSq > 0.0001f && lenSq <= 1.0f) {
-            // Normaliza para virar um vetor unitário (tamanho 1)
-            float len = std::sqrt(lenSq);
-            v = Vector3(x / len, y / len, z / len);
-            break;
+    const uint64_t total_samples = pixels.total_samples();
+    const double average_spp = (double)total_samples / pixels.size();
+    std::cout << "Amostras neste render: " << samples_taken << ", passes: " << passes << std::endl;
+    std::cout << "Amostras acumuladas: " << total_samples << " (" << std::setprecision(1) << average_spp
+              << " spp em média, " << std::setprecision(2) << max_samples / average_spp << "x menos que "
+              << max_samples << " spp uniformes)" << std::endl;
+
+    // Balance report: with good scheduling every thread is busy for about the whole render
+    double busiest = 0.0, total_busy = 0.0;
+    int busy_threads = 0;
+    std::cout << "Tiles: " << tile_count << " de " << kTileSize << "x" << kTileSize
+              << ", tempo total: " << std::setprecision(2) << wall_seconds << " s" << std::endl;
+    for (size_t t = 0; t < busy_seconds.size(); ++t) {
+        if (t == pool.size() && busy_seconds[t] == 0.0) {
+            continue;  // Calling thread found nothing to help with
         }
+        std::cout << "  " << (t < pool.size() ? "Thread " + std::to_string(t) : std::string("Thread principal"))
+                  << ": ocupada " << busy_seconds[t] << " s ("
+                  << std::setprecision(1) << 100.0 * busy_seconds[t] / wall_seconds << "%)"
+                  << std::setprecision(2) << std::endl;
+        busiest = std::max(busiest, busy_seconds[t]);
+        total_busy += busy_seconds[t];
+        busy_threads++;
     }
-
-    // 4. Garante que está no mesmo hemisfério da normal (Dot Product)    
-    // Se o produto escalar for negativo, aponta para o lado oposto, então invertemos
-    if (v.dot(normal) < 0.0f) {
-        return Vector3(-v.x, -v.y, -v.z);
+    if (busiest > 0.0) {
+        const double mean = total_busy / busy_threads;
+        std::cout << "  Balanceamento (média/máx): " << mean / busiest << std::endl;
+    }
+    if (m_radiance_cache_enabled) {
+        const size_t cells = m_radiance_cache->occupied();
+        std::cout << "Radiance cache: " << cells << " células (" << std::setprecision(1)
+                  << 100.0 * cells / m_radiance_cache->capacity() << "% da tabela)" << std::setprecision(2) << std::endl;
+    }
+    if (m_denoise_enabled) {
+        std::cout << "Denoiser (" << m_denoiser.get_iterations() << " iterações à-trous): " << std::setprecision(3)
+                  << denoise_seconds << " s (path tracing: " << wall_seconds << " s)" << std::endl;
     }
-
-    return v;
 }
 
-Vector3 PathTracer::mix(const Vector3& x, const Vector3& y, double a){
-    return x * (1.0f - a) + y * a;
+std::vector<int> PathTracer::sample_counts() const {
+    std::vector<int> counts(m_accumulation.size());
+    for (size_t p = 0; p < counts.size(); ++p) {
+        counts[p] = static_cast<int>(m_accumulation[p].samples);
+    }
+    return counts;
 }
 
-Vector3 PathTracer::refract(const Vector3& v, const Vector3& n, float eta) {
-    float cos_theta = fmin((-v).dot(n), 1.0f);
-    Vector3 r_out_perp = (v + n * cos_theta) * eta;
-    float r_out_parallel = -sqrt(fabs(1.0f - r_out_perp.length_squared()));
-    return r_out_perp + n * r_out_parallel;
+float PathTracer::mean_variance(const PixelAccumulator& pixel) {
+    if (pixel.samples < 2) {
+        return pixel.luminance_mean * pixel.luminance_mean;
+    }
+    return pixel.luminance_variance() / pixel.samples;
 }
 
-// Schlick approximation for glass reflectivity at angles
-float PathTracer::reflectance(float cosine, float ref_idx) {
-    float r0 = (1 - ref_idx) / (1 + ref_idx);
-    r0 = r0 * r0;
-    return r0 + (1 - r0) * pow((1 - cosine), 5);
+void PathTracer::update_active_pixels(const FrameBuffer& frame, uint32_t max_samples,
+                                      std::vector<uint8_t>& active) const {
+    const int width = frame.width();
+    const int height = frame.height();
+    const float* red = frame.channel(Channels::kRed);
+    const float* green = frame.channel(Channels::kGreen);
+    const float* blue = frame.channel(Channels::kBlue);
+    const float* variance = frame.channel(Channels::kVariance);
+    const float* samples = frame.channel(Channels::kSamples);
+    std::vector<float> error(frame.pixel_count());
+    Utils::parallel_for(error.size(), 4096, [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p) {
+            const float luminance = 0.2126f * red[p] + 0.7152f * green[p] + 0.0722f * blue[p];
+            error[p] = pixel_error(luminance, variance[p], samples[p]);
+        }
+    });
+
+    // A pixel keeps sampling while any pixel in its neighbourhood is above the
+    // threshold: a pixel whose base pass happened to miss a rare bright path
+    // looks converged on its own, but its neighbours usually caught one.
+    // Separable max filter: rows first, then columns.
+    const int radius = kAdaptiveWindowRadius;
+    std::vector<float> row_max(error.size());
+    Utils::parallel_for(height, 16, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y) {
+            const float* row = &error[y * width];
+            for (int x = 0; x < width; ++x) {
+                float value = 0.0f;
+                for (int k = std::max(x - radius, 0); k <= std::min(x + radius, width - 1); ++k) {
+                    value = std::max(value, row[k]);
+                }
+                row_max[y * width + x] = value;
+            }
+        }
+    });
+    Utils::parallel_for(height, 16, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y) {
+            const int y0 = std::max(static_cast<int>(y) - radius, 0);
+            const int y1 = std::min(static_cast<int>(y) + radius, height - 1);
+            for (int x = 0; x < width; ++x) {
+                float value = 0.0f;
+                for (int k = y0; k <= y1; ++k) {
+                    value = std::max(value, row_max[static_cast<size_t>(k) * width + x]);
+                }
+                const size_t p = y * width + x;
+                active[p] = samples[p] < max_samples && value > m_adaptive_threshold;
+            }
+        }
+    });
 }
 
-Color PathTracer::trace_path(const Ray& ray, int depth, const Scene& scene, std::mt19937& thread_rng) {
-    if (depth >= max_depth) {
-        return Color{};  // Bounced enough times.
-    }
-    HitRecord hit;
-    if (!scene.intersect(ray, 0.001f, 10000000000.0f, hit)) {
-        // Return sky color or black        
-        return Color{};  // Nothing was hit.
+float PathTracer::pixel_error(float luminance, float variance, float samples) {
+    if (samples < 2.0f) {
+        return std::numeric_limits<float>::infinity();
     }
 
-    auto&& material = hit.object->get_material();
-    Point3 hit_point = ray.origin + ray.direction * hit.t;
-    Vector3 normal = hit.normal;
+    // Standard error of the mean, carried through the gamma 2 of the output
+    // (d sqrt(x) = dx / (2 sqrt(x))) so dark pixels are judged as they are displayed
+    const double standard_error = std::sqrt(static_cast<double>(variance));
+    return static_cast<float>(standard_error / (2.0 * std::sqrt(std::max(static_cast<double>(luminance), 1e-3))));
+}
 
-    // 3. Emission - if we hit a light source
-    if (material.is_light) {
-        return material.brdf->color;
-    }
+Color PathTracer::trace_path(const Ray& camera_ray, const Scene& scene, Sampler& sampler,
+                             FirstHit* first_hit) {
+    PathState path;
+    path.ray = camera_ray;
+    const bool sample_lights = m_direct_lighting_enabled && !m_lights.empty();
 
-    // 4. Calculate direct lighting contribution (if enabled)
-    Color direct_light(0, 0, 0);
-    if (m_direct_lighting_enabled) {
-        direct_light = calculate_direct_lighting(hit_point, normal, material, scene, thread_rng);
-    }
+    // Radiance cache: diffuse vertices from cache_depth on end the path with it, the
+    // others (and those whose cell is not ready) feed it
+    RadianceCache* cache = m_radiance_cache_enabled ? m_radiance_cache.get() : nullptr;
+    const int cache_depth = m_radiance_cache_depth;
+    CacheVertex cache_vertices[kMaxCacheVertices];
+    int cache_vertex_count = 0;
 
-    // 5. Monte Carlo indirect lighting (existing logic)
-    Color indirect_light(0, 0, 0);
-    ScatterRecord srec;
-    if (material.brdf->scatter(ray, hit, srec, thread_rng)) {
-        indirect_light = srec.attenuation * trace_path(srec.out_ray, depth + 1, scene, thread_rng);
-    }
+    for (; path.depth < m_max_depth; ++path.depth) {
+        // Roulette, light and BRDF draws each start at a fixed dimension of the
+        // bounce, so one stage never shifts the numbers another one sees
+        sampler.start_bounce(path.depth, Sampler::kRouletteDimension);
+        const float roulette = sampler.get_1d();
 
-    // 6. Combine direct and indirect lighting
-    return direct_light + indirect_light;
-}
+        // Russian roulette: past the first bounces, a path survives with probability
+        // equal to its remaining throughput and survivors are weighted by 1/p, so the
+        // estimate stays unbiased while dim paths end early and bright ones go deep
+        if (path.depth >= kRouletteMinDepth) {
+            const double survival = std::min(1.0, std::max({path.throughput.r, path.throughput.g, path.throughput.b}));
+            if (roulette >= survival) {
+                break;
+            }
+            path.throughput = path.throughput / survival;
+        }
 
-void PathTracer::extract_light_points(const Scene& scene) {
-    m_light_points.clear();
-    
-    const auto& objects = scene.get_objects();
-    for (const auto& obj : objects) {
-        const Material& material = obj->get_material();
+        HitRecord hit;
+        if (!scene.intersect(path.ray, 0.001f, 10000000000.0f, hit)) {
+            break;  // Nothing was hit (black background).
+        }
+
+        auto&& material = hit.object->get_primitive_material(hit.primitive_index);
+
+        if (first_hit && path.depth == 0 && !material.is_light) {
+            const Color& color = material.brdf->color;
+            first_hit->albedo[0] += static_cast<float>(std::min(color.r, 1.0));
+            first_hit->albedo[1] += static_cast<float>(std::min(color.g, 1.0));
+            first_hit->albedo[2] += static_cast<float>(std::min(color.b, 1.0));
+            first_hit->normal += hit.normal;
+            first_hit->depth += hit.t * camera_ray.direction.length();
+            first_hit->hits++;
+        }
+
+        // Emission - if we hit a light source. A light reached through a lobe with a
+        // pdf could also have been found by the light sampling of the previous vertex:
+        // both strategies are weighted by the power heuristic (MIS). Camera rays and
+        // lobes without a pdf (delta or unknown) are not covered and count in full.
+        // The ray origin stands in for the previous vertex (it is offset by ~0.01).
         if (material.is_light) {
-            // For mesh lights, sample multiple points
-            // For now, use object center as single light point
-            Point3 light_pos = obj->get_position();
-            Color light_color = material.brdf->color;
-            float intensity = (light_color.r + light_color.g + light_color.b) / 3.0f;
-            
-            m_light_points.push_back({light_pos, light_color, intensity});
+            float weight = 1.0f;
+            if (sample_lights && path.depth > 0 && path.last_pdf > 0.0f) {
+                weight = power_heuristic(path.last_pdf, m_lights.pdf(path.ray.origin, path.last_normal, hit));
+            }
+            path.radiance += path.throughput * material.brdf->color * weight;
+            break;
+        }
+
+        // Direct lighting contribution (if enabled)
+        if (sample_lights) {
+            sampler.start_bounce(path.depth, Sampler::kLightDimension);
+            path.radiance += path.throughput * calculate_direct_lighting(path.ray, hit, material, scene, sampler);
+        }
+
+        // The cache only holds view-independent radiance, i.e. purely diffuse surfaces,
+        // and only what arrives through the bounce: direct light stays sampled above
+        if (cache && material.brdf->type == BRDFType::Phong && material.brdf->ks == 0.0f) {
+            Color cached;
+            if (path.depth >= cache_depth && cache->lookup(hit.point, hit.normal, cached)) {
+                path.radiance += path.throughput * cached;
+                break;
+            }
+            if (cache_vertex_count < kMaxCacheVertices) {
+                cache_vertices[cache_vertex_count++] = CacheVertex{hit.point, hit.normal, path.throughput, path.radiance};
+            }
+        }
+
+        // Monte Carlo indirect lighting: continue along the scattered ray
+        sampler.start_bounce(path.depth, Sampler::kBRDFDimension);
+        ScatterRecord srec;
+        if (!material.brdf->scatter(path.ray, hit, srec, sampler)) {
+            break;
         }
+        path.throughput = path.throughput * srec.attenuation;
+        path.ray = srec.out_ray;
+        path.last_pdf = srec.pdf;
+        path.last_normal = hit.normal;
     }
-}
 
-Color PathTracer::calculate_direct_lighting(const Point3& hit_point, const Vector3& normal, 
-                                           const Material& material, const Scene& scene, 
-                                           std::mt19937& /*thread_rng*/) {
-    Color total_light(0, 0, 0);
-    
-    // Sample all light sources
-    for (const auto& light : m_light_points) {
-        // Vector from hit point to light
-        Vector3 light_dir = (light.position - hit_point).normalized();
-        float distance = (light.position - hit_point).length();
-        
-        // Check if light is above surface (dot product with normal)
-        float n_dot_l = normal.dot(light_dir);
-        if (n_dot_l <= 0) continue;  // Light behind surface
-        
-        // Shadow test
-        if (is_in_shadow(hit_point, light.position, scene)) {
-            continue;  // In shadow, skip this light
-        }
-        
-        // Calculate light attenuation (inverse square law)
-        float attenuation = 1.0f / (1.0f + 0.001f * distance * distance);
-        
-        // Simple Lambertian diffuse lighting
-        Color diffuse_contribution = material.brdf->color * light.color * n_dot_l * attenuation * light.intensity;
-        
-        total_light += diffuse_contribution;
+    // Everything gathered after a vertex's direct lighting, divided by the throughput
+    // that reached it, estimates the indirect radiance leaving it
+    for (int v = 0; v < cache_vertex_count; ++v) {
+        const CacheVertex& vertex = cache_vertices[v];
+        if (vertex.throughput.r <= 0.0 || vertex.throughput.g <= 0.0 || vertex.throughput.b <= 0.0) {
+            continue;
+        }
+        const Color outgoing((path.radiance.r - vertex.radiance.r) / vertex.throughput.r,
+                             (path.radiance.g - vertex.radiance.g) / vertex.throughput.g,
+                             (path.radiance.b - vertex.radiance.b) / vertex.throughput.b);
+        cache->insert(vertex.point, vertex.normal, outgoing);
     }
-    
-    return total_light * 0.8f;  // Scale by diffuse coefficient (assuming kd=0.8)
+
+    return path.radiance;
 }
 
-bool PathTracer::is_in_shadow(const Point3& point, const Point3& light_pos, const Scene& scene) {
-    Vector3 light_dir = (light_pos - point).normalized();
-    float light_distance = (light_pos - point).length();
-    
-    // Create shadow ray (offset slightly to avoid self-intersection)
-    Ray shadow_ray(point + light_dir * 0.001f, light_dir);
-    
-    HitRecord shadow_hit;
-    if (scene.intersect(shadow_ray, 0.001f, light_distance - 0.001f, shadow_hit)) {
-        // Check if the hit object is the light itself
-        if (shadow_hit.object->get_material().is_light) {
-            return false;  // Hit the light, not in shadow
-        }
-        return true;  // Hit something else, in shadow
+Color PathTracer::calculate_direct_lighting(const Ray& ray, const HitRecord& hit, const Material& material,
+                                            const Scene& scene, Sampler& sampler) const {
+    LightSample light;
+    if (!m_lights.sample(hit.point, hit.normal, sampler, light)) {
+        return Color(0, 0, 0);
     }
-    
-    return false;  // Nothing between point and light
+
+    const float cos_surface = hit.normal.dot(light.direction);
+    if (cos_surface <= 0.0f) {
+        return Color(0, 0, 0);  // Light behind the surface
+    }
+    const Vector3 wo = -ray.direction.normalized();
+    const Color f = material.brdf->eval(hit, wo, light.direction);
+    if (f.r + f.g + f.b <= 0.0) {
+        return Color(0, 0, 0);
+    }
+
+    // Shadow test: any non-emissive object between the point and the light blocks it
+    const Ray shadow_ray(hit.point + light.direction * 0.001f, light.direction);
+    if (scene.occluded(shadow_ray, 0.001f, light.distance - 0.001f)) {
+        return Color(0, 0, 0);
+    }
+
+    // f * L_e * cos / p_w (the light's cosine and distance are inside the solid angle pdf),
+    // MIS-weighted against the BRDF sampling that could also have found this light
+    const float weight = power_heuristic(light.pdf, material.brdf->pdf(hit, wo, light.direction));
+    return f * light.radiance * (weight * cos_surface / light.pdf);
 }
 
 } // namespace PathRender
@@ -0,0 +1,92 @@
+#include "PathRender/rendering/PhotonMap.hpp"
+#include "PathRender/core/aabb.hpp"
+#include <algorithm>
+
+namespace PathRender {
+
+void PhotonMap::build() {
+    m_axis.assign(m_photons.size(), 0);
+    if (!m_photons.empty()) {
+        build(0, static_cast<uint32_t>(m_photons.size()));
+    }
+}
+
+void PhotonMap::build(uint32_t begin, uint32_t end) {
+    // Ranges of one photon are leaves; the loop follows the upper half instead of recursing
+    while (end - begin > 1) {
+        AABB bounds;
+        for (uint32_t i = begin; i < end; ++i) {
+            bounds.expand(m_photons[i].position);
+        }
+        const int axis = bounds.longest_axis();
+        const uint32_t middle = begin + (end - begin) / 2;
+        std::nth_element(m_photons.begin() + begin, m_photons.begin() + middle, m_photons.begin() + end,
+                         [axis](const Photon& a, const Photon& b) {
+                             return coordinate(a.position, axis) < coordinate(b.position, axis);
+                         });
+        m_axis[middle] = static_cast<uint8_t>(axis);
+        build(begin, middle);
+        begin = middle + 1;
+    }
+}
+
+float PhotonMap::kth_nearest_distance2(const Point3& point, int k, float max_distance2) const {
+    k = std::min(k, kMaxNearest);
+    if (k <= 0) {
+        return max_distance2;
+    }
+
+    // Max-heap of the k smallest distances so far; once full, its top bounds the search.
+    // Each pending range keeps the squared distance to its splitting plane, so ranges
+    // queued before the radius shrank are dropped when popped
+    struct Pending {
+        Range range;
+        float distance2;
+    };
+    float nearest[kMaxNearest];
+    int count = 0;
+    float radius2 = max_distance2;
+    Pending stack[kMaxDepth];
+    int top = 0;
+    if (!m_photons.empty()) {
+        stack[top++] = Pending{Range{0, static_cast<uint32_t>(m_photons.size())}, 0.0f};
+    }
+    while (top > 0) {
+        const Pending pending = stack[--top];
+        if (pending.distance2 >= radius2) {
+            continue;
+        }
+        const Range range = pending.range;
+        const uint32_t middle = range.begin + (range.end - range.begin) / 2;
+        const Photon& photon = m_photons[middle];
+        const float distance2 = (photon.position - point).length_squared();
+        if (distance2 < radius2) {
+            if (count < k) {
+                nearest[count++] = distance2;
+                std::push_heap(nearest, nearest + count);
+            } else {
+                std::pop_heap(nearest, nearest + count);
+                nearest[count - 1] = distance2;
+                std::push_heap(nearest, nearest + count);
+            }
+            if (count == k) {
+                radius2 = nearest[0];
+            }
+        }
+
+        const float offset = coordinate(point, m_axis[middle]) - coordinate(photon.position, m_axis[middle]);
+        const Range below{range.begin, middle};
+        const Range above{middle + 1, range.end};
+        const Range& near = offset < 0.0f ? below : above;
+        const Range& far = offset < 0.0f ? above : below;
+        if (far.begin < far.end && offset * offset < radius2) {
+            stack[top++] = Pending{far, offset * offset};
+        }
+        if (near.begin < near.end) {
+            stack[top++] = Pending{near, pending.distance2};
+        }
+    }
+    return count == k ? radius2 : max_distance2;
+}
+
+} // namespace PathRender
@@ -0,0 +1,340 @@
+#include "PathRender/rendering/PhotonMapper.hpp"
+#include "PathRender/core/DieletricBRDF.hpp"
+#include "PathRender/core/aabb.hpp"
+#include "PathRender/utils/thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+namespace PathRender {
+
+namespace {
+
+// Photons count only where their surface faces about the same way as the visible
+// point: keeps the floor's photons out of the walls next to it (Jensen's filter)
+constexpr float kMinNormalCosine = 0.5f;
+
+// Photons draw their numbers from a stream apart from the camera paths
+constexpr uint32_t kPhotonSeed = 0x70686F74u;
+
+// Probability that sample() picks a lobe with a density (the ones eval() covers)
+// rather than a delta lobe: only DielectricBRDF mixes both
+float density_lobe_probability(const BRDF& brdf) {
+    if (brdf.type == BRDFType::Dielectric) {
+        return brdf.kd / (brdf.kd + brdf.kt);
+    }
+    return 1.0f;
+}
+
+float scene_diagonal(const Scene& scene) {
+    AABB bounds;
+    for (const auto& object : scene.get_objects()) {
+        const AABB box = object->get_bounds();
+        if (box.is_finite()) {
+            bounds.expand(box);
+        }
+    }
+    return bounds.is_empty() ? 1.0f : bounds.extent().length();
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+void PhotonMapper::render(std::vector<Color>& buffer, const SceneConfig& config) {
+    std::cout << "PHOTON MAPPER (SPPM) RENDER" << std::endl;
+
+    const Scene& scene = config.scene;
+    // Lights emit the photons even without direct lighting at the visible points
+    m_lights = LightSampler(m_light_selection);
+    m_lights.build(scene);
+    std::cout << "Found " << m_lights.size() << " emissive primitives (direct lighting: "
+              << (m_direct_lighting_enabled ? light_selection_name(m_light_selection) : "disabled") << ")" << std::endl;
+    if (m_lights.empty()) {
+        std::cerr << "Aviso: nenhuma luz com área finita, nenhum fóton será emitido" << std::endl;
+    }
+
+    const int width = config.output_params.width;
+    const int height = config.output_params.height;
+    const size_t pixel_count = static_cast<size_t>(width) * height;
+    const int passes = std::max(m_passes, 1);
+    const uint32_t photons_per_pass = m_lights.empty() ? 0 : static_cast<uint32_t>(std::max(m_photons_per_pass, 0));
+    const float max_radius = m_max_radius > 0.0f ? m_max_radius : scene_diagonal(scene) / 50.0f;
+    const float max_radius2 = max_radius * max_radius;
+    std::cout << "SPPM: " << passes << " passes, " << photons_per_pass << " fótons por passe, raio inicial pelos "
+              << m_nearest_photons << " fótons mais próximos (até " << max_radius << ")" << std::endl;
+
+    // Everything kept between passes: one visible point and its statistics per pixel
+    // (image order, row 0 at the top) and the photon buffers, reused by every pass
+    std::vector<VisiblePoint> visible(pixel_count);
+    std::vector<PixelState> states(pixel_count);
+    const uint32_t batch_count = (photons_per_pass + kPhotonBatchSize - 1) / kPhotonBatchSize;
+    std::vector<PhotonBatch> batches(batch_count);
+
+    double camera_seconds = 0.0, photon_seconds = 0.0, build_seconds = 0.0, gather_seconds = 0.0;
+    size_t caustic_photons = 0, global_photons = 0;
+    const auto render_start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        // 1. Camera paths down to the visible points (and their direct lighting)
+        auto start = std::chrono::steady_clock::now();
+        Utils::parallel_for(height, 4, [&](size_t begin, size_t end) {
+            std::unique_ptr<Sampler> sampler = make_sampler(m_sampler_type, m_seed, passes);
+            for (size_t j = begin; j < end; ++j) {
+                for (int i = 0; i < width; ++i) {
+                    const size_t index = (height - 1 - j) * width + i;
+                    states[index].direct += trace_camera(config, i, static_cast<int>(j), static_cast<uint32_t>(pass),
+                                                         *sampler, visible[index]);
+                }
+            }
+        });
+        camera_seconds += seconds_since(start);
+
+        // 2. Photons, one batch per task; every photon's numbers depend only on its index
+        start = std::chrono::steady_clock::now();
+        Utils::parallel_for(batch_count, 1, [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; ++b) {
+                const uint32_t first = static_cast<uint32_t>(b) * kPhotonBatchSize;
+                trace_photons(scene, static_cast<uint32_t>(pass), first,
+                              std::min(first + kPhotonBatchSize, photons_per_pass), batches[b]);
+            }
+        });
+        photon_seconds += seconds_since(start);
+
+        // 3. Both maps rebuilt from the batches, in batch order (same tree on any thread count)
+        start = std::chrono::steady_clock::now();
+        m_caustic_map.clear();
+        m_global_map.clear();
+        for (const PhotonBatch& batch : batches) {
+            m_caustic_map.add(batch.caustic);
+            m_global_map.add(batch.global);
+        }
+        {
+            Utils::TaskGroup tasks;
+            tasks.run([this] { m_caustic_map.build(); });
+            tasks.run([this] { m_global_map.build(); });
+            tasks.wait();
+        }
+        caustic_photons += m_caustic_map.size();
+        global_photons += m_global_map.size();
+        build_seconds += seconds_since(start);
+
+        // 4. Each visible point gathers the photons inside its radii
+        start = std::chrono::steady_clock::now();
+        Utils::parallel_for(pixel_count, 256, [&](size_t begin, size_t end) {
+            for (size_t p = begin; p < end; ++p) {
+                gather(m_caustic_map, visible[p], max_radius2, states[p].caustic);
+                gather(m_global_map, visible[p], max_radius2, states[p].global);
+            }
+        });
+        gather_seconds += seconds_since(start);
+
+        std::cout << "\rPasse " << pass + 1 << "/" << passes << "   ";
+        std::cout.flush();
+    }
+
+    // L = direct / passes + tau / (pi r^2 emitted photons), per map; gamma 2
+    const double emitted = static_cast<double>(photons_per_pass) * passes;
+    Utils::parallel_for(pixel_count, 1024, [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p) {
+            const PixelState& state = states[p];
+            Color radiance = state.direct / passes;
+            for (const GatherState* gathered : {&state.caustic, &state.global}) {
+                if (gathered->radius2 > 0.0f && emitted > 0.0) {
+                    radiance += gathered->flux / (M_PI * gathered->radius2 * emitted);
+                }
+            }
+            buffer[p] = Color(std::sqrt(radiance.r), std::sqrt(radiance.g), std::sqrt(radiance.b));
+        }
+    });
+
+    const double seconds = seconds_since(render_start);
+    std::cout << "\nRender Complete! " << std::fixed << std::setprecision(2) << seconds << " s" << std::endl;
+    std::cout << "  Fótons por passe: " << caustic_photons / passes << " cáusticos, " << global_photons / passes
+              << " globais" << std::endl;
+    std::cout << "  Câmera: " << camera_seconds << " s, fótons: " << photon_seconds << " s, kd-trees: "
+              << build_seconds << " s, coleta: " << gather_seconds << " s" << std::endl;
+}
+
+Color PhotonMapper::trace_camera(const SceneConfig& config, int i, int j, uint32_t pass, Sampler& sampler,
+                                 VisiblePoint& visible) const {
+    const int width = config.output_params.width;
+    const int height = config.output_params.height;
+    const Scene& scene = config.scene;
+
+    sampler.start_pixel_sample(static_cast<uint32_t>(j * width + i), pass);
+    const float u = (float(i) + sampler.get_1d()) / (width - 1);
+    const float v = (float(j) + sampler.get_1d()) / (height - 1);
+    Ray ray = config.camera.get_ray(u, v);
+
+    visible.brdf = nullptr;
+    Color throughput(1.0, 1.0, 1.0);
+    Color radiance(0.0, 0.0, 0.0);
+    for (int depth = 0; depth < m_max_depth; ++depth) {
+        HitRecord hit;
+        if (!scene.intersect(ray, 0.001f, 10000000000.0f, hit)) {
+            break;
+        }
+        const Material& material = hit.object->get_primitive_material(hit.primitive_index);
+        if (material.is_light) {
+            // Seen directly or through delta lobes only: no other strategy finds this light
+            radiance += throughput * material.brdf->color;
+            break;
+        }
+
+        // A BRDF mixing delta and density lobes picks one: the path follows a delta lobe
+        // and stops at the others, weighted by 1 / their probability
+        const BRDF& brdf = *material.brdf;
+        const Vector3 wo = -ray.direction.normalized();
+        const float density_probability = density_lobe_probability(brdf);
+        ScatterRecord srec;
+        if (density_probability < 1.0f) {
+            sampler.start_bounce(depth, Sampler::kBRDFDimension);
+            if (!brdf.sample(hit, wo, sampler, srec)) {
+                break;
+            }
+        }
+        if (density_probability >= 1.0f || srec.pdf > 0.0f) {
+            visible.hit = hit;
+            visible.wo = wo;
+            visible.brdf = &brdf;
+            visible.throughput = throughput / density_probability;
+            if (m_direct_lighting_enabled) {
+                sampler.start_bounce(depth, Sampler::kLightDimension);
+                radiance += visible.throughput * direct_lighting(scene, hit, wo, brdf, sampler);
+            }
+            break;
+        }
+        throughput = throughput * srec.attenuation;
+        ray = srec.out_ray;
+    }
+    return radiance;
+}
+
+void PhotonMapper::trace_photons(const Scene& scene, uint32_t pass, uint32_t begin, uint32_t end,
+                                 PhotonBatch& batch) const {
+    batch.caustic.clear();
+    batch.global.clear();
+    IndependentSampler sampler(m_seed ^ kPhotonSeed);
+
+    for (uint32_t index = begin; index < end; ++index) {
+        sampler.start_pixel_sample(index, pass);
+        EmissionSample emission;
+        if (!m_lights.sample_emission(sampler, emission)) {
+            return;
+        }
+
+        Ray ray = emission.ray;
+        Color throughput(1.0, 1.0, 1.0);
+        bool delta_only = true;  // Every bounce so far went through a delta lobe
+        for (int depth = 0; depth < m_max_depth; ++depth) {
+            // Bounce b uses the dimensions of bounce b + 1: the first ones hold the emission
+            sampler.start_bounce(depth + 1, Sampler::kRouletteDimension);
+            const float roulette = sampler.get_1d();
+            if (depth >= kRouletteMinDepth) {
+                const double survival = std::min(1.0, std::max({throughput.r, throughput.g, throughput.b}));
+                if (roulette >= survival) {
+                    break;
+                }
+                throughput = throughput / survival;
+            }
+
+            HitRecord hit;
+            if (!scene.intersect(ray, 0.001f, 10000000000.0f, hit)) {
+                break;
+            }
+            const Material& material = hit.object->get_primitive_material(hit.primitive_index);
+            if (material.is_light) {
+                break;
+            }
+
+            // Photons land where eval() has something to weigh them with; the first hit
+            // is direct light, already sampled at the visible points when enabled
+            const BRDF& brdf = *material.brdf;
+            const Vector3 wi = -ray.direction.normalized();
+            if (density_lobe_probability(brdf) > 0.0f && (depth > 0 || !m_direct_lighting_enabled)) {
+                const Color flux = emission.flux * throughput;
+                const Photon photon{hit.point, wi, hit.normal,
+                                    {static_cast<float>(flux.r), static_cast<float>(flux.g), static_cast<float>(flux.b)}};
+                (depth > 0 && delta_only ? batch.caustic : batch.global).push_back(photon);
+            }
+
+            sampler.start_bounce(depth + 1, Sampler::kBRDFDimension);
+            ScatterRecord srec;
+            if (!brdf.sample(hit, wi, sampler, srec)) {
+                break;
+            }
+            throughput = throughput * srec.attenuation;
+            if (brdf.type == BRDFType::Dielectric) {
+                // Photons carry flux: scale refractions as DielectricBRDF::flux_scale documents
+                throughput = throughput * static_cast<const DielectricBRDF&>(brdf).flux_scale(hit, srec);
+            }
+            delta_only = delta_only && srec.pdf == 0.0f;
+            ray = srec.out_ray;
+        }
+    }
+}
+
+Color PhotonMapper::direct_lighting(const Scene& scene, const HitRecord& hit, const Vector3& wo, const BRDF& brdf,
+                                    Sampler& sampler) const {
+    LightSample light;
+    if (!m_lights.sample(hit.point, hit.normal, sampler, light)) {
+        return Color(0, 0, 0);
+    }
+    const float cos_surface = hit.normal.dot(light.direction);
+    if (cos_surface <= 0.0f) {
+        return Color(0, 0, 0);
+    }
+    const Color f = brdf.eval(hit, wo, light.direction);
+    if (f.r + f.g + f.b <= 0.0) {
+        return Color(0, 0, 0);
+    }
+    const Ray shadow_ray(hit.point + light.direction * 0.001f, light.direction);
+    if (scene.occluded(shadow_ray, 0.001f, light.distance - 0.001f)) {
+        return Color(0, 0, 0);
+    }
+
+    // The visible point never continues by BRDF sampling, so the light sample counts in full
+    return f * light.radiance * (cos_surface / light.pdf);
+}
+
+void PhotonMapper::gather(const PhotonMap& map, const VisiblePoint& visible, float max_radius2,
+                          GatherState& state) const {
+    if (!visible.brdf || map.empty()) {
+        return;
+    }
+    const HitRecord& hit = visible.hit;
+    if (state.radius2 == 0.0f) {
+        state.radius2 = map.kth_nearest_distance2(hit.point, m_nearest_photons, max_radius2);
+    }
+
+    double flux[3] = {0.0, 0.0, 0.0};
+    int found = 0;
+    map.for_each_in_radius(hit.point, state.radius2, [&](const Photon& photon) {
+        if (photon.normal.dot(hit.normal) < kMinNormalCosine) {
+            return;
+        }
+        const Color f = visible.brdf->eval(hit, visible.wo, photon.direction);
+        flux[0] += f.r * photon.flux[0];
+        flux[1] += f.g * photon.flux[1];
+        flux[2] += f.b * photon.flux[2];
+        found++;
+    });
+    if (found == 0) {
+        return;
+    }
+
+    // Progressive update: keep alpha of the new photons and shrink the radius to match,
+    // scaling the accumulated flux by the same area ratio
+    const float photons = state.photons + m_alpha * found;
+    const float shrink = photons / (state.photons + found);
+    state.flux = (state.flux + visible.throughput * Color(flux[0], flux[1], flux[2])) * shrink;
+    state.radius2 *= shrink;
+    state.photons = photons;
+}
+
+} // namespace PathRender
@@ -0,0 +1,148 @@
+#include "PathRender/rendering/RadianceCache.hpp"
+#include "PathRender/core/aabb.hpp"
+#include "PathRender/core/sampler.hpp"
+#include "PathRender/utils/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace PathRender {
+
+namespace {
+
+// Grid coordinates are stored in 19 bits each (offset to be non-negative)
+constexpr int64_t kCoordinateBias = 1 << 18;
+constexpr uint64_t kCoordinateMask = (1u << 19) - 1;
+
+} // namespace
+
+RadianceCache::RadianceCache(int capacity_log2)
+    : m_capacity(size_t{1} << capacity_log2), m_cells(new Cell[m_capacity]) {}
+
+void RadianceCache::reset(float cell_size) {
+    m_cell_size = cell_size;
+    m_inv_cell_size = 1.0f / cell_size;
+    Utils::parallel_for(m_capacity, 4096, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Cell& cell = m_cells[i];
+            cell.key.store(0, std::memory_order_relaxed);
+            for (int c = 0; c < 3; ++c) {
+                cell.sum[c].store(0, std::memory_order_relaxed);
+                cell.mean[c] = 0.0f;
+            }
+            cell.samples.store(0, std::memory_order_relaxed);
+            cell.committed_samples = 0;
+        }
+    });
+}
+
+float RadianceCache::default_cell_size(const Scene& scene) {
+    AABB bounds;
+    for (const auto& object : scene.get_objects()) {
+        const AABB box = object->get_bounds();
+        if (box.is_finite()) {
+            bounds.expand(box);
+        }
+    }
+    if (bounds.is_empty()) {
+        return 1.0f;
+    }
+    return std::max(bounds.extent().length() / 32.0f, 1e-4f);
+}
+
+uint64_t RadianceCache::cell_key(const Point3& point, const Vector3& normal) const {
+    const auto coordinate = [&](float value) {
+        const int64_t cell = static_cast<int64_t>(std::floor(value * m_inv_cell_size)) + kCoordinateBias;
+        return static_cast<uint64_t>(cell) & kCoordinateMask;
+    };
+
+    // Dominant axis of the normal and its sign: 6 directions
+    const float ax = std::fabs(normal.x), ay = std::fabs(normal.y), az = std::fabs(normal.z);
+    uint64_t direction;
+    if (ax >= ay && ax >= az) {
+        direction = normal.x >= 0.0f ? 0 : 1;
+    } else if (ay >= az) {
+        direction = normal.y >= 0.0f ? 2 : 3;
+    } else {
+        direction = normal.z >= 0.0f ? 4 : 5;
+    }
+
+    // Bit 63 keeps every key non-zero (0 marks a free cell)
+    return (uint64_t{1} << 63) | (direction << 57) | (coordinate(point.x) << 38) | (coordinate(point.y) << 19) |
+           coordinate(point.z);
+}
+
+void RadianceCache::insert(const Point3& point, const Vector3& normal, const Color& radiance) {
+    const uint64_t key = cell_key(point, normal);
+    size_t slot = Sampler::mix64(key) & (m_capacity - 1);
+    for (int probe = 0; probe < kMaxProbes; ++probe, slot = (slot + 1) & (m_capacity - 1)) {
+        Cell& cell = m_cells[slot];
+        uint64_t current = cell.key.load(std::memory_order_acquire);
+        if (current == 0) {
+            // Claim the free cell; if another thread won it, check whether it took the same key
+            if (!cell.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                if (current != key) {
+                    continue;
+                }
+            }
+        } else if (current != key) {
+            continue;
+        }
+
+        const double values[3] = {radiance.r, radiance.g, radiance.b};
+        for (int c = 0; c < 3; ++c) {
+            const double clamped = std::min(std::max(values[c], 0.0), kMaxRadiance);
+            cell.sum[c].fetch_add(static_cast<uint64_t>(clamped * kFixedPointScale + 0.5), std::memory_order_relaxed);
+        }
+        cell.samples.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // Table full around this slot: the estimate is dropped
+}
+
+bool RadianceCache::lookup(const Point3& point, const Vector3& normal, Color& radiance) const {
+    const uint64_t key = cell_key(point, normal);
+    size_t slot = Sampler::mix64(key) & (m_capacity - 1);
+    for (int probe = 0; probe < kMaxProbes; ++probe, slot = (slot + 1) & (m_capacity - 1)) {
+        const Cell& cell = m_cells[slot];
+        const uint64_t current = cell.key.load(std::memory_order_acquire);
+        if (current == 0) {
+            return false;
+        }
+        if (current != key) {
+            continue;
+        }
+        if (cell.committed_samples < kMinSamples) {
+            return false;
+        }
+        radiance = Color(cell.mean[0], cell.mean[1], cell.mean[2]);
+        return true;
+    }
+    return false;
+}
+
+void RadianceCache::commit() {
+    Utils::parallel_for(m_capacity, 4096, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Cell& cell = m_cells[i];
+            const uint32_t samples = cell.samples.load(std::memory_order_relaxed);
+            if (samples == 0) {
+                continue;
+            }
+            const double scale = 1.0 / (kFixedPointScale * samples);
+            for (int c = 0; c < 3; ++c) {
+                cell.mean[c] = static_cast<float>(cell.sum[c].load(std::memory_order_relaxed) * scale);
+            }
+            cell.committed_samples = samples;
+        }
+    });
+}
+
+size_t RadianceCache::occupied() const {
+    size_t count = 0;
+    for (size_t i = 0; i < m_capacity; ++i) {
+        count += m_cells[i].key.load(std::memory_order_relaxed) != 0;
+    }
+    return count;
+}
+
+} // namespace PathRender
@@ -0,0 +1,344 @@
+#include "PathRender/rendering/WavefrontPathTracer.hpp"
+#include "PathRender/core/AnisotropicMatteBRDF.hpp"
+#include "PathRender/core/DieletricBRDF.hpp"
+#include "PathRender/core/PhongBRDF.hpp"
+#include "PathRender/utils/thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+
+namespace PathRender {
+
+namespace {
+
+constexpr size_t kBRDFTypeCount = static_cast<size_t>(BRDFType::Other) + 1;
+
+} // namespace
+
+void WavefrontPathTracer::PathQueue::resize(size_t count) {
+    for (auto* array : {&origin_x, &origin_y, &origin_z, &direction_x, &direction_y, &direction_z,
+                        &throughput_r, &throughput_g, &throughput_b}) {
+        array->resize(count);
+    }
+    pixel.resize(count);
+    sample.resize(count);
+    last_pdf.resize(count);
+    last_normal_x.resize(count);
+    last_normal_y.resize(count);
+    last_normal_z.resize(count);
+}
+
+Ray WavefrontPathTracer::PathQueue::ray(size_t i) const {
+    return Ray(Point3(origin_x[i], origin_y[i], origin_z[i]), Vector3(direction_x[i], direction_y[i], direction_z[i]));
+}
+
+void WavefrontPathTracer::PathQueue::set_ray(size_t i, const Ray& ray) {
+    origin_x[i] = ray.origin.x;
+    origin_y[i] = ray.origin.y;
+    origin_z[i] = ray.origin.z;
+    direction_x[i] = ray.direction.x;
+    direction_y[i] = ray.direction.y;
+    direction_z[i] = ray.direction.z;
+}
+
+void WavefrontPathTracer::PathQueue::move(size_t from, size_t to) {
+    for (auto* array : {&origin_x, &origin_y, &origin_z, &direction_x, &direction_y, &direction_z,
+                        &throughput_r, &throughput_g, &throughput_b}) {
+        (*array)[to] = (*array)[from];
+    }
+    pixel[to] = pixel[from];
+    sample[to] = sample[from];
+    last_pdf[to] = last_pdf[from];
+    last_normal_x[to] = last_normal_x[from];
+    last_normal_y[to] = last_normal_y[from];
+    last_normal_z[to] = last_normal_z[from];
+}
+
+void WavefrontPathTracer::ShadowQueue::clear() {
+    for (auto* array : {&origin_x, &origin_y, &origin_z, &direction_x, &direction_y, &direction_z, &t_max,
+                        &contribution_r, &contribution_g, &contribution_b}) {
+        array->clear();
+    }
+    pixel.clear();
+}
+
+void WavefrontPathTracer::ShadowQueue::push(const Point3& origin, const Vector3& direction, float max_t,
+                                            const Color& contribution, uint32_t target_pixel) {
+    origin_x.push_back(origin.x);
+    origin_y.push_back(origin.y);
+    origin_z.push_back(origin.z);
+    direction_x.push_back(direction.x);
+    direction_y.push_back(direction.y);
+    direction_z.push_back(direction.z);
+    t_max.push_back(max_t);
+    contribution_r.push_back(static_cast<float>(contribution.r));
+    contribution_g.push_back(static_cast<float>(contribution.g));
+    contribution_b.push_back(static_cast<float>(contribution.b));
+    pixel.push_back(target_pixel);
+}
+
+void WavefrontPathTracer::render(std::vector<Color>& buffer, const SceneConfig& config) {
+    std::cout << "WAVEFRONT PATH TRACER RENDER" << std::endl;
+
+    m_lights = LightSampler(m_light_selection);
+    if (m_direct_lighting_enabled) {
+        m_lights.build(config.scene);
+        std::cout << "Found " << m_lights.size() << " emissive primitives for direct lighting (selection: "
+                  << light_selection_name(m_light_selection) << ")" << std::endl;
+    }
+
+    const int width = config.output_params.width;
+    const int height = config.output_params.height;
+    const int tiles_x = (width + kTileSize - 1) / kTileSize;
+    const int tiles_y = (height + kTileSize - 1) / kTileSize;
+    const int tile_count = tiles_x * tiles_y;
+
+    std::atomic<int> tiles_done{0};
+    std::mutex print_mutex;
+
+    auto render_one = [&](int tile) {
+        const int x0 = (tile % tiles_x) * kTileSize;
+        const int y0 = (tile / tiles_x) * kTileSize;
+        const int x1 = std::min(x0 + kTileSize, width);
+        const int y1 = std::min(y0 + kTileSize, height);
+
+        std::vector<Color> radiance(static_cast<size_t>(x1 - x0) * (y1 - y0));
+        render_tile(config, x0, y0, x1, y1, radiance);
+
+        // Resolve: average and gamma 2
+        for (int j = y0; j < y1; ++j) {
+            for (int i = x0; i < x1; ++i) {
+                Color pixel_color = radiance[static_cast<size_t>(j - y0) * (x1 - x0) + (i - x0)] /
+                                    (double)m_samples_per_pixel;
+                buffer[static_cast<size_t>(height - 1 - j) * width + i] =
+                    Color(std::sqrt(pixel_color.r), std::sqrt(pixel_color.g), std::sqrt(pixel_color.b));
+            }
+        }
+
+        int completed = ++tiles_done;
+        if (print_mutex.try_lock()) {
+            std::cout << "\rProgress: " << std::fixed << std::setprecision(1) << 100.0f * completed / tile_count << "%   ";
+            std::cout.flush();
+            print_mutex.unlock();
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        Utils::TaskGroup tasks;
+        for (int tile = 0; tile < tile_count; ++tile) {
+            tasks.run([&render_one, tile] { render_one(tile); });
+        }
+        tasks.wait();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const double samples = static_cast<double>(width) * height * m_samples_per_pixel;
+    std::cout << "\nRender Complete! " << std::setprecision(2) << seconds << " s, "
+              << samples / seconds / 1e6 << " M amostras/s" << std::endl;
+}
+
+void WavefrontPathTracer::render_tile(const SceneConfig& config, int x0, int y0, int x1, int y1,
+                                      std::vector<Color>& radiance) const {
+    const Scene& scene = config.scene;
+    const Camera& camera = config.camera;
+    const int width = config.output_params.width;
+    const int height = config.output_params.height;
+    const int tile_width = x1 - x0;
+    const size_t tile_pixels = radiance.size();
+
+    PathQueue paths;
+    ShadowQueue shadows;
+    std::vector<HitRecord> hits;
+    std::vector<const Material*> materials;
+    std::vector<uint8_t> alive;
+    std::vector<uint32_t> groups[kBRDFTypeCount];
+
+    // Samplers are stateless (values depend only on pixel, sample and dimension): it is
+    // repositioned for each path at each stage, using the dimensions PathTracer uses
+    std::unique_ptr<Sampler> tile_sampler = make_sampler(m_sampler_type, m_seed, m_samples_per_pixel);
+    Sampler& sampler = *tile_sampler;
+    auto start_path = [&](size_t i, int bounce, uint32_t offset) {
+        const uint32_t local = paths.pixel[i];
+        const uint32_t image_pixel = static_cast<uint32_t>((y0 + local / tile_width) * width + x0 + local % tile_width);
+        sampler.start_pixel_sample(image_pixel, paths.sample[i]);
+        sampler.start_bounce(bounce, offset);
+    };
+    const bool sample_lights = m_direct_lighting_enabled && !m_lights.empty();
+
+    // Scatters every path of one BRDF group; sample calls the concrete BRDF::sample directly
+    auto scatter_group = [&](const std::vector<uint32_t>& group, int depth, auto&& sample) {
+        for (uint32_t i : group) {
+            start_path(i, depth, Sampler::kBRDFDimension);
+            ScatterRecord srec;
+            const Vector3 wo = -Vector3(paths.direction_x[i], paths.direction_y[i], paths.direction_z[i]).normalized();
+            if (!sample(*materials[i]->brdf, wo, hits[i], srec)) {
+                continue;  // Absorbed
+            }
+            paths.throughput_r[i] *= static_cast<float>(srec.attenuation.r);
+            paths.throughput_g[i] *= static_cast<float>(srec.attenuation.g);
+            paths.throughput_b[i] *= static_cast<float>(srec.attenuation.b);
+            paths.set_ray(i, srec.out_ray);
+            paths.last_pdf[i] = srec.pdf;
+            paths.last_normal_x[i] = hits[i].normal.x;
+            paths.last_normal_y[i] = hits[i].normal.y;
+            paths.last_normal_z[i] = hits[i].normal.z;
+            alive[i] = 1;
+        }
+    };
+
+    for (int first_sample = 0; first_sample < m_samples_per_pixel; first_sample += kWaveSamples) {
+        const int wave_samples = std::min(kWaveSamples, m_samples_per_pixel - first_sample);
+
+        // 1. Camera rays for the whole wave
+        paths.resize(tile_pixels * wave_samples);
+        size_t count = 0;
+        for (int j = y0; j < y1; ++j) {
+            for (int i = x0; i < x1; ++i) {
+                const uint32_t pixel = static_cast<uint32_t>((j - y0) * tile_width + (i - x0));
+                for (int k = 0; k < wave_samples; ++k) {
+                    sampler.start_pixel_sample(static_cast<uint32_t>(j * width + i),
+                                               static_cast<uint32_t>(first_sample + k));
+                    float u = (float(i) + sampler.get_1d()) / (width - 1);
+                    float v = (float(j) + sampler.get_1d()) / (height - 1);
+                    paths.set_ray(count, camera.get_ray(u, v));
+                    paths.throughput_r[count] = paths.throughput_g[count] = paths.throughput_b[count] = 1.0f;
+                    paths.pixel[count] = pixel;
+                    paths.last_pdf[count] = 0.0f;
+                    paths.sample[count] = static_cast<uint32_t>(first_sample + k);
+                    count++;
+                }
+            }
+        }
+
+        for (int depth = 0; paths.size() > 0 && depth < m_max_depth; ++depth) {
+            count = paths.size();
+            hits.resize(count);
+            materials.assign(count, nullptr);
+            alive.assign(count, 0);
+
+            // 2. Closest hits
+            for (size_t i = 0; i < count; ++i) {
+                if (scene.intersect(paths.ray(i), 0.001f, 10000000000.0f, hits[i])) {
+                    materials[i] = &hits[i].object->get_primitive_material(hits[i].primitive_index);
+                }
+            }
+
+            // 3. Misses end here, emitters add their light and end, the rest is grouped by BRDF type
+            for (auto& group : groups) {
+                group.clear();
+            }
+            for (size_t i = 0; i < count; ++i) {
+                const Material* material = materials[i];
+                if (material == nullptr) {
+                    continue;
+                }
+                if (material->is_light) {
+                    // MIS against the light sampling of the previous vertex (same rule as PathTracer)
+                    float weight = 1.0f;
+                    if (sample_lights && depth > 0 && paths.last_pdf[i] > 0.0f) {
+                        const Point3 origin(paths.origin_x[i], paths.origin_y[i], paths.origin_z[i]);
+                        const Vector3 normal(paths.last_normal_x[i], paths.last_normal_y[i], paths.last_normal_z[i]);
+                        weight = power_heuristic(paths.last_pdf[i], m_lights.pdf(origin, normal, hits[i]));
+                    }
+                    radiance[paths.pixel[i]] += Color(paths.throughput_r[i], paths.throughput_g[i], paths.throughput_b[i]) *
+                                                material->brdf->color * weight;
+                    continue;
+                }
+                groups[static_cast<size_t>(material->brdf->type)].push_back(static_cast<uint32_t>(i));
+            }
+
+            // 4. Direct lighting: one light sample and shadow ray per shading point, traced in bulk
+            if (sample_lights) {
+                shadows.clear();
+                for (const auto& group : groups) {
+                    for (uint32_t i : group) {
+                        start_path(i, depth, Sampler::kLightDimension);
+                        const HitRecord& hit = hits[i];
+                        LightSample light;
+                        if (!m_lights.sample(hit.point, hit.normal, sampler, light)) {
+                            continue;
+                        }
+                        const float cos_surface = hit.normal.dot(light.direction);
+                        if (cos_surface <= 0.0f) {
+                            continue;  // Light behind surface
+                        }
+                        const Vector3 wo = -Vector3(paths.direction_x[i], paths.direction_y[i], paths.direction_z[i]).normalized();
+                        const Color f = materials[i]->brdf->eval(hit, wo, light.direction);
+                        if (f.r + f.g + f.b <= 0.0) {
+                            continue;
+                        }
+                        const Color throughput(paths.throughput_r[i], paths.throughput_g[i], paths.throughput_b[i]);
+                        const float weight = power_heuristic(light.pdf, materials[i]->brdf->pdf(hit, wo, light.direction));
+                        shadows.push(hit.point + light.direction * 0.001f, light.direction, light.distance - 0.001f,
+                                     throughput * f * light.radiance * (weight * cos_surface / light.pdf), paths.pixel[i]);
+                    }
+                }
+                for (size_t s = 0; s < shadows.size(); ++s) {
+                    Ray shadow_ray(Point3(shadows.origin_x[s], shadows.origin_y[s], shadows.origin_z[s]),
+                                   Vector3(shadows.direction_x[s], shadows.direction_y[s], shadows.direction_z[s]));
+                    if (!scene.occluded(shadow_ray, 0.001f, shadows.t_max[s])) {
+                        radiance[shadows.pixel[s]] += Color(shadows.contribution_r[s], shadows.contribution_g[s],
+                                                            shadows.contribution_b[s]);
+                    }
+                }
+            }
+
+            // 5. Scatter, one BRDF type at a time
+            scatter_group(groups[static_cast<size_t>(BRDFType::Phong)], depth,
+                [&](const BRDF& brdf, const Vector3& wo, const HitRecord& hit, ScatterRecord& srec) {
+                    return static_cast<const PhongBRDF&>(brdf).PhongBRDF::sample(hit, wo, sampler, srec);
+                });
+            scatter_group(groups[static_cast<size_t>(BRDFType::Dielectric)], depth,
+                [&](const BRDF& brdf, const Vector3& wo, const HitRecord& hit, ScatterRecord& srec) {
+                    return static_cast<const DielectricBRDF&>(brdf).DielectricBRDF::sample(hit, wo, sampler, srec);
+                });
+            scatter_group(groups[static_cast<size_t>(BRDFType::AnisotropicMatte)], depth,
+                [&](const BRDF& brdf, const Vector3& wo, const HitRecord& hit, ScatterRecord& srec) {
+                    return static_cast<const AnisotropicMatteBRDF&>(brdf).AnisotropicMatteBRDF::sample(hit, wo, sampler, srec);
+                });
+            scatter_group(groups[static_cast<size_t>(BRDFType::Other)], depth,
+                [&](const BRDF& brdf, const Vector3& wo, const HitRecord& hit, ScatterRecord& srec) {
+                    return brdf.sample(hit, wo, sampler, srec);
+                });
+
+            // 6. Russian roulette for the next bounce (same rule as PathTracer)
+            if (depth + 1 >= kRouletteMinDepth) {
+                for (size_t i = 0; i < count; ++i) {
+                    if (!alive[i]) {
+                        continue;
+                    }
+                    const float survival = std::min(1.0f, std::max({paths.throughput_r[i], paths.throughput_g[i],
+                                                                     paths.throughput_b[i]}));
+                    start_path(i, depth + 1, Sampler::kRouletteDimension);
+                    if (sampler.get_1d() >= survival) {
+                        alive[i] = 0;
+                        continue;
+                    }
+                    paths.throughput_r[i] /= survival;
+                    paths.throughput_g[i] /= survival;
+                    paths.throughput_b[i] /= survival;
+                }
+            }
+
+            // 7. Compact the surviving paths to the front
+            size_t kept = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (alive[i]) {
+                    if (kept != i) {
+                        paths.move(i, kept);
+                    }
+                    kept++;
+                }
+            }
+            paths.resize(kept);
+        }
+    }
+}
+
+} // namespace PathRender
@@ -32,6 +32,38 @@ Ray Camera::get_ray(float u, float v) const {
     return Ray(m_origin, dir.normalized());
 }
 
+bool Camera::project(const Point3& point, float& u, float& v) const {
+    const Vector3 offset = point - m_origin;
+    const float depth = -offset.dot(m_w);
+    if (depth <= 0.0f) {
+        return false;
+    }
+    // Where the ray crosses the view plane, relative to its lower left corner
+    const Vector3 on_plane = offset / depth - (m_lower_left - m_origin);
+    u = on_plane.dot(m_horizontal) / m_horizontal.length_squared();
+    v = on_plane.dot(m_vertical) / m_vertical.length_squared();
+    return true;
+}
+
+float Camera::importance(const Vector3& direction) const {
+    const float cos_theta = -direction.dot(m_w);
+    if (cos_theta <= 0.0f) {
+        return 0.0f;
+    }
+    const float cos2 = cos_theta * cos_theta;
+    return 1.0f / (m_horizontal.length() * m_vertical.length() * cos2 * cos2);
+}
+
+float Camera::pdf(const Vector3& direction) const {
+    // (u, v) spreads the rays over the area A of the view plane, and a patch dA of it (at
+    // distance 1 / cos along the ray, tilted by the same angle) subtends dA cos^3
+    const float cos_theta = -direction.dot(m_w);
+    if (cos_theta <= 0.0f) {
+        return 0.0f;
+    }
+    return 1.0f / (m_horizontal.length() * m_vertical.length() * cos_theta * cos_theta * cos_theta);
+}
+
 std::string Camera::to_string() const {
     return "Camera(origin=" + std::to_string(m_origin.x) + ", " + std::to_string(m_origin.y) + ", " + std::to_string(m_origin.z) + ")";
 }
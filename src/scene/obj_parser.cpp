@@ -6,6 +6,7 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <unordered_map>
 
 namespace PathRender {
 
@@ -47,6 +48,8 @@ SceneConfig OBJParser::parse_scene(const std::string& filename) {
     
     // Mesh State
     std::shared_ptr<Mesh> current_mesh = nullptr;
+    // Global (file) vertex index -> index in current_mesh's vertex buffer
+    std::unordered_map<uint32_t, uint32_t> local_indices;
     std::string current_name = "default";
     bool is_new_object = true;
     
@@ -65,9 +68,9 @@ SceneConfig OBJParser::parse_scene(const std::string& filename) {
             if (is_new_object) {
                 is_new_object = false;
                 current_mesh = std::make_shared<Mesh>();
+                local_indices.clear();
             }
 
-            current_mesh->add_vertex(parse_point3(line.substr(2)));
             global_vertices.push_back(parse_point3(line.substr(2)));
         }
         else if (starts_with(line, "vn ")) {
@@ -99,17 +102,21 @@ SceneConfig OBJParser::parse_scene(const std::string& filename) {
         else if (starts_with(line, "f ")) {
             is_new_object = true;
             std::stringstream ss(line.substr(2));
-            int idx[3];
+            uint32_t idx[3];
             for (int i = 0; i < 3; ++i) {
-                ss >> idx[i];
+                int global_index;
+                ss >> global_index;
+
+                // Each referenced vertex is stored once in the mesh and shared by its triangles
+                uint32_t key = static_cast<uint32_t>(global_index - 1);
+                auto it = local_indices.find(key);
+                if (it == local_indices.end()) {
+                    it = local_indices.emplace(key, current_mesh->add_vertex(global_vertices.at(key))).first;
+                }
+                idx[i] = it->second;
             }
 
-            Point3 p0 = global_vertices[idx[0] - 1];
-            Point3 p1 = global_vertices[idx[1] - 1];
-            Point3 p2 = global_vertices[idx[2] - 1];
-            
-            Triangle tri(p0, p1, p2, current_mesh->get_material() );
-            current_mesh->add_triangle(tri);
+            current_mesh->add_triangle(idx[0], idx[1], idx[2]);
         }
         else if (starts_with(line, "g ")) {
             is_new_object = true;
@@ -125,6 +132,8 @@ SceneConfig OBJParser::parse_scene(const std::string& filename) {
         }
     }
 
+    scene.finalize();
+
     float aspect_ratio = static_cast<float>(out_params.width) / static_cast<float>(out_params.height);
     Camera camera = Camera(cam_pos, cam_lookat, cam_up, 70.0f, aspect_ratio);
 
@@ -1,9 +1,13 @@
 #include "PathRender/scene/scene.hpp"
+#include "PathRender/utils/thread_pool.hpp"
+#include <chrono>
+#include <iostream>
 
 namespace PathRender {
 
 void Scene::add_object(std::shared_ptr<Object> object) {
     m_objects.push_back(std::move(object));
+    m_finalized = false;
 }
 
 void Scene::add_light(const Light& light) {
@@ -14,16 +18,92 @@ const Light& Scene::get_light(size_t index) const {
     return m_lights.at(index);
 }
 
+void Scene::finalize() {
+    auto start = std::chrono::steady_clock::now();
+
+    // Bottom level first: objects with internal hierarchies (meshes) build their own
+    // BVH, one task per object; large meshes also split their own build across threads
+    {
+        Utils::TaskGroup tasks;
+        for (const auto& obj : m_objects) {
+            tasks.run([&obj] { obj->build_acceleration(); });
+        }
+        tasks.wait();
+    }
+
+    m_unbounded_objects.clear();
+    m_emissive_objects.clear();
+    m_emissive_objects.reserve(m_objects.size());
+    for (const auto& obj : m_objects) {
+        m_emissive_objects.push_back(obj->is_emissive());
+    }
+
+    std::vector<AABB> bounds;
+    std::vector<uint32_t> bounded_objects;
+    for (uint32_t i = 0; i < m_objects.size(); ++i) {
+        AABB box = m_objects[i]->get_bounds();
+        if (box.is_finite()) {
+            bounds.push_back(box);
+            bounded_objects.push_back(i);
+        } else {
+            m_unbounded_objects.push_back(i);
+        }
+    }
+
+    m_bvh.build(bounds);
+
+    // The BVH indexes into 'bounds'; remap leaves to object indices
+    m_bvh_objects.clear();
+    m_bvh_objects.reserve(m_bvh.primitive_indices().size());
+    for (uint32_t index : m_bvh.primitive_indices()) {
+        m_bvh_objects.push_back(bounded_objects[index]);
+    }
+
+    m_finalized = true;
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << "BVH" << PATHRENDER_BVH_WIDTH << " da cena: " << bounded_objects.size() << " objetos, "
+              << m_bvh.node_count() << " nós, " << m_unbounded_objects.size()
+              << " ilimitados, custo SAH " << m_bvh.sah_cost() << " (" << elapsed.count() << " ms, "
+              << Utils::ThreadPool::global().size() << " threads)" << std::endl;
+}
+
+bool Scene::is_finalized() const {
+    return m_finalized;
+}
+
 bool Scene::intersect(const Ray& ray, float t_min, float t_max, HitRecord& hit) const {
-    HitRecord temp_hit;
     bool hit_anything = false;
+    uint32_t hit_object = 0;
     float closest_so_far = t_max;
 
-    for (const auto& obj : m_objects) {
-        if (obj->intersect(ray, t_min, closest_so_far, temp_hit)) {
-            hit_anything = true;
-            closest_so_far = temp_hit.t;
-            hit = temp_hit;
+    // While searching only t, primitive and barycentrics are written to 'hit';
+    // the surface of the closest hit is resolved once at the end
+    auto test_object = [&](uint32_t index, float& t_closest) {
+        if (m_objects[index]->intersect(ray, t_min, t_closest, hit)) {
+            t_closest = hit.t;
+            hit_object = index;
+            return true;
+        }
+        return false;
+    };
+
+    if (m_finalized) {
+        for (uint32_t index : m_unbounded_objects) {
+            hit_anything |= test_object(index, closest_so_far);
+        }
+
+        hit_anything |= m_bvh.traverse(ray, t_min, closest_so_far,
+            [&](uint32_t first, uint32_t count, float& t_closest) {
+                bool hit_leaf = false;
+                for (uint32_t i = first; i < first + count; ++i) {
+                    hit_leaf |= test_object(m_bvh_objects[i], t_closest);
+                }
+                return hit_leaf;
+            });
+    } else {
+        for (uint32_t i = 0; i < m_objects.size(); ++i) {
+            hit_anything |= test_object(i, closest_so_far);
         }
     }
 
@@ -54,11 +134,52 @@ bool Scene::intersect(const Ray& ray, float t_min, float t_max, HitRecord& hit)
     //     }
     // }
 
+    if (hit_anything) {
+        hit.object = m_objects[hit_object].get();
+        hit.object_index = hit_object;
+        hit.object->compute_surface(ray, hit);
+    }
+
     return hit_anything;
 }
 
+bool Scene::occluded(const Ray& ray, float t_min, float t_max) const {
+    if (!m_finalized) {
+        for (const auto& obj : m_objects) {
+            if (!obj->is_emissive() && obj->occluded(ray, t_min, t_max)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto test_object = [&](uint32_t index) {
+        return !m_emissive_objects[index] && m_objects[index]->occluded(ray, t_min, t_max);
+    };
+
+    for (uint32_t index : m_unbounded_objects) {
+        if (test_object(index)) {
+            return true;
+        }
+    }
+
+    return m_bvh.traverse_any(ray, t_min, t_max, [&](uint32_t first, uint32_t count) {
+        for (uint32_t i = first; i < first + count; ++i) {
+            if (test_object(m_bvh_objects[i])) {
+                return true;
+            }
+        }
+        return false;
+    });
+}
+
 void Scene::clear() {
     m_objects.clear();
+    m_bvh.clear();
+    m_bvh_objects.clear();
+    m_unbounded_objects.clear();
+    m_emissive_objects.clear();
+    m_finalized = false;
 }
 
 size_t Scene::object_count() const {
@@ -67,7 +188,9 @@ size_t Scene::object_count() const {
 
 const std::vector<std::shared_ptr<Object>>& Scene::get_objects() const {
     return m_objects;
-}std::string Scene::to_string() const {
+}
+
+std::string Scene::to_string() const {
     std::string result = "Scene with " + std::to_string(m_objects.size()) + " objects:\n";
     for (const auto& obj : m_objects) {
         result += "  - " + obj->to_string() + "\n";
@@ -156,21 +156,16 @@ std::shared_ptr<Mesh> YAMLParser::parse_quad(const YAML::Node& node) {
 
     auto mesh = std::make_shared<Mesh>();
 
-    std::vector<Point3> p;
     for (int i = 0; i < 4; ++i) {
-        Point3 pt = parse_point3(node["points"][i]);
-        p.push_back(pt);
-        mesh->add_vertex(pt); // Add to mesh storage (matches OBJParser logic)
+        mesh->add_vertex(parse_point3(node["points"][i]));
     }
 
     Material material = parse_material(node["material"]);
     mesh->set_material(material); // Set material on the Mesh wrapper
 
-    Triangle t1(p[0], p[1], p[2], material);
-    mesh->add_triangle(t1);
-
-    Triangle t2(p[0], p[2], p[3], material);
-    mesh->add_triangle(t2);
+    // Two triangles sharing the 0-2 diagonal
+    mesh->add_triangle(0, 1, 2);
+    mesh->add_triangle(0, 2, 3);
 
     return mesh;
 }
@@ -200,6 +195,7 @@ Scene YAMLParser::parse_objects(const YAML::Node& objects_node) {
         object_count++;
     }
 
+    scene.finalize();
     return scene;
 }
 
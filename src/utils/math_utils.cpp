@@ -1,4 +1,6 @@
 #include "PathRender/utils/math_utils.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace Utils {
   
@@ -11,4 +13,35 @@ void build_orthonormal_basis(const Vector3& normal, Vector3& tangent, Vector3& b
       tangent = bitangent.cross(normal).normalized();
   }
 
+void concentric_sample_disk(float u1, float u2, float& x, float& y) {
+      const float a = 2.0f * u1 - 1.0f;
+      const float b = 2.0f * u2 - 1.0f;
+      if (a == 0.0f && b == 0.0f) {
+          x = y = 0.0f;
+          return;
+      }
+      // Squares around the center map to circles; the larger coordinate is the radius
+      const float quarter_pi = static_cast<float>(M_PI) / 4.0f;
+      float r, theta;
+      if (std::abs(a) > std::abs(b)) {
+          r = a;
+          theta = quarter_pi * (b / a);
+      } else {
+          r = b;
+          theta = 2.0f * quarter_pi - quarter_pi * (a / b);
+      }
+      x = r * std::cos(theta);
+      y = r * std::sin(theta);
+  }
+
+Vector3 cosine_sample_hemisphere(const Vector3& normal, float u1, float u2) {
+      // Malley's method: uniform point on the disk, projected up onto the hemisphere
+      float x, y;
+      concentric_sample_disk(u1, u2, x, y);
+      const float z = std::sqrt(std::max(0.0f, 1.0f - x * x - y * y));
+      Vector3 tangent, bitangent;
+      build_orthonormal_basis(normal, tangent, bitangent);
+      return (tangent * x + bitangent * y + normal * z).normalized();
+  }
+
 } // namespace Utils
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "PathRender/utils/thread_pool.hpp"
+#include <algorithm>
+
+namespace Utils {
+
+namespace {
+
+// Pool and index of the worker running on this thread, if any
+thread_local const ThreadPool* t_pool = nullptr;
+thread_local size_t t_index = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t thread_count) {
+    start(thread_count);
+}
+
+ThreadPool::~ThreadPool() {
+    stop();
+}
+
+void ThreadPool::set_thread_count(size_t thread_count) {
+    stop();
+    start(thread_count);
+}
+
+void ThreadPool::start(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    m_stopping = false;
+    m_queues.clear();
+    for (size_t i = 0; i < thread_count; ++i) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+    m_workers.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        m_workers.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+}
+
+void ThreadPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    // Workers keep their own subtasks local; outside submissions are spread round-robin
+    const size_t queue = t_pool == this ? t_index : m_next_queue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+    // Counted before the push so m_queued never drops below the number of queued tasks
+    m_queued.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(m_queues[queue]->mutex);
+        m_queues[queue]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+    }
+    m_condition.notify_one();
+}
+
+bool ThreadPool::pop_task(size_t index, std::function<void()>& task) {
+    const size_t count = m_queues.size();
+
+    // Own deque first, newest task (LIFO)
+    if (index < count) {
+        WorkQueue& own = *m_queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Then steal the oldest task of another deque (FIFO), which tends to be the biggest
+    for (size_t k = 1; k <= count; ++k) {
+        WorkQueue& victim = *m_queues[(index + k) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::run_pending_task() {
+    std::function<void()> task;
+    if (!pop_task(current_thread_index(), task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+size_t ThreadPool::current_thread_index() const {
+    return t_pool == this ? t_index : m_workers.size();
+}
+
+void ThreadPool::worker_loop(size_t index) {
+    t_pool = this;
+    t_index = index;
+
+    while (true) {
+        std::function<void()> task;
+        if (pop_task(index, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_condition.wait(lock, [this] { return m_stopping || m_queued.load(std::memory_order_acquire) > 0; });
+        if (m_stopping && m_queued.load(std::memory_order_acquire) == 0) {
+            return;  // Stopping and nothing left to run
+        }
+    }
+}
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+    m_pool.submit([this, task = std::move(task)] {
+        // Counted down however the task ends; the last one wakes the waiters. All under
+        // the mutex: a waiter leaves only after taking it, so the group outlives this
+        struct Done {
+            TaskGroup& group;
+            ~Done() {
+                std::lock_guard<std::mutex> lock(group.m_mutex);
+                if (group.m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    ++group.m_generation;
+                    group.m_changed.notify_all();
+                }
+            }
+        } done{*this};
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_exception) {
+                m_exception = std::current_exception();
+            }
+        }
+    });
+    // A waiter asleep on the group may run the new task itself
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_generation;
+    }
+    m_changed.notify_all();
+}
+
+void TaskGroup::finish() {
+    // Help with queued work first, so waiting inside a task can't starve the pool. With
+    // nothing queued, sleep until the group finishes or gets a task someone must run
+    while (m_pending.load(std::memory_order_acquire) > 0) {
+        size_t seen;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            seen = m_generation;
+        }
+        if (m_pool.run_pending_task()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_changed.wait(lock, [this, seen] {
+            return m_pending.load(std::memory_order_acquire) == 0 || m_generation != seen;
+        });
+    }
+    // The last task may still hold the mutex
+    std::lock_guard<std::mutex> lock(m_mutex);
+}
+
+void TaskGroup::wait() {
+    finish();
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::swap(exception, m_exception);
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body, ThreadPool& pool) {
+    grain = std::max<size_t>(grain, 1);
+    if (count <= grain) {
+        body(0, count);
+        return;
+    }
+
+    // A few blocks per thread so uneven blocks still balance
+    const size_t blocks = std::min((count + grain - 1) / grain, 4 * pool.size());
+    const size_t block_size = (count + blocks - 1) / blocks;
+    TaskGroup group(pool);
+    for (size_t begin = block_size; begin < count; begin += block_size) {
+        const size_t end = std::min(begin + block_size, count);
+        group.run([&body, begin, end] { body(begin, end); });
+    }
+    body(0, std::min(block_size, count));
+    group.wait();
+}
+
+} // namespace Utils